@@ -0,0 +1,63 @@
+// -- comparison of the track to TP association products of two producers on the same events
+// -- e.g. MuonHLTTrackAssociationProducer (one module, shared hit associators) against the per-collection
+// -- MuonAssociatorEDProducer clones it replaces: with the same parameters both have to give the same association
+// -- per track collection: RecoToSim (TPs and qualities of each track) and SimToReco (tracks and qualities of each TP)
+// -- the time of each producer is not measured here: FastTimerService by module label (compareSharedTrackAssociation sets it up)
+// -- output: counts printed in endJob and a summary tree (TFileService), one entry per collection
+
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+#include "SimDataFormats/Associations/interface/TrackToTrackingParticleAssociator.h"
+#include "SimDataFormats/TrackingAnalysis/interface/TrackingParticle.h"
+#include "SimDataFormats/TrackingAnalysis/interface/TrackingParticleFwd.h"
+
+#include "TTree.h"
+
+#include <string>
+#include <vector>
+
+class MuonHLTAssociationComparison : public edm::one::EDAnalyzer<edm::one::SharedResources>
+{
+public:
+  explicit MuonHLTAssociationComparison(const edm::ParameterSet &iConfig);
+  virtual ~MuonHLTAssociationComparison() {};
+
+  virtual void analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup);
+  virtual void endJob();
+
+private:
+  // -- per collection: the test association compared to the reference
+  class agreement {
+  public:
+    unsigned long nEvent = 0;      // -- events with both products
+    unsigned long nMissing = 0;    // -- events with only one of the two products
+    unsigned long nTrack = 0;
+    unsigned long nTrackSame = 0;  // -- same TPs with the same qualities, in the same order
+    unsigned long nTrackDiffTP = 0;
+    unsigned long nTrackDiffQuality = 0; // -- same TPs, a quality differs by more than qualityTolerance
+    unsigned long nTP = 0;         // -- TPs associated to a track, in the reference or in the test
+    unsigned long nTPSame = 0;
+    double maxQualityDiff = 0.;
+  };
+
+  std::vector<std::string> trackCollectionNames_;
+  std::vector<edm::EDGetTokenT<edm::View<reco::Track>>> trackCollectionTokens_;
+  std::vector<edm::EDGetTokenT<reco::RecoToSimCollection>> refRecoToSimTokens_;
+  std::vector<edm::EDGetTokenT<reco::SimToRecoCollection>> refSimToRecoTokens_;
+  std::vector<edm::EDGetTokenT<reco::RecoToSimCollection>> testRecoToSimTokens_;
+  std::vector<edm::EDGetTokenT<reco::SimToRecoCollection>> testSimToRecoTokens_;
+  double qualityTolerance_;
+
+  std::vector<agreement> agreements_; // -- [collection]
+  unsigned long nEvent_;
+};
@@ -0,0 +1,71 @@
+// -- comparison of track to TP associators (e.g. trackAssociatorByHits vs quickTrackAssociatorByHits) on the same events
+// -- every associator associates every track collection in this module: the time per event is measured in the same conditions
+// -- the timed region is associateRecoToSim only: the per-event setup of a backend runs in its own modules before this one
+// -- (cluster to TP map, sim hit to TP map), time those by module label with the FastTimerService (compareAssociators sets it up)
+// -- output (TFileService): per-event timing tree, per-collection quality difference histograms and a summary tree (also printed in endJob)
+// -- the first associator is the reference
+
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+#include "SimDataFormats/Associations/interface/TrackToTrackingParticleAssociator.h"
+#include "SimDataFormats/TrackingAnalysis/interface/TrackingParticle.h"
+#include "SimDataFormats/TrackingAnalysis/interface/TrackingParticleFwd.h"
+
+#include "TTree.h"
+#include "TH1D.h"
+
+#include <string>
+#include <vector>
+
+class MuonHLTAssociatorComparison : public edm::one::EDAnalyzer<edm::one::SharedResources>
+{
+public:
+  explicit MuonHLTAssociatorComparison(const edm::ParameterSet &iConfig);
+  virtual ~MuonHLTAssociatorComparison() {};
+
+  virtual void analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup);
+  virtual void beginJob();
+  virtual void endJob();
+
+private:
+  // -- per (collection, associator): best matched TP of each track compared to the reference associator
+  class agreement {
+  public:
+    unsigned long nTrack = 0;
+    unsigned long nMatched = 0;    // -- tracks with a TP
+    unsigned long nSameTP = 0;     // -- same best TP as the reference
+    unsigned long nDiffTP = 0;     // -- both matched, different best TP
+    unsigned long nOnlyThis = 0;   // -- matched here, not by the reference
+    unsigned long nOnlyRef = 0;    // -- matched by the reference, not here
+    double sumQualityDiff = 0.;    // -- quality - reference quality, same best TP
+    double sumAbsQualityDiff = 0.;
+    double time = 0.;              // -- seconds, summed over events
+    TH1D* h_qualityDiff = nullptr;
+  };
+
+  std::vector<std::string> associatorNames_;
+  std::vector<edm::EDGetTokenT<reco::TrackToTrackingParticleAssociator>> associatorTokens_;
+
+  std::vector<std::string> trackCollectionNames_;
+  std::vector<edm::EDGetTokenT<edm::View<reco::Track>>> trackCollectionTokens_;
+
+  edm::EDGetTokenT<TrackingParticleCollection> trackingParticleToken_;
+
+  std::vector<std::vector<agreement>> agreements_; // -- [collection][associator]
+  unsigned long nEvent_;
+
+  TTree* NTTiming_;
+  std::vector<float> time_;   // -- ms, [collection*nAssociator + associator]
+  std::vector<int> nTrack_;   // -- [collection]
+  unsigned long long eventNum_;
+};
@@ -10,6 +10,7 @@
 #include "FWCore/Framework/interface/ConsumesCollector.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
 
 #include "DataFormats/BeamSpot/interface/BeamSpot.h"
 #include "DataFormats/Common/interface/Handle.h"
@@ -18,6 +19,7 @@
 #include "DataFormats/Common/interface/TriggerResults.h"
 #include "DataFormats/HLTReco/interface/TriggerEvent.h"
 #include "DataFormats/HLTReco/interface/TriggerObject.h"
+#include "DataFormats/HLTReco/interface/TriggerTypeDefs.h"
 #include "DataFormats/L1Trigger/interface/Muon.h"
 #include "DataFormats/Luminosity/interface/LumiDetails.h"
 #include "DataFormats/Math/interface/deltaR.h"
@@ -25,6 +27,7 @@
 #include "DataFormats/MuonReco/interface/MuonSelectors.h"
 #include "DataFormats/MuonReco/interface/MuonTrackLinks.h"
 #include "DataFormats/PatCandidates/interface/Muon.h"
+#include "DataFormats/PatCandidates/interface/TriggerObjectStandAlone.h"
 #include "DataFormats/RecoCandidate/interface/IsoDeposit.h"
 #include "DataFormats/RecoCandidate/interface/IsoDepositFwd.h"
 #include "DataFormats/RecoCandidate/interface/RecoChargedCandidate.h"
@@ -52,6 +55,9 @@
 #include "DataFormats/TrajectorySeed/interface/TrajectorySeedCollection.h"
 #include "DataFormats/TrajectorySeed/interface/PropagationDirection.h"
 #include "DataFormats/TrajectoryState/interface/PTrajectoryStateOnDet.h"
+#include "MuonHLTTool/MuonHLTNtupler/interface/MuonHLTSeedTrackIndex.h"
+#include "MuonHLTTool/MuonHLTNtupler/interface/MuonSelectorBits.h"
+#include "MuonHLTTool/MuonHLTNtupler/interface/MuonHLTSeedNtupler.h"
 #include "DataFormats/TrajectoryState/interface/LocalTrajectoryParameters.h"
 #include "DataFormats/TrackingRecHit/interface/TrackingRecHit.h"
 #include "DataFormats/HeavyIonEvent/interface/Centrality.h"
@@ -94,12 +100,22 @@
 
 #include "RecoMuon/TrackerSeedGenerator/interface/SeedMvaEstimator.h"
 #include "MuonAnalysis/MuonAssociators/interface/PropagateToMuonSetup.h"
+#include "TrackingTools/Records/interface/TrackingComponentsRecord.h"
+#include "RecoMuon/Records/interface/MuonRecoGeometryRecord.h"
 
 // #include "MuonHLTTool/MuonHLTNtupler/interface/MuonHLTobjCorrelator.h"
 
 #include "TTree.h"
+#include "TH1D.h"
 #include "TString.h"
 
+#include <unordered_map>
+#include <cstring>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <set>
+
 using namespace std;
 using namespace reco;
 using namespace edm;
@@ -121,7 +137,10 @@ private:
   void Init();
   void Make_Branch();
   // void Fill_L1Track(const edm::Event &iEvent, const edm::EventSetup &iSetup);
+  void Fill_Event(const edm::Event &iEvent);
   void Fill_HLT(const edm::Event &iEvent, bool isMYHLT);
+  void Fill_FiredTrigger(const edm::Event &iEvent, const edm::TriggerResults &triggerResults, bool isMYHLT);
+  void Fill_HLTMiniAOD(const edm::Event &iEvent);
   void Fill_Muon(const edm::Event &iEvent, const edm::EventSetup &iSetup);
   void Fill_HLTMuon(const edm::Event &iEvent);
   void Fill_L1Muon(const edm::Event &iEvent);
@@ -129,23 +148,191 @@ private:
 
   //For Rerun (Fill_IterL3*)
   void Fill_IterL3(const edm::Event &iEvent, const edm::EventSetup &iSetup);
+  void Fill_TrackTemplates(const edm::Event &iEvent);
   void Fill_Seed(const edm::Event &iEvent, const edm::EventSetup &iSetup);
 
+  void Update_ESCache(const edm::EventSetup &iSetup);
+
+  void add_muonMatch(const edm::ParameterSet &matchConf);
+  void Fill_MuonMatch();
+
   bool SavedTriggerCondition( std::string& pathName );
   bool SavedFilterCondition( std::string& filterName );
 
   bool isNewHighPtMuon(const reco::Muon& muon, const reco::Vertex& vtx);
+  unsigned int MuonSelectorBits(int i_muon);
 
   bool doMVA;
   bool doHI;
   bool doSeed;
   bool DebugMode;
+
+  // -- seedNtuple (MuonHLTSeedNtupler parameters, set by the seed customizer with mergeWithNtupler): the seed ntuple is filled
+  // -- by this module, for every event (no sampling), trees in ntupler/seedNtupler; null: no seed ntuple
+  std::unique_ptr<MuonHLTSeedNtupleMaker> seedNtuple_;
   // bool SaveAllTracks;   // store in ntuples not only truth-matched tracks but ALL tracks
   // bool SaveStubs;       // option to save also stubs in the ntuples (makes them large...)
 
+  // -- friend tree (friendBranchGroups): only the requested branch groups are written, next to the event key
+  // -- groups: event, HLT, MYHLT, variants, muon, muonMatch, HLTMuon, L1Muon, iterL3, tracks, gen, TP
+  // -- a group is filled if it is written or if a written group is computed from it (e.g. tracks <- iterL3)
+  std::set<std::string> branchGroups_; // -- empty: full ntuple
+  std::set<std::string> fillGroups_;
+  // -- fillAllGroups_: full ntuple; writeNtuple = False fills only the groups of the efficiency histograms
+  bool fillAllGroups_;
+  bool writeGroup(const std::string &group) const { return branchGroups_.empty() || branchGroups_.count(group); }
+  bool fillGroup(const std::string &group) const  { return fillAllGroups_ || fillGroups_.count(group); }
+
+  // -- friendReference: ntuple the friend tree is made for, every written event is looked up there by (run, lumi, event)
+  // -- the entry order is not checked: attach the friend with TTree::BuildIndex("runNum", "eventNum") (or lumiBlockNum), not by entry
+  class friendKey {
+  public:
+    int run;
+    int lumi;
+    unsigned long long event;
+
+    bool operator<(const friendKey& other) const {
+      return std::tie(run, lumi, event) < std::tie(other.run, other.lumi, other.event);
+    }
+  };
+  std::string friendReference_;
+  std::string friendReferenceTree_;
+  bool friendCheck_;
+  std::set<friendKey> friendKeys_; // -- reference events not written yet
+  unsigned long nFriendReference_;
+  unsigned long nFilled_;
+  void Load_FriendKeys();
+  void Check_FriendKey();
+
+  // -- sampleFraction: only events passing a hash of (run, lumi, event, sampleSeed) are filled and written
+  // -- the decision depends on the event id only: same events for any job splitting, re-run or site
+  double sampleFraction_;
+  unsigned int sampleSeed_;
+  unsigned long nEventProcessed_;
+  unsigned long nEventSampled_;
+  bool SampleEvent(unsigned int run, unsigned int lumi, unsigned long long event) const;
+
+  // -- eventBudget: per-event multiplicity and time limits of the expensive sections (0: no limit)
+  // -- above a limit the loop is truncated or the section skipped, and the event is flagged in budgetOverflow
+  enum budgetBit {
+    kBudgetTracks     = 0, // -- a track collection truncated to maxTracks in the track templates
+    kBudgetTPs        = 1, // -- a TP loop truncated to the first maxTPs tracking particles
+    kBudgetTimeIterL3 = 2, // -- maxEventTime exceeded before Fill_IterL3: skipped
+    kBudgetTimeTracks = 3, // -- maxEventTime exceeded before a track collection: it and the next ones skipped
+    kBudgetTimeTP     = 4, // -- maxEventTime exceeded before Fill_TP: skipped
+    nBudgetBit        = 5
+  };
+  unsigned int maxTracks_;
+  unsigned int maxTPs_;
+  double maxEventTime_; // -- ms, wall clock since the start of analyze
+  std::chrono::steady_clock::time_point eventStart_;
+  unsigned int budgetOverflow_;
+  unsigned long nBudgetOverflow_[nBudgetBit]; // -- events with each bit set
+  unsigned int budgetLimit(size_t n, unsigned int limit, budgetBit bit);
+  bool budgetTimeExceeded(budgetBit bit);
+
+  // -- doLumiSummary: per lumi section quantities in the "lumi" tree, one entry per lumi section
+  // -- accumulated per (run, lumi) in analyze and written in endJob: no lumi transitions watched, lumi sections can run concurrently
+  // -- averages and counts over the sampled events, from the values filled in the ntuple (-999: not filled, not counted);
+  // -- friend tree: the inputs of the groups not written are read by Fill_LumiSummaryInputs, without filling those groups
+  class lumiSummary {
+  public:
+    int run;
+    int lumi;
+    unsigned long nEvent;        // -- processed
+    unsigned long nEventSampled; // -- filled in the ntuple
+
+    unsigned long nTruePU;
+    double sumTruePU;
+    unsigned long nInstLumi;
+    double sumInstLumi;
+    unsigned long nVertexEvent;
+    double sumVertex;
+
+    unsigned long nL1Muon;       // -- BX 0, any quality
+    unsigned long nEventL1Muon1; // -- >= 1 L1 muon
+    unsigned long nEventL1Muon2; // -- >= 2 L1 muons
+
+    std::map<std::string, unsigned long> triggerCount;   // -- HLT paths passing SavedTriggerCondition
+    std::map<std::string, unsigned long> myTriggerCount; // -- rerun (MYHLT) paths
+
+    void clear(int run_, int lumi_) {
+      run = run_;
+      lumi = lumi_;
+      nEvent = 0;
+      nEventSampled = 0;
+      nTruePU = 0;
+      sumTruePU = 0.;
+      nInstLumi = 0;
+      sumInstLumi = 0.;
+      nVertexEvent = 0;
+      sumVertex = 0.;
+      nL1Muon = 0;
+      nEventL1Muon1 = 0;
+      nEventL1Muon2 = 0;
+      triggerCount.clear();
+      myTriggerCount.clear();
+    }
+  };
+  bool doLumiSummary_;
+  std::map<std::pair<int,int>, lumiSummary> lumiSummaries_; // -- (run, lumi) ->
+  lumiSummary* lumiSummary_; // -- of the current event
+  TTree *lumiTree_;
+  void Make_LumiBranch();
+  void Fill_LumiSummaryInputs(const edm::Event &iEvent);
+  void Fill_LumiSummary();
+  void Write_LumiSummary();
+
+  // -- lumi tree buffers
+  int lumi_run_;
+  int lumi_lumi_;
+  double lumi_meanTruePU_;
+  double lumi_meanInstLumi_;
+  double lumi_meanNVertex_;
+  unsigned long long lumi_nEvent_;
+  unsigned long long lumi_nEventSampled_;
+  unsigned long long lumi_nL1Muon_;
+  unsigned long long lumi_nEventL1Muon1_;
+  unsigned long long lumi_nEventL1Muon2_;
+  std::vector<std::string> lumi_trigger_;
+  std::vector<unsigned int> lumi_triggerCount_;
+  std::vector<std::string> lumi_myTrigger_;
+  std::vector<unsigned int> lumi_myTriggerCount_;
+
+  // -- miniAOD: offline muons (pat::Muon) and HLT objects (pat::TriggerObjectStandAlone, triggerObjects) read from MiniAOD, no HLT rerun
+  // -- only the groups available in MiniAOD are filled: event, HLT, muon, muonMatch, L1Muon, gen (default: all of them)
+  // -- HLT objects go to the same vec_filterName, vec_HLTObj_* branches as from hltTriggerSummaryAOD, one entry per (filter, object)
+  // -- only muon objects (TriggerMuon, TriggerL1Mu) are unpacked and saved: non-muon objects of the saved filters are not
+  // -- the path and filter selection (SavedTriggerCondition, SavedFilterCondition) is made once per menu, not per object
+  class miniAODMenu {
+  public:
+    edm::ParameterSetID psetID; // -- of the TriggerResults the selection was made for
+    std::vector<bool> pathSaved; // -- by trigger index
+    std::unordered_map<std::string, std::string> filterName; // -- filter label -> encoded InputTag, empty: not saved
+  };
+  bool miniAOD_;
+  std::string miniAODProcess_; // -- of triggerResults, for the filter names
+  edm::EDGetTokenT< std::vector<pat::TriggerObjectStandAlone> > t_triggerObject_;
+  miniAODMenu miniAODMenu_;
+
   const PropagateToMuonSetup propSetup_;
   const edm::ESGetToken<TrackerGeometry, TrackerDigiGeometryRecord> trackerGeometryToken_;
 
+  // -- EventSetup-derived objects: rebuilt only when the IOV of one of their records changes, not in every event
+  std::optional<PropagateToMuon> prop_;
+  const TrackerGeometry* tracker_;
+  edm::ESWatcher<IdealMagneticFieldRecord>  magneticFieldWatcher_;
+  edm::ESWatcher<TrackingComponentsRecord>  propagatorWatcher_;
+  edm::ESWatcher<MuonRecoGeometryRecord>    muonGeometryWatcher_;
+  edm::ESWatcher<TrackerDigiGeometryRecord> trackerGeometryWatcher_;
+
+  // -- benchmarkESCache: also time the former per-event rebuild, per-event savings printed in endJob
+  bool benchmarkESCache_;
+  unsigned long nESCacheEvent_;
+  unsigned long nESCacheRebuild_;
+  double timeESCached_;  // -- seconds, summed over events
+  double timeESRebuild_;
+
   // edm::EDGetTokenT< std::vector< TTTrack< Ref_Phase2TrackerDigi_ > > > ttTrackToken_;
   // edm::EDGetTokenT< TTTrackAssociationMap< Ref_Phase2TrackerDigi_ > > ttTrackMCTruthToken_;
   // edm::EDGetTokenT< edmNew::DetSetVector< TTStub< Ref_Phase2TrackerDigi_ > > > ttStubToken_;
@@ -159,7 +346,7 @@ private:
 
 
   edm::EDGetTokenT< reco::BeamSpot >                         t_beamSpot_;
-  edm::EDGetTokenT< std::vector<reco::Muon> >                t_offlineMuon_;
+  edm::EDGetTokenT< edm::View<reco::Muon> >                 t_offlineMuon_; // -- reco::Muon (AOD) or pat::Muon (miniAOD)
   edm::EDGetTokenT< reco::VertexCollection >                 t_offlineVertex_;
   edm::EDGetTokenT< edm::TriggerResults >                    t_triggerResults_;
   edm::EDGetTokenT< trigger::TriggerEvent >                  t_triggerEvent_;
@@ -330,58 +517,95 @@ private:
   vector< double > vec_myHLTObj_eta_;
   vector< double > vec_myHLTObj_phi_;
 
+  // -- HLT menu variants rerun in the same job (menuVariants): paths and filters cloned with a label suffix
+  // -- paths and filters of each variant are stored without the suffix, next to the nominal vec_my* ones
+  class menuVariant {
+  public:
+    std::string name;
+    std::string suffix;
+    edm::EDGetTokenT<edm::TriggerResults>       triggerResultsToken;
+    edm::EDGetTokenT<trigger::TriggerEvent>     triggerEventToken;
+    edm::EDGetTokenT<std::vector<reco::Muon> >  iterL3MuonToken;
+    bool hasIterL3Muon;
+
+    vector< std::string > firedTrigger;
+    vector< std::string > filterName;
+    vector< double > HLTObj_pt;
+    vector< double > HLTObj_eta;
+    vector< double > HLTObj_phi;
+    vector< double > iterL3Muon_pt;
+    vector< double > iterL3Muon_eta;
+    vector< double > iterL3Muon_phi;
+
+    void clear() {
+      firedTrigger.clear();
+      filterName.clear();
+      HLTObj_pt.clear();
+      HLTObj_eta.clear();
+      HLTObj_phi.clear();
+      iterL3Muon_pt.clear();
+      iterL3Muon_eta.clear();
+      iterL3Muon_phi.clear();
+    }
+  };
+  vector<menuVariant> menuVariants_;
+  void Fill_MenuVariant(const edm::Event &iEvent, menuVariant &V);
+
   // std::map<MuonHLTobjCorrelator::L1TTTrack,unsigned int> mTTTrackMap;
 
-  class tmpTSOD {
-  private:
-    uint32_t TSODDetId;
-    float TSODPt;
-    float TSODX;
-    float TSODY;
-    float TSODDxdz;
-    float TSODDydz;
-    float TSODPx;
-    float TSODPy;
-    float TSODPz;
-    float TSODqbp;
-    int TSODCharge;
+  typedef MuonHLT::seedTrackIndex seedTrackIndex;
+
+  // -- best match of each offline muon in one online collection, from the values already filled in the event (doMuonMatch)
+  // -- branches: muon_<name>_idx (index in the online collection, or in vec_(my)HLTObj_* for HLT objects; -1: nothing in the cone)
+  // --           muon_<name>_dR
+  class muonMatch {
   public:
-    void SetTmpTSOD(const PTrajectoryStateOnDet TSODIn) {
-      TSODDetId = TSODIn.detId();
-      TSODPt = TSODIn.pt();
-      TSODX = TSODIn.parameters().position().x();
-      TSODY = TSODIn.parameters().position().y();
-      TSODDxdz = TSODIn.parameters().dxdz();
-      TSODDydz = TSODIn.parameters().dydz();
-      TSODPx = TSODIn.parameters().momentum().x();
-      TSODPy = TSODIn.parameters().momentum().y();
-      TSODPz = TSODIn.parameters().momentum().z();
-      TSODqbp = TSODIn.parameters().qbp();
-      TSODCharge = TSODIn.parameters().charge();
-    }
+    std::string name;
+    double dR;
+    double minPt;
+
+    // -- source: flat arrays of the ntuple (n, pt, eta, phi), or the (MY)HLT object vectors restricted to one filter
+    const int*    n   = nullptr;
+    const double* pt  = nullptr;
+    const double* eta = nullptr;
+    const double* phi = nullptr;
+    const vector<std::string>* filterNames = nullptr;
+    const vector<double>* vecPt  = nullptr;
+    const vector<double>* vecEta = nullptr;
+    const vector<double>* vecPhi = nullptr;
+    std::string filter;
+    std::string group; // -- branch group filling the source
+
+    int    idx[arrSize_];     // -- -1: no online object in the cone
+    double matchDR[arrSize_]; // -- -99999: no online object in the cone
+  };
 
-    tmpTSOD(const PTrajectoryStateOnDet TSODIn) { SetTmpTSOD(TSODIn); }
-
-    bool operator==(const tmpTSOD& other) const {
-      return (
-        this->TSODDetId == other.TSODDetId &&
-        this->TSODPt == other.TSODPt &&
-        this->TSODX == other.TSODX &&
-        this->TSODY == other.TSODX &&
-        this->TSODDxdz == other.TSODDxdz &&
-        this->TSODDydz == other.TSODDydz &&
-        this->TSODPx == other.TSODPx &&
-        this->TSODPy == other.TSODPy &&
-        this->TSODPz == other.TSODPz &&
-        this->TSODqbp == other.TSODqbp &&
-        this->TSODCharge == other.TSODCharge
-      );
-    }
+  bool doMuonMatch_;
+  vector<muonMatch> muonMatches_;
 
-    bool operator<(const tmpTSOD& other) const {
-      return (this->TSODPt!=other.TSODPt) ? (this->TSODPt < other.TSODPt) : (this->TSODDetId < other.TSODDetId);
-    }
+  // -- efficiency histograms (efficiencyHist), filled in the job from the muon matches:
+  // -- denominator: offline muons passing the selection, numerator: the ones with a match in muonMatch
+  // -- writeNtuple = False: histograms (and the lumi / metadata trees) only, no per-event entry
+  class efficiencyHist {
+  public:
+    std::string name;
+    int match;              // -- index in muonMatches_
+    unsigned int selection; // -- muonSelectorBit mask required for the offline muon
+    double minPt;           // -- offline muon pT, for the eta, phi and nVertex histograms
+    double maxAbsEta;
+
+    TH1D* h_den[4];         // -- pt, eta, phi, nVertex
+    TH1D* h_num[4];
+    TH1D* h_ptRes;          // -- (online pT - offline pT) / offline pT of the matched muons
+    TH1D* h_dR;
   };
+  bool writeNtuple_;
+  bool doEfficiencyHist_;
+  vector<efficiencyHist> efficiencyHists_;
+  std::vector<double> efficiencyBins_[4];
+  void add_efficiencyHist(const edm::ParameterSet &histConf);
+  void Make_EfficiencyHist();
+  void Fill_EfficiencyHist(const edm::Event &iEvent);
 
   // -- offline muon
   int nMuon_;
@@ -405,6 +629,12 @@ private:
   int muon_isHighPtNew_[arrSize_];
   int muon_isSoft_[arrSize_];
 
+  // -- packed selection word (doMuonSelectorBits), muon_selectorBits[nMuon]/i: layout in MuonSelectorBits.h
+  // -- the separate muon_is* branches are still written
+  typedef MuonHLT::MuonSelectorBit muonSelectorBit;
+  bool doMuonSelectorBits_;
+  unsigned int muon_selectorBits_[arrSize_];
+
   double muon_iso03_sumPt_[arrSize_];
   double muon_iso03_hadEt_[arrSize_];
   double muon_iso03_emEt_[arrSize_];
@@ -497,15 +727,15 @@ private:
   vector<vector<double>> muon_l1tq_;
   vector<vector<double>> muon_l1tdr_;
 
-  std::map<tmpTSOD,unsigned int> MuonIterSeedMap;
-  std::map<tmpTSOD,unsigned int> MuonIterNoIdSeedMap;
-  std::map<tmpTSOD,unsigned int> hltIterL3OIMuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter0IterL3MuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter2IterL3MuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter3IterL3MuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter0IterL3FromL1MuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter2IterL3FromL1MuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter3IterL3FromL1MuonTrackMap;
+  seedTrackIndex MuonIterSeedMap;
+  seedTrackIndex MuonIterNoIdSeedMap;
+  seedTrackIndex hltIterL3OIMuonTrackMap;
+  seedTrackIndex hltIter0IterL3MuonTrackMap;
+  seedTrackIndex hltIter2IterL3MuonTrackMap;
+  seedTrackIndex hltIter3IterL3MuonTrackMap;
+  seedTrackIndex hltIter0IterL3FromL1MuonTrackMap;
+  seedTrackIndex hltIter2IterL3FromL1MuonTrackMap;
+  seedTrackIndex hltIter3IterL3FromL1MuonTrackMap;
 
   // -- L3 muon
   int nL3Muon_;
@@ -1345,6 +1575,7 @@ private:
 
   pairSeedMvaEstimator mvaHltIter2IterL3MuonPixelSeeds_;
   pairSeedMvaEstimator mvaHltIter2IterL3FromL1MuonPixelSeeds_;
+  std::vector<const pairSeedMvaEstimator*> trackCollectionMva_;  // -- per track collection, nullptr: no seed MVA
 
   vector<double> getSeedMva(
     const pairSeedMvaEstimator& pairMvaEstimator,
@@ -1,5 +1,10 @@
 // -- ntuple maker for Muon HLT study
 // -- author: Kyeongpil Lee (Seoul National University, kplee@cern.ch)
+// -- MuonHLTSeedNtupleMaker: the seed ntuple itself (NTEvent and the per-iteration seed trees), consumes through a ConsumesCollector,
+// -- trees in a given TFileDirectory; run by the MuonHLTSeedNtupler module below, or by MuonHLTNtupler (seedNtuple PSet) in the same module
+
+#ifndef MuonHLTTool_MuonHLTNtupler_MuonHLTSeedNtupler_h
+#define MuonHLTTool_MuonHLTNtupler_MuonHLTSeedNtupler_h
 
 #include "FWCore/Framework/interface/one/EDAnalyzer.h"
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -10,7 +15,11 @@
 #include "FWCore/Framework/interface/ConsumesCollector.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
 #include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "CommonTools/UtilAlgos/interface/TFileDirectory.h"
 
 #include "DataFormats/Common/interface/Handle.h"
 #include "DataFormats/Common/interface/View.h"
@@ -52,6 +61,7 @@
 #include "DataFormats/TrajectorySeed/interface/TrajectorySeedCollection.h"
 #include "DataFormats/TrajectorySeed/interface/PropagationDirection.h"
 #include "DataFormats/TrajectoryState/interface/PTrajectoryStateOnDet.h"
+#include "MuonHLTTool/MuonHLTNtupler/interface/MuonHLTSeedTrackIndex.h"
 #include "DataFormats/TrajectoryState/interface/LocalTrajectoryParameters.h"
 #include "DataFormats/TrackingRecHit/interface/TrackingRecHit.h"
 
@@ -96,22 +106,24 @@
 #include "TTree.h"
 #include "TString.h"
 
+#include <unordered_map>
+#include <fstream>
+#include <memory>
+#include <cstring>
+
 using namespace std;
 using namespace reco;
 using namespace edm;
 
-class MuonHLTSeedNtupler : public edm::one::EDAnalyzer<>
+class MuonHLTSeedNtupleMaker
 {
 public:
-  explicit MuonHLTSeedNtupler(const edm::ParameterSet &iConfig);
-  virtual ~MuonHLTSeedNtupler() {};
-
-  virtual void analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup);
-  virtual void beginJob();
-  virtual void endJob();
+  MuonHLTSeedNtupleMaker(const edm::ParameterSet &iConfig, edm::ConsumesCollector &&iC);
+  ~MuonHLTSeedNtupleMaker() {};
 
-  // virtual void beginRun(const edm::Run &iRun, const edm::EventSetup &iSetup);
-  // virtual void endRun(const edm::Run &iRun, const edm::EventSetup &iSetup);
+  void analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup);
+  void beginJob(TFileDirectory &dir);
+  void endJob();
 
 private:
   void Init();
@@ -122,6 +134,8 @@ private:
   void Fill_Seed(const edm::Event &iEvent, const edm::EventSetup &iSetup);
 
   const edm::ESGetToken<TrackerGeometry, TrackerDigiGeometryRecord> trackerGeometryToken_;
+  edm::ESWatcher<TrackerDigiGeometryRecord> trackerGeometryWatcher_;
+  const TrackerGeometry* tracker_; // -- only fetched again when the IOV changes
 
   // TrackerHitAssociator::Config trackerHitAssociatorConfig_;
   edm::EDGetTokenT<reco::TrackToTrackingParticleAssociator> associatorToken;
@@ -150,6 +164,15 @@ private:
   edm::EDGetTokenT< edm::View<reco::Track> >               t_hltIter2IterL3FromL1MuonTrack_;
   edm::EDGetTokenT< edm::View<reco::Track> >               t_hltIter3IterL3FromL1MuonTrack_;
 
+  // -- track to TP associations produced upstream; uninitialized: the association is computed in the module
+  edm::EDGetTokenT< reco::RecoToSimCollection >            t_hltIterL3OIMuonTrackAsso_;
+  edm::EDGetTokenT< reco::RecoToSimCollection >            t_hltIter0IterL3MuonTrackAsso_;
+  edm::EDGetTokenT< reco::RecoToSimCollection >            t_hltIter2IterL3MuonTrackAsso_;
+  edm::EDGetTokenT< reco::RecoToSimCollection >            t_hltIter3IterL3MuonTrackAsso_;
+  edm::EDGetTokenT< reco::RecoToSimCollection >            t_hltIter0IterL3FromL1MuonTrackAsso_;
+  edm::EDGetTokenT< reco::RecoToSimCollection >            t_hltIter2IterL3FromL1MuonTrackAsso_;
+  edm::EDGetTokenT< reco::RecoToSimCollection >            t_hltIter3IterL3FromL1MuonTrackAsso_;
+
   edm::EDGetTokenT< reco::GenParticleCollection >            t_genParticle_;
 
   edm::FileInPath mvaFileHltIter2IterL3MuonPixelSeeds_B_;
@@ -172,6 +195,12 @@ private:
   pairSeedMvaEstimator mvaHltIter2IterL3MuonPixelSeeds_;
   pairSeedMvaEstimator mvaHltIter2IterL3FromL1MuonPixelSeeds_;
 
+  bool doColumnar_;
+  bool doBinaryExport_;
+  std::string binaryExportPrefix_;
+  edm::ParameterSet unmatchedSeedKeepFraction_;
+  unsigned int maxSeeds_; // -- per collection and event, 0: no limit
+
   TTree *NTEvent_;
   TTree *NThltIterL3OI_;
   TTree *NThltIter0_;
@@ -194,57 +223,9 @@ private:
   int nhltIter0FromL1_;
   int nhltIter2FromL1_;
   int nhltIter3FromL1_;
+  unsigned int seedBudgetOverflow_; // -- bit i: collection i of seedCollections_ truncated to maxSeeds
 
-  class tmpTSOD {
-  private:
-    uint32_t TSODDetId;
-    float TSODPt;
-    float TSODX;
-    float TSODY;
-    float TSODDxdz;
-    float TSODDydz;
-    float TSODPx;
-    float TSODPy;
-    float TSODPz;
-    float TSODqbp;
-    int TSODCharge;
-  public:
-    void SetTmpTSOD(const PTrajectoryStateOnDet TSODIn) {
-      TSODDetId = TSODIn.detId();
-      TSODPt = TSODIn.pt();
-      TSODX = TSODIn.parameters().position().x();
-      TSODY = TSODIn.parameters().position().y();
-      TSODDxdz = TSODIn.parameters().dxdz();
-      TSODDydz = TSODIn.parameters().dydz();
-      TSODPx = TSODIn.parameters().momentum().x();
-      TSODPy = TSODIn.parameters().momentum().y();
-      TSODPz = TSODIn.parameters().momentum().z();
-      TSODqbp = TSODIn.parameters().qbp();
-      TSODCharge = TSODIn.parameters().charge();
-    }
-
-    tmpTSOD(const PTrajectoryStateOnDet TSODIn) { SetTmpTSOD(TSODIn); }
-
-    bool operator==(const tmpTSOD& other) const {
-      return (
-        this->TSODDetId == other.TSODDetId &&
-        this->TSODPt == other.TSODPt &&
-        this->TSODX == other.TSODX &&
-        this->TSODY == other.TSODX &&
-        this->TSODDxdz == other.TSODDxdz &&
-        this->TSODDydz == other.TSODDydz &&
-        this->TSODPx == other.TSODPx &&
-        this->TSODPy == other.TSODPy &&
-        this->TSODPz == other.TSODPz &&
-        this->TSODqbp == other.TSODqbp &&
-        this->TSODCharge == other.TSODCharge
-      );
-    }
-
-    bool operator<(const tmpTSOD& other) const {
-      return (this->TSODPt!=other.TSODPt) ? (this->TSODPt < other.TSODPt) : (this->TSODDetId < other.TSODDetId);
-    }
-  };
+  typedef MuonHLT::seedTrackIndex seedTrackIndex;
 
   class trkTemplate {
   private:
@@ -322,7 +303,7 @@ private:
       return;
     }
 
-    void fill(const reco::Track trk) {
+    void fill(const reco::Track& trk) {
       trkPts.push_back(trk.pt());
       trkEtas.push_back(trk.eta());
       trkPhis.push_back(trk.phi());
@@ -417,9 +398,113 @@ private:
     }
   };
 
+  // -- the seedTemplate members written per seed, X(type, name, export type): one list for the columnar branches (seedColumns)
+  // -- and the binary export (seedExport); export types "f4" (double members are narrowed), "i4", "u4"
+#define MUONHLT_SEED_COLUMNS(X) \
+  X(float,    mva,                                   f4) \
+  X(float,    weight,                                f4) \
+  X(int,      trueMatched,                           i4) \
+  X(int,      truePU,                                i4) \
+  X(int,      dir,                                   i4) \
+  X(uint32_t, tsos_detId,                            u4) \
+  X(float,    tsos_pt,                               f4) \
+  X(float,    tsos_pt_val,                           f4) \
+  X(float,    tsos_eta,                              f4) \
+  X(float,    tsos_phi,                              f4) \
+  X(float,    tsos_glob_x,                           f4) \
+  X(float,    tsos_glob_y,                           f4) \
+  X(float,    tsos_glob_z,                           f4) \
+  X(int,      tsos_hasErr,                           i4) \
+  X(float,    tsos_err0,                             f4) \
+  X(float,    tsos_err1,                             f4) \
+  X(float,    tsos_err2,                             f4) \
+  X(float,    tsos_err3,                             f4) \
+  X(float,    tsos_err4,                             f4) \
+  X(float,    tsos_err5,                             f4) \
+  X(float,    tsos_err6,                             f4) \
+  X(float,    tsos_err7,                             f4) \
+  X(float,    tsos_err8,                             f4) \
+  X(float,    tsos_err9,                             f4) \
+  X(float,    tsos_err10,                            f4) \
+  X(float,    tsos_err11,                            f4) \
+  X(float,    tsos_err12,                            f4) \
+  X(float,    tsos_err13,                            f4) \
+  X(float,    tsos_err14,                            f4) \
+  X(float,    tsos_x,                                f4) \
+  X(float,    tsos_y,                                f4) \
+  X(float,    tsos_dxdz,                             f4) \
+  X(float,    tsos_dydz,                             f4) \
+  X(float,    tsos_px,                               f4) \
+  X(float,    tsos_py,                               f4) \
+  X(float,    tsos_pz,                               f4) \
+  X(float,    tsos_qbp,                              f4) \
+  X(int,      tsos_charge,                           i4) \
+  X(int,      nL1Muon,                               i4) \
+  X(float,    dR_minDRL1SeedP,                       f4) \
+  X(float,    dPhi_minDRL1SeedP,                     f4) \
+  X(float,    dR_minDPhiL1SeedX,                     f4) \
+  X(float,    dPhi_minDPhiL1SeedX,                   f4) \
+  X(float,    dR_minDRL1SeedP_AtVtx,                 f4) \
+  X(float,    dPhi_minDRL1SeedP_AtVtx,               f4) \
+  X(float,    dR_minDPhiL1SeedX_AtVtx,               f4) \
+  X(float,    dPhi_minDPhiL1SeedX_AtVtx,             f4) \
+  X(float,    L1Muon_pt,                             f4) \
+  X(float,    L1Muon_eta,                            f4) \
+  X(float,    L1Muon_phi,                            f4) \
+  X(int,      nL2Muon,                               i4) \
+  X(float,    dR_minDRL2SeedP,                       f4) \
+  X(float,    dPhi_minDRL2SeedP,                     f4) \
+  X(float,    dR_minDPhiL2SeedX,                     f4) \
+  X(float,    dPhi_minDPhiL2SeedX,                   f4) \
+  X(float,    L2Muon_pt,                             f4) \
+  X(float,    L2Muon_eta,                            f4) \
+  X(float,    L2Muon_phi,                            f4) \
+  X(float,    dR_L1TkMuSeedP,                        f4) \
+  X(float,    dPhi_L1TkMuSeedP,                      f4) \
+  X(float,    bestMatchTP_charge,                    f4) \
+  X(int,      bestMatchTP_pdgId,                     i4) \
+  X(float,    bestMatchTP_energy,                    f4) \
+  X(float,    bestMatchTP_pt,                        f4) \
+  X(float,    bestMatchTP_eta,                       f4) \
+  X(float,    bestMatchTP_phi,                       f4) \
+  X(float,    bestMatchTP_parentVx,                  f4) \
+  X(float,    bestMatchTP_parentVy,                  f4) \
+  X(float,    bestMatchTP_parentVz,                  f4) \
+  X(int,      bestMatchTP_status,                    i4) \
+  X(int,      bestMatchTP_numberOfHits,              i4) \
+  X(int,      bestMatchTP_numberOfTrackerHits,       i4) \
+  X(int,      bestMatchTP_numberOfTrackerLayers,     i4) \
+  X(float,    bestMatchTP_sharedFraction,            f4) \
+  X(int,      matchedTPsize,                         i4) \
+  X(float,    bestMatchSeedTP_charge,                f4) \
+  X(int,      bestMatchSeedTP_pdgId,                 i4) \
+  X(double,   bestMatchSeedTP_energy,                f4) \
+  X(double,   bestMatchSeedTP_pt,                    f4) \
+  X(double,   bestMatchSeedTP_eta,                   f4) \
+  X(double,   bestMatchSeedTP_phi,                   f4) \
+  X(double,   bestMatchSeedTP_parentVx,              f4) \
+  X(double,   bestMatchSeedTP_parentVy,              f4) \
+  X(double,   bestMatchSeedTP_parentVz,              f4) \
+  X(int,      bestMatchSeedTP_status,                i4) \
+  X(int,      bestMatchSeedTP_numberOfHits,          i4) \
+  X(int,      bestMatchSeedTP_numberOfTrackerHits,   i4) \
+  X(int,      bestMatchSeedTP_numberOfTrackerLayers, i4) \
+  X(double,   bestMatchSeedTP_sharedFraction,        f4) \
+  X(int,      matchedSeedTPsize,                     i4) \
+  X(float,    gen_pt,                                f4) \
+  X(float,    gen_eta,                               f4) \
+  X(float,    gen_phi,                               f4)
+
+  class seedColumns;
+  class seedExport;
+
   class seedTemplate {
+    friend class seedColumns;
+    friend class seedExport;
   private:
     float mva_;
+    float weight_;
+    int trueMatched_;
     //float mva0_;
     //float mva1_;
     //float mva2_;
@@ -517,6 +602,8 @@ private:
   public:
     void clear() {
       mva_ = -99999.;
+      weight_ = 1.;
+      trueMatched_ = 0;
       truePU_ = -99999;
       dir_ = -99999;
       tsos_detId_ = 0;
@@ -613,6 +700,8 @@ private:
 
     void setBranch(TTree* tmpntpl) {
       tmpntpl->Branch("mva",          &mva_, "mva/F");
+      tmpntpl->Branch("weight",       &weight_, "weight/F");
+      tmpntpl->Branch("trueMatched",  &trueMatched_, "trueMatched/I");
       tmpntpl->Branch("truePU",       &truePU_, "truePU/I");
       tmpntpl->Branch("dir",          &dir_, "dir/I");
       tmpntpl->Branch("tsos_detId",   &tsos_detId_, "tsos_detId/i");
@@ -707,10 +796,8 @@ private:
       return;
     }
 
-    void fill(TrajectorySeed seed, const TrackerGeometry& tracker) {
-      GlobalVector p = tracker.idToDet(seed.startingState().detId())->surface().toGlobal(seed.startingState().parameters().momentum());
-      GlobalPoint x = tracker.idToDet(seed.startingState().detId())->surface().toGlobal(seed.startingState().parameters().position());
-
+    // -- p, x: global momentum and position of the starting state, computed once per seed by the caller
+    void fill(const TrajectorySeed& seed, const GlobalVector& p, const GlobalPoint& x) {
       dir_ = seed.direction();
       tsos_detId_ = seed.startingState().detId();
       tsos_pt_ = seed.startingState().pt();
@@ -760,6 +847,11 @@ private:
       return;
     }
 
+    void fill_weight( float weight ) {
+      weight_ = weight;
+      return;
+    }
+
     void fill_L1TkMuvars( float dR_L1TkMuSeedP, float dPhi_L1TkMuSeedP ) {
       dR_L1TkMuSeedP_   = dR_L1TkMuSeedP;
       dPhi_L1TkMuSeedP_ = dPhi_L1TkMuSeedP;
@@ -834,6 +926,8 @@ private:
       bestMatchTP_numberOfTrackerLayers_ = TTtrack->get_bestMatchTP_numberOfTrackerLayers(index);
       bestMatchTP_sharedFraction_        = TTtrack->get_bestMatchTP_sharedFraction(index);
       matchedTPsize_                     = TTtrack->get_matchedTPsize(index);
+      // -- signal label of the seed MVA: the track of this seed is best matched to a muon TP
+      trueMatched_                       = ( matchedTPsize_ > 0 && std::abs(bestMatchTP_pdgId_) == 13 ) ? 1 : 0;
     }
 
     void fill_SeedTP(const TrackingParticleRef TP) {
@@ -859,14 +953,367 @@ private:
     }
   };
 
+  // -- one entry per event: seeds of each iteration stored as jagged columns (doColumnar) -- //
+  class seedColumns {
+  private:
+    int nSeeds;
+#define MUONHLT_SEED_COLUMN_VECTOR(type, name, code) std::vector<type> name;
+    MUONHLT_SEED_COLUMNS(MUONHLT_SEED_COLUMN_VECTOR)
+#undef MUONHLT_SEED_COLUMN_VECTOR
+  public:
+    void clear() {
+      nSeeds = 0;
+#define MUONHLT_SEED_COLUMN_CLEAR(type, name, code) name.clear();
+      MUONHLT_SEED_COLUMNS(MUONHLT_SEED_COLUMN_CLEAR)
+#undef MUONHLT_SEED_COLUMN_CLEAR
+
+      return;
+    }
+
+    void setBranch(TTree* tmpntpl, TString name) {
+      tmpntpl->Branch("n"+name+"Seed", &nSeeds);
+#define MUONHLT_SEED_COLUMN_BRANCH(type, col, code) tmpntpl->Branch(name+"_" #col, &col);
+      MUONHLT_SEED_COLUMNS(MUONHLT_SEED_COLUMN_BRANCH)
+#undef MUONHLT_SEED_COLUMN_BRANCH
+
+      return;
+    }
+
+    void fill( const seedTemplate* ST ) {
+#define MUONHLT_SEED_COLUMN_FILL(type, name, code) name.push_back(ST->name##_);
+      MUONHLT_SEED_COLUMNS(MUONHLT_SEED_COLUMN_FILL)
+#undef MUONHLT_SEED_COLUMN_FILL
+      nSeeds++;
+
+      return;
+    }
+  };
+
+
+  // -- flat binary training export (doBinaryExport): one file per iteration, fixed-width little-endian records -- //
+  // -- header: char[8] "MHLTSEED", uint32 version, uint32 nColumns, uint64 nRecords, uint32 recordSize,
+  // --         nColumns x { char[64] name, char[4] type ("i4", "u4", "u8", "f4") }; the records follow the header
+  // -- trueMatched: the seed made a track whose best-matched TP is a muon (training label)
+  class seedExport {
+  private:
+    std::ofstream file_;
+    unsigned long long nRecords_;
+    std::vector<char> record_;
+
+    template <typename T> void put(T value) {
+      const char* bytes = reinterpret_cast<const char*>(&value);
+      record_.insert(record_.end(), bytes, bytes + sizeof(T));
+    }
+
+    typedef float f4;
+    typedef int32_t i4;
+    typedef uint32_t u4;
+
+    static const std::vector<std::pair<std::string, std::string>>& columns() {
+      static const std::vector<std::pair<std::string, std::string>> cols = {
+        {"runNum", "u4"},
+        {"lumiBlockNum", "u4"},
+        {"eventNum", "u8"},
+#define MUONHLT_SEED_EXPORT_COLUMN(type, name, code) {#name, #code},
+        MUONHLT_SEED_COLUMNS(MUONHLT_SEED_EXPORT_COLUMN)
+#undef MUONHLT_SEED_EXPORT_COLUMN
+      };
+      return cols;
+    }
+
+  public:
+    bool isOpen() const { return file_.is_open(); }
+
+    void open(const std::string& fileName) {
+      file_.open(fileName, std::ios::binary | std::ios::trunc);
+      if( !file_.is_open() )
+        throw cms::Exception("ConfigurationError") << "seedExport: cannot open " << fileName;
+
+      // -- the values are written as they are in memory: readers (readSeedBinary.py) decode them as little-endian
+      const uint32_t one = 1;
+      if( *reinterpret_cast<const char*>(&one) != 1 )
+        throw cms::Exception("ConfigurationError") << "seedExport: big-endian host, the export format is little-endian";
+
+      nRecords_ = 0;
+
+      uint32_t recordSize = 0;
+      for( const auto& col : columns() )
+        recordSize += (col.second == "u8") ? 8 : 4;
+
+      const char magic[8] = {'M','H','L','T','S','E','E','D'};
+      const uint32_t version = 1;
+      const uint32_t nColumns = columns().size();
+      file_.write(magic, 8);
+      file_.write(reinterpret_cast<const char*>(&version), sizeof(version));
+      file_.write(reinterpret_cast<const char*>(&nColumns), sizeof(nColumns));
+      file_.write(reinterpret_cast<const char*>(&nRecords_), sizeof(nRecords_)); // -- patched in close()
+      file_.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+      for( const auto& col : columns() ) {
+        char name[64] = {0};
+        char type[4] = {0};
+        col.first.copy(name, sizeof(name)-1);
+        col.second.copy(type, sizeof(type));
+        file_.write(name, sizeof(name));
+        file_.write(type, sizeof(type));
+      }
+
+      return;
+    }
+
+    void fill( unsigned run, unsigned lumi, unsigned long long event, const seedTemplate* ST ) {
+      record_.clear();
+      put<uint32_t>(run);
+      put<uint32_t>(lumi);
+      put<uint64_t>(event);
+#define MUONHLT_SEED_EXPORT_PUT(type, name, code) put<code>(ST->name##_);
+      MUONHLT_SEED_COLUMNS(MUONHLT_SEED_EXPORT_PUT)
+#undef MUONHLT_SEED_EXPORT_PUT
+
+      file_.write(record_.data(), record_.size());
+      nRecords_++;
+
+      return;
+    }
+
+    void close() {
+      if( !file_.is_open() )
+        return;
+
+      file_.seekp(16);
+      file_.write(reinterpret_cast<const char*>(&nRecords_), sizeof(nRecords_));
+      file_.close();
+
+      return;
+    }
+  };
+
+  // -- candidate kinematics packed once per event (structure of arrays) for the seed matching kernels -- //
+  class candSoA {
+  public:
+    std::vector<double> pt;
+    std::vector<double> eta;
+    std::vector<double> phi;
+    std::vector<double> etaAtVtx;
+    std::vector<double> phiAtVtx;
+    std::vector<double> vx;
+    std::vector<double> vy;
+    std::vector<double> vz;
 
-  std::map<tmpTSOD,unsigned int> hltIterL3OIMuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter0IterL3MuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter2IterL3MuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter3IterL3MuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter0IterL3FromL1MuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter2IterL3FromL1MuonTrackMap;
-  std::map<tmpTSOD,unsigned int> hltIter3IterL3FromL1MuonTrackMap;
+    void clear() {
+      pt.clear();
+      eta.clear();
+      phi.clear();
+      etaAtVtx.clear();
+      phiAtVtx.clear();
+      vx.clear();
+      vy.clear();
+      vz.clear();
+
+      return;
+    }
+
+    unsigned size() const { return pt.size(); }
+
+    void fill(const l1t::Muon& mu) {
+      pt.push_back(mu.pt());
+      eta.push_back(mu.eta());
+      phi.push_back(mu.phi());
+      etaAtVtx.push_back(mu.etaAtVtx());
+      phiAtVtx.push_back(mu.phiAtVtx());
+      vx.push_back(mu.vx());
+      vy.push_back(mu.vy());
+      vz.push_back(mu.vz());
+
+      return;
+    }
+
+    void fill(const reco::Candidate& cand) {
+      pt.push_back(cand.pt());
+      eta.push_back(cand.eta());
+      phi.push_back(cand.phi());
+      etaAtVtx.push_back(cand.eta());
+      phiAtVtx.push_back(cand.phi());
+      vx.push_back(cand.vx());
+      vy.push_back(cand.vy());
+      vz.push_back(cand.vz());
+
+      return;
+    }
+  };
+
+  // -- global starting state of all seeds in one collection -- //
+  class seedBatch {
+  public:
+    std::vector<GlobalVector> p;
+    std::vector<GlobalPoint> x;
+    std::vector<float> p_eta;
+    std::vector<float> p_phi;
+    std::vector<float> x_eta;
+    std::vector<float> x_phi;
+
+    void clear() {
+      p.clear();
+      x.clear();
+      p_eta.clear();
+      p_phi.clear();
+      x_eta.clear();
+      x_phi.clear();
+
+      return;
+    }
+
+    unsigned size() const { return p.size(); }
+
+    void fill(const GlobalVector& global_p, const GlobalPoint& global_x) {
+      p.push_back(global_p);
+      x.push_back(global_x);
+      p_eta.push_back(global_p.eta());
+      p_phi.push_back(global_p.phi());
+      x_eta.push_back(global_x.eta());
+      x_phi.push_back(global_x.phi());
+
+      return;
+    }
+  };
+
+  // -- output of one matching kernel: best candidate index (-1: none) with its dR and dPhi, per seed -- //
+  class matchResult {
+  public:
+    std::vector<int> idx;
+    std::vector<float> dR;
+    std::vector<float> dPhi;
+
+    void reset(unsigned nSeed) {
+      idx.assign(nSeed, -1);
+      dR.assign(nSeed, 99999.);
+      dPhi.assign(nSeed, 99999.);
+
+      return;
+    }
+  };
+
+  // -- working state of one seed collection, so that the collections can be processed concurrently -- //
+  class seedWork {
+  public:
+    seedBatch SB;
+    matchResult MRL1SeedP;
+    matchResult MRL1SeedX;
+    matchResult MRL1SeedPAtVtx;
+    matchResult MRL1SeedXAtVtx;
+    matchResult MRL2SeedP;
+    matchResult MRL2SeedX;
+    matchResult MRGenSeed;
+    std::vector<float> matchBuf;
+    std::vector<double> matchBufGen;
+    std::vector<seedTemplate> rows;
+
+    // -- seeds surviving the downsampling of unmatched seeds, with their inverse-probability weight
+    std::vector<unsigned> kept;
+    std::vector<float> keptWeight;
+    std::vector<int> keptTrk; // -- index in the track template, -1: no track from this seed
+
+    // -- GeomDet lookup by detId, cached per tracker geometry IOV (cleared in Fill_Seed when it changes)
+    std::unordered_map<uint32_t, const GeomDet*> geomDetCache;
+
+    void clear() {
+      SB.clear();
+      rows.clear();
+      kept.clear();
+      keptWeight.clear();
+      keptTrk.clear();
+
+      return;
+    }
+
+    const GeomDet* getGeomDet(const TrackerGeometry& tracker, uint32_t detId) {
+      auto it = geomDetCache.find(detId);
+      if( it != geomDetCache.end() )
+        return it->second;
+
+      const GeomDet* det = tracker.idToDet(detId);
+      geomDetCache.emplace(detId, det);
+      return det;
+    }
+  };
+
+  // -- one seed collection: products are fetched serially, rows are built in a task and written serially -- //
+  class seedCollection {
+  public:
+    edm::EDGetTokenT<edm::View<TrajectorySeed>>* token;
+    const pairSeedMvaEstimator* mva; // -- nullptr: no seed MVA for this collection
+    seedTrackIndex* trkMap;
+    trkTemplate* TTtrack;
+    TTree* NT;
+    seedColumns* SC;
+    int* nSeed;
+    std::string name;
+    std::unique_ptr<seedExport> exporter; // -- null: no binary export
+    double keepFraction; // -- fraction of unmatched seeds kept (1: all)
+    uint64_t nameHash;
+
+    edm::Handle<edm::View<TrajectorySeed>> seedHandle;
+    bool hasSeed;
+    int assoIndex; // -- index in seedAssociations_, -1: no association
+    bool overflow; // -- more than maxSeeds kept seeds in this event: truncated
+    unsigned long nOverflow;
+    seedWork work;
+  };
+
+  std::vector<seedCollection> seedCollections_;
+
+  // -- seed to TP association, once per distinct seed product and event, of the seeds kept by select_Seeds only:
+  // -- collections reading the same seeds (e.g. hltIter2 and hltIter0 in the Run3 menu) share it
+  std::vector<reco::RecoToSimCollectionSeed> seedAssociations_;
+
+  void add_seedCollection(
+    std::string name,
+    edm::EDGetTokenT<edm::View<TrajectorySeed>>& token,
+    const pairSeedMvaEstimator* mva,
+    seedTrackIndex& trkMap,
+    trkTemplate* TTtrack,
+    TTree* NT,
+    seedColumns* SC,
+    int& nSeed
+  );
+
+  // -- the kernels evaluate reco::deltaR / deltaPhi on the same argument types as the old per-candidate loops,
+  // -- so the selected index is identical; ties keep the first candidate
+  static void minDRKernel(
+    const std::vector<double>& candEta, const std::vector<double>& candPhi,
+    const std::vector<float>& seedEta, const std::vector<float>& seedPhi,
+    std::vector<float>& buf, matchResult* MR
+  );
+  static void minDPhiKernel(
+    const std::vector<double>& candEta, const std::vector<double>& candPhi,
+    const std::vector<float>& seedEta, const std::vector<float>& seedPhi,
+    std::vector<float>& buf, matchResult* MR
+  );
+  static void minDRGenKernel( const candSoA* gen, const seedBatch* seeds, std::vector<double>& buf, matchResult* MR );
+
+  // -- uniform number in [0,1) from (run, event, collection, seed index): same keep decision in every job
+  static double seedSamplingUniform( unsigned run, unsigned long long event, uint64_t nameHash, unsigned iSeed );
+  void select_Seeds(seedCollection& coll);
+
+  void pack_Candidates(const edm::Event &iEvent);
+  void fill_seedBatch(seedWork* W, const edm::View<TrajectorySeed>& seeds, const TrackerGeometry& tracker);
+  void match_Seeds(seedWork* W) const;
+  void fill_Matches(const seedWork* W, unsigned iSeed, seedTemplate* row) const;
+
+  bool hasGen_;
+  bool hasL1_;
+  bool hasL2_;
+
+  candSoA* SoAgenMuon = new candSoA();
+  candSoA* SoAL1Muon = new candSoA();
+  candSoA* SoAL2Muon = new candSoA();
+
+  seedTrackIndex hltIterL3OIMuonTrackMap;
+  seedTrackIndex hltIter0IterL3MuonTrackMap;
+  seedTrackIndex hltIter2IterL3MuonTrackMap;
+  seedTrackIndex hltIter3IterL3MuonTrackMap;
+  seedTrackIndex hltIter0IterL3FromL1MuonTrackMap;
+  seedTrackIndex hltIter2IterL3FromL1MuonTrackMap;
+  seedTrackIndex hltIter3IterL3FromL1MuonTrackMap;
 
   trkTemplate* TThltIterL3OIMuonTrack = new trkTemplate();
   trkTemplate* TThltIter0IterL3MuonTrack = new trkTemplate();
@@ -878,28 +1325,44 @@ private:
 
   seedTemplate* ST = new seedTemplate();
 
+  seedColumns* SChltIterL3OI = new seedColumns();
+  seedColumns* SChltIter0 = new seedColumns();
+  seedColumns* SChltIter2 = new seedColumns();
+  seedColumns* SChltIter3 = new seedColumns();
+  seedColumns* SChltIter0FromL1 = new seedColumns();
+  seedColumns* SChltIter2FromL1 = new seedColumns();
+  seedColumns* SChltIter3FromL1 = new seedColumns();
+
+  edm::EDGetTokenT<reco::RecoToSimCollection> consumes_TrackAssociation(const edm::ParameterSet& iConfig, edm::ConsumesCollector& iC, const std::string& name);
+
   void fill_trackTemplate(const edm::Event &iEvent, edm::EDGetTokenT<edm::View<reco::Track>>& theToken,
-    edm::Handle<reco::TrackToTrackingParticleAssociator>& theAssociator_, edm::Handle<TrackingParticleCollection>& TPCollection_,
-    std::map<tmpTSOD,unsigned int>& trkMap, trkTemplate* TTtrack);
+    edm::EDGetTokenT<reco::RecoToSimCollection>& assoToken,
+    bool hasAssociator, edm::Handle<reco::TrackToTrackingParticleAssociator>& theAssociator_, edm::Handle<TrackingParticleCollection>& TPCollection_,
+    seedTrackIndex& trkMap, trkTemplate* TTtrack);
 
   void fill_seedTemplate(
-    const edm::Event &,
-    edm::EDGetTokenT<edm::View<TrajectorySeed>>&,
-    const TrackerGeometry&,
-    std::map<tmpTSOD,unsigned int>&,
-    trkTemplate*,
-    TTree*,
-    int &nSeed
+    seedCollection& coll,
+    const TrackerGeometry& tracker,
+    const edm::Handle<l1t::MuonBxCollection>& h_L1Muon,
+    const edm::Handle<reco::RecoChargedCandidateCollection>& h_L2Muon
   );
+};
 
-  void fill_seedTemplate(
-    const edm::Event &,
-    edm::EDGetTokenT<edm::View<TrajectorySeed>>&,
-    const pairSeedMvaEstimator&,
-    const TrackerGeometry&,
-    std::map<tmpTSOD,unsigned int>&,
-    trkTemplate*,
-    TTree*,
-    int &nSeed
-  );
+class MuonHLTSeedNtupler : public edm::one::EDAnalyzer<>
+{
+public:
+  explicit MuonHLTSeedNtupler(const edm::ParameterSet &iConfig);
+  virtual ~MuonHLTSeedNtupler() {};
+
+  virtual void analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup);
+  virtual void beginJob();
+  virtual void endJob();
+
+  // virtual void beginRun(const edm::Run &iRun, const edm::EventSetup &iSetup);
+  // virtual void endRun(const edm::Run &iRun, const edm::EventSetup &iSetup);
+
+private:
+  MuonHLTSeedNtupleMaker maker_;
 };
+
+#endif
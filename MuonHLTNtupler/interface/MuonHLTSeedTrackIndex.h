@@ -0,0 +1,148 @@
+// -- seed state -> track index shared by MuonHLTNtupler and MuonHLTSeedNtupler (seed-track links)
+// -- tsodKey: exact hash key of a packed seed state; tmpTSOD: the former std::map key, kept for the validation mode
+
+#ifndef MuonHLTTool_MuonHLTNtupler_MuonHLTSeedTrackIndex_h
+#define MuonHLTTool_MuonHLTNtupler_MuonHLTSeedTrackIndex_h
+
+#include "DataFormats/TrajectoryState/interface/PTrajectoryStateOnDet.h"
+
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace MuonHLT {
+
+class tmpTSOD {
+private:
+  uint32_t TSODDetId;
+  float TSODPt;
+  float TSODX;
+  float TSODY;
+  float TSODDxdz;
+  float TSODDydz;
+  float TSODPx;
+  float TSODPy;
+  float TSODPz;
+  float TSODqbp;
+  int TSODCharge;
+public:
+  void SetTmpTSOD(const PTrajectoryStateOnDet& TSODIn) {
+    TSODDetId = TSODIn.detId();
+    TSODPt = TSODIn.pt();
+    TSODX = TSODIn.parameters().position().x();
+    TSODY = TSODIn.parameters().position().y();
+    TSODDxdz = TSODIn.parameters().dxdz();
+    TSODDydz = TSODIn.parameters().dydz();
+    TSODPx = TSODIn.parameters().momentum().x();
+    TSODPy = TSODIn.parameters().momentum().y();
+    TSODPz = TSODIn.parameters().momentum().z();
+    TSODqbp = TSODIn.parameters().qbp();
+    TSODCharge = TSODIn.parameters().charge();
+  }
+
+  tmpTSOD(const PTrajectoryStateOnDet& TSODIn) { SetTmpTSOD(TSODIn); }
+
+  bool operator==(const tmpTSOD& other) const {
+    return (
+      this->TSODDetId == other.TSODDetId &&
+      this->TSODPt == other.TSODPt &&
+      this->TSODX == other.TSODX &&
+      this->TSODY == other.TSODY &&
+      this->TSODDxdz == other.TSODDxdz &&
+      this->TSODDydz == other.TSODDydz &&
+      this->TSODPx == other.TSODPx &&
+      this->TSODPy == other.TSODPy &&
+      this->TSODPz == other.TSODPz &&
+      this->TSODqbp == other.TSODqbp &&
+      this->TSODCharge == other.TSODCharge
+    );
+  }
+
+  bool operator<(const tmpTSOD& other) const {
+    return (this->TSODPt!=other.TSODPt) ? (this->TSODPt < other.TSODPt) : (this->TSODDetId < other.TSODDetId);
+  }
+};
+
+// -- exact key of a packed seed state: detId and the bit patterns of the stored local parameters (qbp, dxdz, dydz, x, y)
+// -- a track's seedRef() points to the same TrajectorySeed as in the seed collection, so the bits agree exactly
+class tsodKey {
+public:
+  uint32_t detId;
+  uint32_t par[5];
+
+  tsodKey(const PTrajectoryStateOnDet& TSODIn) {
+    const LocalTrajectoryParameters& lp = TSODIn.parameters();
+    const float v[5] = { lp.qbp(), lp.dxdz(), lp.dydz(), lp.position().x(), lp.position().y() };
+    detId = TSODIn.detId();
+    std::memcpy(par, v, sizeof(par));
+  }
+
+  bool operator==(const tsodKey& other) const {
+    return detId == other.detId && std::memcmp(par, other.par, sizeof(par)) == 0;
+  }
+
+  struct hash {
+    size_t operator()(const tsodKey& k) const {
+      uint64_t h = k.detId;
+      for( uint32_t p : k.par ) {
+        h = (h ^ p) * 0x9e3779b97f4a7c15ULL;
+        h ^= (h >> 29);
+      }
+      return h;
+    }
+  };
+};
+
+// -- seed state -> track index, O(1) per lookup
+// -- validation mode: the former std::map<tmpTSOD> is filled as well and every lookup is cross-checked against it
+class seedTrackIndex {
+private:
+  std::unordered_map<tsodKey, unsigned int, tsodKey::hash> index_;
+  bool validate_ = false;
+  std::map<tmpTSOD,unsigned int> legacy_;
+  mutable std::atomic<unsigned long> nChecked_{0};
+  mutable std::atomic<unsigned long> nMismatch_{0};
+
+  void check(const PTrajectoryStateOnDet& TSODIn, int idx) const {
+    auto whereLegacy = legacy_.find(tmpTSOD(TSODIn));
+    int idxLegacy = (whereLegacy==legacy_.end()) ? -1 : (int)whereLegacy->second;
+    nChecked_++;
+    if( idx != idxLegacy ) nMismatch_++;
+  }
+public:
+  void setValidation(bool validate) { validate_ = validate; }
+  bool validation() const { return validate_; }
+  unsigned long nChecked() const { return nChecked_; }
+  unsigned long nMismatch() const { return nMismatch_; }
+  size_t size() const { return index_.size(); }
+
+  void clear() {
+    index_.clear();
+    legacy_.clear();
+    return;
+  }
+
+  void insert(const PTrajectoryStateOnDet& TSODIn, unsigned int idx) {
+    index_.emplace(tsodKey(TSODIn), idx);
+    if( validate_ )
+      legacy_.insert(std::make_pair(tmpTSOD(TSODIn), idx));
+    return;
+  }
+
+  // -- -1: no track from this seed; const, concurrent lookups are allowed (seed collections in parallel tasks)
+  int find(const PTrajectoryStateOnDet& TSODIn) const {
+    auto where = index_.find(tsodKey(TSODIn));
+    int idx = (where==index_.end()) ? -1 : (int)where->second;
+
+    if( validate_ )
+      check(TSODIn, idx);
+
+    return idx;
+  }
+};
+
+} // -- namespace MuonHLT
+
+#endif
@@ -0,0 +1,74 @@
+// -- track to TP association by hits of all HLT muon track collections in one module
+// -- the hit associators (tracker sim links, DT/CSC/RPC/GEM sim hits) are built once per event and shared by the
+// -- MuonAssociatorByHitsHelper of every collection, instead of twice per collection and event in each MuonAssociatorEDProducer clone
+// -- products: reco::RecoToSimCollection and reco::SimToRecoCollection with the collection label as instance name
+
+#include "FWCore/Framework/interface/one/EDProducer.h"
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/View.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/TrackerCommon/interface/TrackerTopology.h"
+#include "Geometry/Records/interface/TrackerTopologyRcd.h"
+
+#include "SimDataFormats/Associations/interface/TrackToTrackingParticleAssociator.h"
+#include "SimDataFormats/TrackingAnalysis/interface/TrackingParticle.h"
+#include "SimDataFormats/TrackingAnalysis/interface/TrackingParticleFwd.h"
+#include "SimTracker/TrackerHitAssociation/interface/TrackerHitAssociator.h"
+#include "SimMuon/MCTruth/interface/MuonAssociatorByHitsHelper.h"
+#include "SimMuon/MCTruth/interface/CSCHitAssociator.h"
+#include "SimMuon/MCTruth/interface/DTHitAssociator.h"
+#include "SimMuon/MCTruth/interface/RPCHitAssociator.h"
+#include "SimMuon/MCTruth/interface/GEMHitAssociator.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class MuonHLTTrackAssociationProducer : public edm::one::EDProducer<>
+{
+public:
+  explicit MuonHLTTrackAssociationProducer(const edm::ParameterSet &iConfig);
+  virtual ~MuonHLTTrackAssociationProducer() {};
+
+  virtual void produce(edm::Event &iEvent, const edm::EventSetup &iSetup);
+  virtual void endJob();
+
+private:
+  // -- one per track collection: the MuonAssociatorByHits parameters of the former clone (PurityCut_track, UseMuon, ...)
+  class trackAssociation {
+  public:
+    std::string label;
+    edm::EDGetTokenT<edm::View<reco::Track>> token;
+    bool ignoreMissing;
+    std::unique_ptr<MuonAssociatorByHitsHelper> helper;
+
+    double time;   // -- seconds spent scoring this collection, summed over events
+    unsigned long nTrack;
+  };
+
+  std::vector<trackAssociation> associations_;
+
+  // -- hit associator configuration: common to all collections, taken from hitAssociator
+  edm::ParameterSet hitConf_;
+  TrackerHitAssociator::Config trackerHitAssociatorConfig_;
+  CSCHitAssociator::Config cscHitAssociatorConfig_;
+  RPCHitAssociator::Config rpcHitAssociatorConfig_;
+  GEMHitAssociator::Config gemHitAssociatorConfig_;
+  bool useMuon_; // -- muon hit associators are only built if a collection uses muon hits
+
+  bool tpRefVector_;
+  edm::EDGetTokenT<TrackingParticleCollection> tpToken_;
+  edm::EDGetTokenT<TrackingParticleRefVector> tpRefVectorToken_;
+  const edm::ESGetToken<TrackerTopology, TrackerTopologyRcd> tTopoToken_;
+
+  bool printTiming_;
+  unsigned long nEvent_;
+  double timeIndex_; // -- seconds spent building the hit associators, summed over events
+};
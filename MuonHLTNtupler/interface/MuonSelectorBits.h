@@ -0,0 +1,39 @@
+// -- bit layout of muon_selectorBits[nMuon]/i, written by MuonHLTNtupler (doMuonSelectorBits) and read by NtupleAnalyzer/Include/Object.h
+// -- plain C++, no CMSSW or ROOT header: included by both sides, so the layout is defined here only
+
+#ifndef MuonHLTTool_MuonHLTNtupler_MuonSelectorBits_h
+#define MuonHLTTool_MuonHLTNtupler_MuonSelectorBits_h
+
+// -- X(name, bit): k<name> in MuonHLT::MuonSelectorBit, "<name>" in the selection of the efficiencyHist PSets
+#define MUONHLT_MUON_SELECTOR_BITS(X) \
+  X(GLB,                0)  /* -- muon_is* decisions */ \
+  X(STA,                1)  \
+  X(TRK,                2)  \
+  X(PF,                 3)  \
+  X(Tight,              4)  \
+  X(Medium,             5)  \
+  X(Loose,              6)  \
+  X(HighPt,             7)  \
+  X(HighPtNew,          8)  \
+  X(Soft,               9)  \
+  X(PFIsoVeryLoose,     10) /* -- relative PF isolation, R=0.4 with delta beta correction: < 0.40 */ \
+  X(PFIsoLoose,         11) /* -- < 0.25 */ \
+  X(PFIsoMedium,        12) /* -- < 0.20 */ \
+  X(PFIsoTight,         13) /* -- < 0.15 */ \
+  X(PFIsoVeryTight,     14) /* -- < 0.10 */ \
+  X(PFIsoVeryVeryTight, 15) /* -- < 0.05 */ \
+  X(TrkIsoLoose,        16) /* -- relative tracker isolation, R=0.3: < 0.10 */ \
+  X(TrkIsoTight,        17) /* -- < 0.05 */
+
+namespace MuonHLT {
+
+// -- bit set = selection passed
+enum MuonSelectorBit {
+#define MUONHLT_MUON_SELECTOR_BIT_ENUM(name, bit) k##name = bit,
+  MUONHLT_MUON_SELECTOR_BITS(MUONHLT_MUON_SELECTOR_BIT_ENUM)
+#undef MUONHLT_MUON_SELECTOR_BIT_ENUM
+};
+
+}
+
+#endif
@@ -0,0 +1,311 @@
+// -- gen muon to L1TT track / L1TkMuon matching for Phase-2, see the header
+
+#include "MuonHLTTool/MuonHLTNtupler/plugins/GenMuAnalyzer.h"
+
+#include "DataFormats/Math/interface/deltaR.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+
+void GenMuAnalyzer::etaSortedIndex::sort()
+{
+  std::sort(entries_.begin(), entries_.end());
+}
+
+int GenMuAnalyzer::etaSortedIndex::closest(double eta, double phi, double dR, double &dRMin) const
+{
+  int best = -1;
+  double dR2Min = dR*dR;
+
+  const entry low = {eta - dR, 0., -1};
+  for( auto it = std::lower_bound(entries_.begin(), entries_.end(), low); it != entries_.end() && it->eta <= eta + dR; ++it ) {
+    const double dPhi = std::abs(reco::deltaPhi(phi, it->phi)); // -- in [0, pi]: phi = +-pi neighbours are found
+    if( dPhi >= dR )
+      continue;
+
+    const double dEta = eta - it->eta;
+    const double dR2 = dEta*dEta + dPhi*dPhi;
+    if( dR2 < dR2Min ) {
+      dR2Min = dR2;
+      best = it->index;
+    }
+  }
+
+  dRMin = best >= 0 ? std::sqrt(dR2Min) : -1.;
+  return best;
+}
+
+GenMuAnalyzer::GenMuAnalyzer(const edm::ParameterSet& iConfig):
+t_genParticle_( consumes< reco::GenParticleCollection >( iConfig.getParameter<edm::InputTag>("genParticle_src") ) ),
+t_L1TT_(        consumes< L1TTCollection >(              iConfig.getParameter<edm::InputTag>("L1TT_src") ) ),
+t_L1TkMuon_(    consumes< l1t::TkMuonCollection >(       iConfig.getParameter<edm::InputTag>("L1TkMuon_src") ) ),
+ptMin_(iConfig.getParameter<double>("pt_min")),
+dR_(iConfig.getUntrackedParameter<double>("dR", 0.3)),
+minGenMuonSorted_(iConfig.getUntrackedParameter<unsigned>("minGenMuonSorted", 2)),
+benchmarkBruteForce_(iConfig.getUntrackedParameter<bool>("benchmarkBruteForce", false)),
+nEvent_(0),
+nEventSorted_(0),
+nGenMuonTotal_(0),
+nMatchDiff_(0),
+timeSorted_(0.),
+timeBruteForce_(0.),
+ntuple_(nullptr)
+{
+  usesResource("TFileService");
+}
+
+void GenMuAnalyzer::beginJob()
+{
+  edm::Service<TFileService> fs;
+  TH1::SetDefaultSumw2(true);
+
+  h_gen_pt              = fs->make<TH1F>("h_gen_pt",  "", 1000, 0, 1000);
+  h_gen_eta             = fs->make<TH1F>("h_gen_eta", "", 60, -3, 3);
+  h_gen_matL1TkMuon_pt  = fs->make<TH1F>("h_gen_matL1TkMuon_pt",  "", 1000, 0, 1000);
+  h_gen_matL1TkMuon_eta = fs->make<TH1F>("h_gen_matL1TkMuon_eta", "", 60, -3, 3);
+  h_gen_matL1TT_pt      = fs->make<TH1F>("h_gen_matL1TT_pt",  "", 1000, 0, 1000);
+  h_gen_matL1TT_eta     = fs->make<TH1F>("h_gen_matL1TT_eta", "", 60, -3, 3);
+
+  ntuple_ = fs->make<TTree>("ntuple","ntuple");
+  Make_Branch();
+}
+
+void GenMuAnalyzer::Init()
+{
+  runNum_       = -999;
+  lumiBlockNum_ = -999;
+  eventNum_     = 0;
+
+  nL1TT_     = 0;
+  nL1TkMuon_ = 0;
+  nGenMuon_  = 0;
+
+  for( int i=0; i<arrSize_; i++)
+  {
+    genMuon_pt_[i] = -999;
+    genMuon_eta_[i] = -999;
+    genMuon_phi_[i] = -999;
+    genMuon_charge_[i] = -999;
+
+    genMuon_L1TT_idx_[i] = -1;
+    genMuon_L1TT_dR_[i] = -999;
+    genMuon_L1TT_pt_[i] = -999;
+    genMuon_L1TT_eta_[i] = -999;
+    genMuon_L1TT_phi_[i] = -999;
+    genMuon_L1TT_z0_[i] = -999;
+
+    genMuon_L1TkMuon_idx_[i] = -1;
+    genMuon_L1TkMuon_dR_[i] = -999;
+    genMuon_L1TkMuon_pt_[i] = -999;
+    genMuon_L1TkMuon_eta_[i] = -999;
+    genMuon_L1TkMuon_phi_[i] = -999;
+  }
+}
+
+void GenMuAnalyzer::Make_Branch()
+{
+  ntuple_->Branch("runNum",&runNum_,"runNum/I");
+  ntuple_->Branch("lumiBlockNum",&lumiBlockNum_,"lumiBlockNum/I");
+  ntuple_->Branch("eventNum",&eventNum_,"eventNum/l"); // -- unsigned long long -- //
+
+  ntuple_->Branch("nL1TT", &nL1TT_, "nL1TT/I");
+  ntuple_->Branch("nL1TkMuon", &nL1TkMuon_, "nL1TkMuon/I");
+
+  ntuple_->Branch("nGenMuon", &nGenMuon_, "nGenMuon/I");
+  ntuple_->Branch("genMuon_pt", &genMuon_pt_, "genMuon_pt[nGenMuon]/D");
+  ntuple_->Branch("genMuon_eta", &genMuon_eta_, "genMuon_eta[nGenMuon]/D");
+  ntuple_->Branch("genMuon_phi", &genMuon_phi_, "genMuon_phi[nGenMuon]/D");
+  ntuple_->Branch("genMuon_charge", &genMuon_charge_, "genMuon_charge[nGenMuon]/I");
+
+  ntuple_->Branch("genMuon_L1TT_idx", &genMuon_L1TT_idx_, "genMuon_L1TT_idx[nGenMuon]/I");
+  ntuple_->Branch("genMuon_L1TT_dR", &genMuon_L1TT_dR_, "genMuon_L1TT_dR[nGenMuon]/D");
+  ntuple_->Branch("genMuon_L1TT_pt", &genMuon_L1TT_pt_, "genMuon_L1TT_pt[nGenMuon]/D");
+  ntuple_->Branch("genMuon_L1TT_eta", &genMuon_L1TT_eta_, "genMuon_L1TT_eta[nGenMuon]/D");
+  ntuple_->Branch("genMuon_L1TT_phi", &genMuon_L1TT_phi_, "genMuon_L1TT_phi[nGenMuon]/D");
+  ntuple_->Branch("genMuon_L1TT_z0", &genMuon_L1TT_z0_, "genMuon_L1TT_z0[nGenMuon]/D");
+
+  ntuple_->Branch("genMuon_L1TkMuon_idx", &genMuon_L1TkMuon_idx_, "genMuon_L1TkMuon_idx[nGenMuon]/I");
+  ntuple_->Branch("genMuon_L1TkMuon_dR", &genMuon_L1TkMuon_dR_, "genMuon_L1TkMuon_dR[nGenMuon]/D");
+  ntuple_->Branch("genMuon_L1TkMuon_pt", &genMuon_L1TkMuon_pt_, "genMuon_L1TkMuon_pt[nGenMuon]/D");
+  ntuple_->Branch("genMuon_L1TkMuon_eta", &genMuon_L1TkMuon_eta_, "genMuon_L1TkMuon_eta[nGenMuon]/D");
+  ntuple_->Branch("genMuon_L1TkMuon_phi", &genMuon_L1TkMuon_phi_, "genMuon_L1TkMuon_phi[nGenMuon]/D");
+}
+
+void GenMuAnalyzer::analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup)
+{
+  Init();
+
+  runNum_       = iEvent.id().run();
+  lumiBlockNum_ = iEvent.id().luminosityBlock();
+  eventNum_     = iEvent.id().event();
+
+  edm::Handle<L1TTCollection> h_L1TT;
+  bool hasL1TT = iEvent.getByToken(t_L1TT_, h_L1TT);
+
+  edm::Handle<l1t::TkMuonCollection> h_L1TkMuon;
+  bool hasL1TkMuon = iEvent.getByToken(t_L1TkMuon_, h_L1TkMuon);
+
+  edm::Handle<reco::GenParticleCollection> h_genParticle;
+  if( !hasL1TT || !hasL1TkMuon || !iEvent.getByToken(t_genParticle_, h_genParticle) )
+    return;
+
+  nEvent_++;
+
+  std::vector<const reco::GenParticle*> genMuons;
+  for( const auto& genp : *h_genParticle ) {
+    if( fabs(genp.pdgId()) != 13 )  continue;
+    if( !genp.isPromptFinalState() )  continue;
+    if( !genp.fromHardProcessFinalState() )  continue;
+    if( fabs(genp.eta()) > 2.4 )  continue;
+    genMuons.push_back(&genp);
+  }
+  nGenMuonTotal_ += genMuons.size();
+
+  nL1TT_     = h_L1TT->size();
+  nL1TkMuon_ = h_L1TkMuon->size();
+  if( genMuons.empty() ) {
+    ntuple_->Fill();
+    return;
+  }
+
+  // -- L1TT matching: eta, phi of each track computed and sorted once per event, then one window per gen muon
+  // -- below minGenMuonSorted gen muons: one loop over all tracks per gen muon, cheaper than the sort
+  auto start = std::chrono::steady_clock::now();
+
+  const L1TTCollection& L1TTs = *h_L1TT;
+  std::vector<int> matchL1TT(genMuons.size(), -1);
+  std::vector<double> dRL1TT(genMuons.size(), -1.);
+  if( genMuons.size() >= minGenMuonSorted_ ) {
+    nEventSorted_++;
+    L1TTIndex_.clear();
+    for( auto i=0U; i<L1TTs.size(); ++i )
+      L1TTIndex_.add(L1TTs[i].momentum().eta(), L1TTs[i].momentum().phi(), i);
+    L1TTIndex_.sort();
+
+    for( auto i=0U; i<genMuons.size(); ++i )
+      matchL1TT[i] = L1TTIndex_.closest(genMuons[i]->eta(), genMuons[i]->phi(), dR_, dRL1TT[i]);
+  }
+  else {
+    for( auto i=0U; i<genMuons.size(); ++i )
+      matchL1TT[i] = closestBruteForce(L1TTs, *genMuons[i], dRL1TT[i]);
+  }
+
+  timeSorted_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if( benchmarkBruteForce_ ) {
+    auto startBruteForce = std::chrono::steady_clock::now();
+    std::vector<int> matchBruteForce(genMuons.size(), -1);
+    std::vector<double> dRBruteForce(genMuons.size(), -1.);
+    for( auto i=0U; i<genMuons.size(); ++i )
+      matchBruteForce[i] = closestBruteForce(L1TTs, *genMuons[i], dRBruteForce[i]);
+    timeBruteForce_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - startBruteForce).count();
+
+    // -- same closest track, up to tracks at the same distance
+    for( auto i=0U; i<genMuons.size(); ++i ) {
+      if( matchL1TT[i] != matchBruteForce[i] && std::abs(dRL1TT[i] - dRBruteForce[i]) > 1e-9 )
+        nMatchDiff_++;
+    }
+  }
+
+  int _nGenMuon = 0;
+  for( auto i=0U; i<genMuons.size(); ++i ) {
+    const reco::GenParticle& genp = *genMuons[i];
+
+    double dRL1TkMuon = -1.;
+    const int iL1TkMuon = closestBruteForce(*h_L1TkMuon, genp, dRL1TkMuon);
+
+    h_gen_pt->Fill( genp.pt() );
+    if( genp.pt() > ptMin_ )  h_gen_eta->Fill( genp.eta() );
+
+    if( matchL1TT[i] >= 0 ) {
+      h_gen_matL1TT_pt->Fill( genp.pt() );
+      if( genp.pt() > ptMin_ )  h_gen_matL1TT_eta->Fill( genp.eta() );
+    }
+
+    if( iL1TkMuon >= 0 ) {
+      h_gen_matL1TkMuon_pt->Fill( genp.pt() );
+      if( genp.pt() > ptMin_ )  h_gen_matL1TkMuon_eta->Fill( genp.eta() );
+    }
+
+    if( _nGenMuon >= arrSize_ )
+      continue;
+
+    genMuon_pt_[_nGenMuon]     = genp.pt();
+    genMuon_eta_[_nGenMuon]    = genp.eta();
+    genMuon_phi_[_nGenMuon]    = genp.phi();
+    genMuon_charge_[_nGenMuon] = genp.charge();
+
+    if( matchL1TT[i] >= 0 ) {
+      const auto& L1TT = L1TTs[matchL1TT[i]];
+      genMuon_L1TT_idx_[_nGenMuon] = matchL1TT[i];
+      genMuon_L1TT_dR_[_nGenMuon]  = dRL1TT[i];
+      genMuon_L1TT_pt_[_nGenMuon]  = L1TT.momentum().perp();
+      genMuon_L1TT_eta_[_nGenMuon] = L1TT.momentum().eta();
+      genMuon_L1TT_phi_[_nGenMuon] = L1TT.momentum().phi();
+      genMuon_L1TT_z0_[_nGenMuon]  = L1TT.z0();
+    }
+
+    if( iL1TkMuon >= 0 ) {
+      const l1t::TkMuon& L1TkMuon = (*h_L1TkMuon)[iL1TkMuon];
+      genMuon_L1TkMuon_idx_[_nGenMuon] = iL1TkMuon;
+      genMuon_L1TkMuon_dR_[_nGenMuon]  = dRL1TkMuon;
+      genMuon_L1TkMuon_pt_[_nGenMuon]  = L1TkMuon.pt();
+      genMuon_L1TkMuon_eta_[_nGenMuon] = L1TkMuon.eta();
+      genMuon_L1TkMuon_phi_[_nGenMuon] = L1TkMuon.phi();
+    }
+
+    _nGenMuon++;
+  }
+  nGenMuon_ = _nGenMuon;
+
+  ntuple_->Fill();
+}
+
+// -- former matching: every L1TT track for each gen muon, also used in the events below minGenMuonSorted
+int GenMuAnalyzer::closestBruteForce(const L1TTCollection &L1TTs, const reco::GenParticle &genMuon, double &dRMin) const
+{
+  int best = -1;
+  dRMin = -1.;
+  for( auto i=0U; i<L1TTs.size(); ++i ) {
+    const double dR = reco::deltaR( L1TTs[i].momentum(), genMuon );
+    if( dR < dR_ && (best < 0 || dR < dRMin) ) {
+      best  = i;
+      dRMin = dR;
+    }
+  }
+  return best;
+}
+
+int GenMuAnalyzer::closestBruteForce(const l1t::TkMuonCollection &L1TkMuons, const reco::GenParticle &genMuon, double &dRMin) const
+{
+  int best = -1;
+  dRMin = -1.;
+  for( auto i=0U; i<L1TkMuons.size(); ++i ) {
+    const double dR = reco::deltaR( L1TkMuons[i], genMuon );
+    if( dR < dR_ && (best < 0 || dR < dRMin) ) {
+      best  = i;
+      dRMin = dR;
+    }
+  }
+  return best;
+}
+
+void GenMuAnalyzer::endJob()
+{
+  if( !benchmarkBruteForce_ || nEvent_ == 0 )
+    return;
+
+  cout << "[GenMuAnalyzer::endJob] " << nEvent_ << " events, " << nGenMuonTotal_ << " gen muons, L1TT matching time per event:" << endl;
+  cout << "  " << std::left << std::setw(30) << "default" << std::fixed << std::setprecision(3) << 1e6*timeSorted_/nEvent_ << " us"
+       << " (eta sorted in " << nEventSorted_ << " events with >= " << minGenMuonSorted_ << " gen muons, loop in the others)" << endl;
+  cout << "  " << std::left << std::setw(30) << "brute force" << std::fixed << std::setprecision(3) << 1e6*timeBruteForce_/nEvent_ << " us" << endl;
+  cout << "  gen muons with a different closest L1TT track: " << nMatchDiff_ << endl;
+}
+
+DEFINE_FWK_MODULE(GenMuAnalyzer);
@@ -0,0 +1,128 @@
+// -- Phase-2 gen muon to L1 track trigger track (L1TT) and L1TkMuon matching
+// -- each prompt, hard-process gen muon within |eta| < 2.4 is matched to the closest L1TT track and L1TkMuon within dR
+// -- output (TFileService): the former efficiency histograms and an ntuple in the MuonHLTNtupler style (genMuon_* arrays)
+// -- the L1TT tracks are sorted by eta once per event: each gen muon only looks at the tracks in [eta - dR, eta + dR]
+// -- with fewer than minGenMuonSorted gen muons in the event, the loop over all tracks is used instead (no sort)
+// -- L1TkMuons (a few per event) are always matched by the loop
+// -- Phase-2 only: built as its own plugin (plugins/BuildFile.xml) with the L1 track trigger dependencies
+
+#ifndef MuonHLTTool_MuonHLTNtupler_GenMuAnalyzer_h
+#define MuonHLTTool_MuonHLTNtupler_GenMuAnalyzer_h
+
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/HepMCCandidate/interface/GenParticle.h"
+#include "DataFormats/Math/interface/deltaPhi.h"
+#include "DataFormats/L1TrackTrigger/interface/TTTypes.h"
+#include "DataFormats/L1TrackTrigger/interface/TTTrack.h"
+#include "DataFormats/L1TCorrelator/interface/TkMuon.h"
+#include "DataFormats/L1TCorrelator/interface/TkMuonFwd.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+
+#include "TTree.h"
+#include "TH1F.h"
+
+#include <string>
+#include <vector>
+
+class GenMuAnalyzer : public edm::one::EDAnalyzer<edm::one::SharedResources>
+{
+public:
+  explicit GenMuAnalyzer(const edm::ParameterSet &iConfig);
+  virtual ~GenMuAnalyzer() {};
+
+  virtual void analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup);
+  virtual void beginJob();
+  virtual void endJob();
+
+private:
+  // -- (eta, phi) of a collection sorted by eta, built once per event
+  // -- closest(): binary search of the eta window, then |dphi| (wrapped at +-pi) and dR on the window only
+  class etaSortedIndex {
+  public:
+    class entry {
+    public:
+      double eta;
+      double phi;
+      int index; // -- in the original collection
+      bool operator<(const entry &other) const { return eta < other.eta; }
+    };
+
+    void clear() { entries_.clear(); }
+    void add(double eta, double phi, int index) { entries_.push_back({eta, phi, index}); }
+    void sort();
+    int closest(double eta, double phi, double dR, double &dRMin) const; // -- index, -1 if none within dR
+
+  private:
+    std::vector<entry> entries_;
+  };
+
+  typedef std::vector< TTTrack< Ref_Phase2TrackerDigi_ > > L1TTCollection;
+
+  void Init();
+  void Make_Branch();
+  int closestBruteForce(const L1TTCollection &L1TTs, const reco::GenParticle &genMuon, double &dRMin) const;
+  int closestBruteForce(const l1t::TkMuonCollection &L1TkMuons, const reco::GenParticle &genMuon, double &dRMin) const;
+
+  edm::EDGetTokenT< reco::GenParticleCollection > t_genParticle_;
+  edm::EDGetTokenT< L1TTCollection >              t_L1TT_;
+  edm::EDGetTokenT< l1t::TkMuonCollection >       t_L1TkMuon_;
+  double ptMin_;
+  double dR_;
+  unsigned minGenMuonSorted_; // -- below: loop over all L1TT tracks, the sort costs more than it saves
+
+  etaSortedIndex L1TTIndex_;
+
+  // -- benchmarkBruteForce: also run the former loop over every L1TT track per gen muon, time and matches compared in endJob
+  bool benchmarkBruteForce_;
+  unsigned long nEvent_;
+  unsigned long nEventSorted_; // -- events matched with the eta sorted index
+  unsigned long nGenMuonTotal_;
+  unsigned long nMatchDiff_;  // -- gen muons with a different closest L1TT track in the two methods
+  double timeSorted_;         // -- seconds, summed over events, sorting included; the loop in the events below minGenMuonSorted
+  double timeBruteForce_;
+
+  TH1F *h_gen_pt;
+  TH1F *h_gen_eta;
+  TH1F *h_gen_matL1TkMuon_pt;
+  TH1F *h_gen_matL1TkMuon_eta;
+  TH1F *h_gen_matL1TT_pt;
+  TH1F *h_gen_matL1TT_eta;
+
+  TTree *ntuple_;
+  static const int arrSize_ = 100;
+
+  int runNum_;
+  int lumiBlockNum_;
+  unsigned long long eventNum_;
+
+  int nL1TT_;
+  int nL1TkMuon_;
+
+  int nGenMuon_;
+  double genMuon_pt_[arrSize_];
+  double genMuon_eta_[arrSize_];
+  double genMuon_phi_[arrSize_];
+  int genMuon_charge_[arrSize_];
+
+  int genMuon_L1TT_idx_[arrSize_]; // -- -1: no L1TT track within dR
+  double genMuon_L1TT_dR_[arrSize_];
+  double genMuon_L1TT_pt_[arrSize_];
+  double genMuon_L1TT_eta_[arrSize_];
+  double genMuon_L1TT_phi_[arrSize_];
+  double genMuon_L1TT_z0_[arrSize_];
+
+  int genMuon_L1TkMuon_idx_[arrSize_]; // -- -1: no L1TkMuon within dR
+  double genMuon_L1TkMuon_dR_[arrSize_];
+  double genMuon_L1TkMuon_pt_[arrSize_];
+  double genMuon_L1TkMuon_eta_[arrSize_];
+  double genMuon_L1TkMuon_phi_[arrSize_];
+};
+
+#endif
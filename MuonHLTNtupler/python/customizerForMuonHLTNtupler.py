@@ -6,30 +6,141 @@
 import FWCore.ParameterSet.Config as cms
 import HLTrigger.Configuration.MuonHLTForRun3.mvaScale as _mvaScale
 
-def customizerFuncForMuonHLTNtupler(process, newProcessName = "MYHLT", isDIGI = True, sysTag = "PPOnAA"):
+# -- track to TP associator by hits of the HLT tracks, backend:
+# --   "hits":  trackAssociatorByHits, sim links looked up hit by hit
+# --   "quick": quickTrackAssociatorByHits, on a cluster to TP map of the HLT clusters built once per event (hltTPClusterProducer)
+def hltTrackAssociatorForBackend(process, backend, pixelSimLinkSrc, stripSimLinkSrc,
+                                 pixelClusterSrc = "hltSiPixelClusters", stripClusterSrc = "hltSiStripRawToClustersFacility"):
+    if backend == "hits":
+        import SimTracker.TrackAssociatorProducers.trackAssociatorByHits_cfi
+        return SimTracker.TrackAssociatorProducers.trackAssociatorByHits_cfi.trackAssociatorByHits.clone(
+            UsePixels = cms.bool(True),
+            UseGrouped = cms.bool(True),
+            UseSplitting = cms.bool(True),
+            ThreeHitTracksAreSpecial = cms.bool(False),
+            associatePixel = cms.bool(True),
+            associateStrip = cms.bool(True),
+            usePhase2Tracker = cms.bool(False),
+            pixelSimLinkSrc = pixelSimLinkSrc,
+            stripSimLinkSrc = stripSimLinkSrc,
+            phase2TrackerSimLinkSrc  = cms.InputTag("simSiPixelDigis","Tracker"),
+            associateRecoTracks = cms.bool(True)
+        )
+
+    if backend == "quick":
+        import SimTracker.TrackAssociatorProducers.quickTrackAssociatorByHits_cfi
+        from SimTracker.TrackerHitAssociation.tpClusterProducer_cfi import tpClusterProducer as _tpClusterProducer
+        if not hasattr(process, "hltTPClusterProducer"):
+            process.hltTPClusterProducer = _tpClusterProducer.clone(
+                pixelClusterSrc = pixelClusterSrc,
+                stripClusterSrc = stripClusterSrc,
+                pixelSimLinkSrc = pixelSimLinkSrc,
+                stripSimLinkSrc = stripSimLinkSrc,
+                trackingParticleSrc = cms.InputTag("mix","MergedTrackTruth")
+            )
+        return SimTracker.TrackAssociatorProducers.quickTrackAssociatorByHits_cfi.quickTrackAssociatorByHits.clone(
+            cluster2TPSrc            = cms.InputTag("hltTPClusterProducer"),
+            UseGrouped               = cms.bool( False ),
+            UseSplitting             = cms.bool( False ),
+            ThreeHitTracksAreSpecial = cms.bool( False )
+        )
+
+    raise Exception("hltTrackAssociatorForBackend: unknown associator backend %s (hits or quick)" % backend)
+
+# -- branch groups of the ntupler (friendBranchGroups), empty friendBranchGroups: all of them are written
+ntuplerBranchGroups = ["event", "HLT", "MYHLT", "variants", "muon", "muonMatch", "HLTMuon", "L1Muon", "iterL3", "tracks", "gen", "TP"]
+
+# -- muons to tracks (MuonTrackProducer) behind the ntuple track collections made from muons
+muonTrackProducerOfTrackCollection = {
+    "iterL3MuonNoIDTrackAssociated":   "hltIterL3MuonsNoIDTracks",
+    "iterL3MuonTrackAssociated":       "hltIterL3MuonsTracks",
+    "hltIterL3GlbMuonTrackAssociated": "hltIterL3GlbMuonTracks",
+}
+
+# -- printout of a schedule pruning: kept (label, who reads it) and removed (label, reason)
+def printSchedulePruning(caller, kept, removed, dryRun):
+    print("[%s] schedule pruning%s" % (caller, " (dry run, nothing removed)" if dryRun else ""))
+    for label, reason in kept:
+        print("[%s]   + %-50s %s" % (caller, label, reason))
+    for label, reason in removed:
+        print("[%s]   - %-50s %s" % (caller, label, reason))
+
+# -- configuration of a track to TP association product with the track collection left out: producer type, TP collection,
+# -- cuts and inputs, and for an associator-based producer (TrackAssociatorEDProducer) the type and parameters of its associator
+# -- two track collections associated with the same configuration are associated in the same way: used to share a product between
+# -- the ntuplers only when it is the association the other one would have made
+# -- one collection of MuonHLTTrackAssociationProducer: its MuonAssociatorByHits parameters (same association, see MuonHLTAssociationComparison)
+def trackAssociationConfig(process, module, instance = ""):
+    def dump(params, skip):
+        return sorted( (name, param.dumpPython()) for name, param in params.items() if name not in skip )
+
+    if module.type_() == "MuonHLTTrackAssociationProducer":
+        params = [pset for pset in module.collections if pset.label.value() == instance][0].parameters_()
+        return ("MuonAssociatorByHits", dump(params, ["label", "tracksTag"]))
+
+    params = module.parameters_()
+    config = dump(params, ["tracksTag", "label_tr", "associator"])
+    if "associator" in params:
+        associator = getattr(process, params["associator"].getModuleLabel())
+        config.append( ("associator", associator.type_(), dump(associator.parameters_(), [])) )
+    return (module.type_(), config)
+
+# -- FastTimerService job summary and JSON (time per module label), for the comparisons of associators / associations
+def enableFastTimerSummary(process, jsonFileName):
+    if not hasattr(process, "FastTimerService"):
+        from HLTrigger.Timer.FastTimerService_cfi import FastTimerService as _FastTimerService
+        process.FastTimerService = _FastTimerService.clone()
+    process.FastTimerService.printJobSummary  = cms.untracked.bool(True)
+    process.FastTimerService.writeJSONSummary = cms.untracked.bool(True)
+    process.FastTimerService.jsonFileName     = cms.untracked.string(jsonFileName)
+
+# -- HLT menu variant rerun in the same job as the nominal menu, to be called after customizerFuncForMuonHLTNtupler:
+# -- the paths in pathNames are cloned with all their modules, labels + suffix, except the modules of sharedSequences
+# -- (RAW unpacking, local reconstruction, ...: run once for all variants); customize(process, suffix) then modifies the clones,
+# -- e.g. getattr(process, "hltL3MuonCandidatesPPOnAA" + suffix).X = ...
+# -- the variant's fired paths, filter objects and L3 muons are stored by the ntupler side by side with the nominal ones (vec_<name>_*)
+def addMenuVariant(process, name, suffix, pathNames, customize = None, newProcessName = "MYHLT", sysTag = "PPOnAA",
+                   sharedSequences = ["HLTBeginSequence", "HLTMuonLocalRecoSequence", "HLTDoLocalPixelSequence", "HLTDoLocalStripSequence"]):
+    from PhysicsTools.PatAlgos.tools.helpers import cloneProcessingSnippet
+
+    sharedModules = set()
+    for seqName in sharedSequences:
+        if hasattr(process, seqName):
+            sharedModules.update( getattr(process, seqName).moduleNames() )
+
+    for pathName in pathNames:
+        path = getattr(process, pathName)
+        variantSeq = cloneProcessingSnippet(process, cms.Sequence(path._seq), suffix, noClones = list(sharedModules))
+        setattr(process, pathName + suffix, cms.Path(variantSeq))
+        if process.schedule is not None:
+            process.schedule.append( getattr(process, pathName + suffix) )
+
+    if customize is not None:
+        customize(process, suffix)
+
+    process.ntupler.menuVariants.append( cms.PSet(
+        name           = cms.string(name),
+        suffix         = cms.string(suffix),
+        triggerResults = cms.InputTag("TriggerResults", "", newProcessName),
+        triggerEvent   = cms.InputTag("hltTriggerSummaryAOD", "", newProcessName),
+        iterL3Muon     = cms.InputTag("hltIterL3Muons" + sysTag + suffix, "", newProcessName),
+    ) )
+
+    return process
+
+def customizerFuncForMuonHLTNtupler(process, newProcessName = "MYHLT", isDIGI = True, sysTag = "PPOnAA", sharedTrackAssociation = True,
+                                    associatorBackend = "hits", compareAssociators = False, compareSharedTrackAssociation = False,
+                                    friendBranchGroups = [], friendReference = "", trackCollections = [], dryRun = False):
     process.load("TrackPropagation.SteppingHelixPropagator.SteppingHelixPropagatorAlong_cfi")
     if hasattr(process, "DQMOutput"):
         del process.DQMOutput
 
 
     from MuonHLTTool.MuonHLTNtupler.ntupler_cfi import ntuplerBase
-    #import SimTracker.TrackAssociatorProducers.quickTrackAssociatorByHits_cfi
-    import SimTracker.TrackAssociatorProducers.trackAssociatorByHits_cfi
-    from SimTracker.TrackerHitAssociation.tpClusterProducer_cfi import tpClusterProducer as _tpClusterProducer
 
     from SimGeneral.TrackingAnalysis.simHitTPAssociation_cfi import simHitTPAssocProducer as _simHitTPAssocProducer
     process.simHitTPAssocProducer = _simHitTPAssocProducer.clone()
 
-    # process.hltTPClusterProducer = _tpClusterProducer.clone(
-    #   pixelClusterSrc = "hltSiPixelClusters",
-    #   stripClusterSrc = "hltSiStripRawToClustersFacility"
-    # )
-
-    # process.hltTrackAssociatorByHits = SimTracker.TrackAssociatorProducers.quickTrackAssociatorByHits_cfi.quickTrackAssociatorByHits.clone()
-    # process.hltTrackAssociatorByHits.cluster2TPSrc            = cms.InputTag("hltTPClusterProducer")
-    # process.hltTrackAssociatorByHits.UseGrouped               = cms.bool( False )
-    # process.hltTrackAssociatorByHits.UseSplitting             = cms.bool( False )
-    # process.hltTrackAssociatorByHits.ThreeHitTracksAreSpecial = cms.bool( False )
     if sysTag is "PPOnAA":
         process.load("RecoHI.HiCentralityAlgos.CentralityBin_cfi")
         process.centralityBin.Centrality = cms.InputTag("hiCentrality")
@@ -46,21 +157,15 @@ def customizerFuncForMuonHLTNtupler(process, newProcessName = "MYHLT", isDIGI =
 
 
 
-    process.hltTrackAssociatorByHits = SimTracker.TrackAssociatorProducers.trackAssociatorByHits_cfi.trackAssociatorByHits.clone(
-        UsePixels = cms.bool(True),
-        UseGrouped = cms.bool(True),
-        UseSplitting = cms.bool(True),
-        ThreeHitTracksAreSpecial = cms.bool(False),
-        associatePixel = cms.bool(True),
-        associateStrip = cms.bool(True),
-        usePhase2Tracker = cms.bool(False),
+    # -- associatorBackend "hits" or "quick", see hltTrackAssociatorForBackend
+    # -- quick: clusters of the rerun local reconstruction, suffixed by sysTag as the muon collections below
+    process.hltTrackAssociatorByHits = hltTrackAssociatorForBackend(process, associatorBackend,
         pixelSimLinkSrc = cms.InputTag("prunedDigiSimLinks","siPixel"),
         stripSimLinkSrc = cms.InputTag("prunedDigiSimLinks","siStrip"),
-        phase2TrackerSimLinkSrc  = cms.InputTag("simSiPixelDigis","Tracker"),
+        pixelClusterSrc = cms.InputTag("hltSiPixelClusters" + sysTag),
+        stripClusterSrc = cms.InputTag("hltSiStripRawToClustersFacility" + sysTag),
         #pixelSimLinkSrc = cms.InputTag("simSiPixelDigis",""),
         #stripSimLinkSrc = cms.InputTag("simSiStripDigis", ""),
-        #phase2TrackerSimLinkSrc  = cms.InputTag("simSiPixelDigis",""),
-        associateRecoTracks = cms.bool(True)
     )
 
     # Produce tracks from L3 muons -- to use track hit association
@@ -223,30 +328,53 @@ def customizerFuncForMuonHLTNtupler(process, newProcessName = "MYHLT", isDIGI =
         #'AhltDiMuonMerging',
         'AhltIterL3GlbMuon',
     ]
-    process.trackAssoSeq = cms.Sequence(
-        process.TPmu +
-        process.hltIterL3MuonsNoIDTracks +
-        process.hltIterL3MuonsTracks +
-        process.hltIterL3GlbMuonTracks +
-        process.AhltIterL3OIMuonTrackSelectionHighPurity +
-        process.AhltIter0IterL3MuonTrackSelectionHighPurity +
-        #process.AhltIter2IterL3MuonTrackSelectionHighPurity +
-        process.AhltIter0IterL3FromL1MuonTrackSelectionHighPurity +
-        #process.AhltIter2IterL3FromL1MuonTrackSelectionHighPurity +
-        #process.AhltIter2IterL3MuonMerged +
-        #process.AhltIter2IterL3FromL1MuonMerged +
-        process.AhltIterL3MuonMerged +
-        process.AhltIterL3MuonAndMuonFromL1Merged +
-        process.AhltIterL3MuonsNoID +
-        process.AhltIterL3Muons +
-        #process.AhltPixelTracks +
-        process.AhltPixelTracksInRegionL2 +
-        process.AhltPixelTracksInRegionL1 +
-        #process.AhltPixelTracksForSeedsL3Muon +
-        #process.AhltMuCtfTracks +
-        #process.AhltDiMuonMerging +
-        process.AhltIterL3GlbMuon
-    )
+
+    # -- all the associations above from one MuonHLTTrackAssociationProducer: same helper and parameters per collection,
+    # -- the hit associators are built once per event instead of twice per collection (printTiming: time per event in endJob)
+    if sharedTrackAssociation:
+        process.hltMuonTrackAssociation = cms.EDProducer("MuonHLTTrackAssociationProducer",
+            collections = cms.VPSet( [ cms.PSet(label = cms.string(assoLabel), **getattr(process, assoLabel).clone().parameters_()) for assoLabel in assoLabels ] ),
+            printTiming = cms.untracked.bool(False),
+            **hltMuonAssociatorByHits.clone().parameters_()
+        )
+        # -- compareSharedTrackAssociation: the per-collection producers are kept as reference, see below
+        if not compareSharedTrackAssociation:
+            for assoLabel in assoLabels:
+                delattr(process, assoLabel)
+        assoLabels = [ "hltMuonTrackAssociation:" + assoLabel for assoLabel in assoLabels ]
+
+        process.trackAssoSeq = cms.Sequence(
+            process.TPmu +
+            process.hltIterL3MuonsNoIDTracks +
+            process.hltIterL3MuonsTracks +
+            process.hltIterL3GlbMuonTracks +
+            process.hltMuonTrackAssociation
+        )
+    else:
+        process.trackAssoSeq = cms.Sequence(
+            process.TPmu +
+            process.hltIterL3MuonsNoIDTracks +
+            process.hltIterL3MuonsTracks +
+            process.hltIterL3GlbMuonTracks +
+            process.AhltIterL3OIMuonTrackSelectionHighPurity +
+            process.AhltIter0IterL3MuonTrackSelectionHighPurity +
+            #process.AhltIter2IterL3MuonTrackSelectionHighPurity +
+            process.AhltIter0IterL3FromL1MuonTrackSelectionHighPurity +
+            #process.AhltIter2IterL3FromL1MuonTrackSelectionHighPurity +
+            #process.AhltIter2IterL3MuonMerged +
+            #process.AhltIter2IterL3FromL1MuonMerged +
+            process.AhltIterL3MuonMerged +
+            process.AhltIterL3MuonAndMuonFromL1Merged +
+            process.AhltIterL3MuonsNoID +
+            process.AhltIterL3Muons +
+            #process.AhltPixelTracks +
+            process.AhltPixelTracksInRegionL2 +
+            process.AhltPixelTracksInRegionL1 +
+            #process.AhltPixelTracksForSeedsL3Muon +
+            #process.AhltMuCtfTracks +
+            #process.AhltDiMuonMerging +
+            process.AhltIterL3GlbMuon
+        )
     process.trackAssoSeqNoGen = cms.Sequence(
         process.hltIterL3MuonsNoIDTracks +
         process.hltIterL3MuonsTracks +
@@ -426,4 +554,140 @@ def customizerFuncForMuonHLTNtupler(process, newProcessName = "MYHLT", isDIGI =
                                       process.L1AssoSeq)
             process.myendpath = cms.EndPath(process.ntupler)
 
+    # -- friend tree of an existing ntuple: only the producers read by friendBranchGroups are kept below
+    if friendBranchGroups:
+        process.ntupler.friendBranchGroups = cms.untracked.vstring(friendBranchGroups)
+        process.ntupler.friendReference = cms.untracked.string(friendReference)
+
+    # -- schedule pruning: a producer put on mypath above is kept only if a written branch group reads its output
+    # -- trackCollections: ntuple track collections (trackNames) to associate and fill, empty = all
+    # -- dryRun: only print what is kept and what would be removed, the schedule is left as it is
+    groups = set(friendBranchGroups) if friendBranchGroups else set(ntuplerBranchGroups)
+    if "tracks" in groups:
+        groups.add("iterL3")
+    if "muonMatch" in groups:
+        groups.add("muon")
+
+    for trackName in trackCollections:
+        if trackName not in trackNames:
+            raise Exception("customizerFuncForMuonHLTNtupler: unknown track collection %s (%s)" % (trackName, ", ".join(trackNames)))
+    keepTrack = [ "tracks" in groups and (not trackCollections or trackName in trackCollections) for trackName in trackNames ]
+
+    readers = {}  # -- label -> branch groups reading it, empty: not read
+    readers["HLTBeginSequence"] = groups & set(["event", "muon", "muonMatch", "HLTMuon", "L1Muon", "iterL3", "tracks", "gen"])  # -- L1 unpacking
+    if process.ntupler.doLumiSummary.value():
+        readers["HLTBeginSequence"].add("lumi")  # -- L1 muons and lumi scalers of the lumi summary, also when a friend tree does not write them
+    for seqName in ["HLTL2muonrecoSequencePPOnAA", "HLTL3muonrecoPPOnAASequence", "HLTL2muonrecoSequence", "HLTL3muonrecoSequence"]:
+        readers[seqName] = groups & set(["event", "muonMatch", "HLTMuon", "iterL3", "tracks"])
+    for trackName, trackLabel, assoLabel, keep in zip(trackNames, trackLabels, assoLabels, keepTrack):
+        if trackName in muonTrackProducerOfTrackCollection:
+            readers[muonTrackProducerOfTrackCollection[trackName]] = set(["tracks"]) if keep else set()
+        readers[assoLabel] = set(["tracks"]) if keep else set()
+    readers["TPmu"]                    = set(["tracks"]) if any(keepTrack) else set()
+    readers["hltMuonTrackAssociation"] = set(["tracks"]) if any(keepTrack) else set()
+    # -- the "hits" backend associators (TrackAssociatorByHitsProducer) read the sim hit to TP map under the fixed label simHitTPAssocProducer
+    hitsAssociators = []
+    if isDIGI and associatorBackend == "hits":
+        hitsAssociators.append("hltTrackAssociatorByHits")
+    if isDIGI and compareAssociators:
+        hitsAssociators.append("hltTrackAssociatorByHits_hits")
+    readers["simHitTPAssocProducer"]   = set(hitsAssociators)
+    readers["centralityBin"]           = groups & set(["muon"])  # -- doHI
+    readers["recomuonL1Info"]          = groups & set(["muon"])
+    readers["recomuonL1InfoByQ"]       = groups & set(["muon"])
+    readers["genmuonL1Info"]           = groups & set(["gen"])
+    readers["genmuonL1InfoByQ"]        = groups & set(["gen"])
+
+    onDemand = ["hltTrackAssociatorByHits", "simHitTPAssocProducer"]  # -- read by the associators only: taken off mypath into hltAssociatorTask
+    kept, removed = [], []
+    for label, groupsReading in readers.items():
+        if label.startswith("hltMuonTrackAssociation:"):
+            if not groupsReading:
+                removed.append((label, "track collection not filled"))
+            continue
+        if not (hasattr(process, label) and process.mypath.contains(getattr(process, label))):
+            continue
+        if groupsReading and label in onDemand:
+            removed.append((label, "read by %s, moved to hltAssociatorTask (on demand)" % ", ".join(sorted(groupsReading))))
+        elif groupsReading:
+            kept.append((label, ", ".join(sorted(groupsReading))))
+        else:
+            removed.append((label, "not read by the written branch groups"))
+    # -- the ntupler does not read the track associator itself: produced on demand only (e.g. for a merged seed ntupler)
+    if isDIGI and process.mypath.contains(process.hltTrackAssociatorByHits):
+        removed.append(("hltTrackAssociatorByHits", "not read by the ntupler, moved to hltAssociatorTask (on demand)"))
+    onDemand = [ label for label, reason in removed if label in onDemand and reason.endswith("(on demand)") ]
+
+    if not dryRun:
+        for label, reason in removed:
+            if label.startswith("hltMuonTrackAssociation:"):
+                collections = [ pset for pset in process.hltMuonTrackAssociation.collections if pset.label.value() != label.split(":")[1] ]
+                process.hltMuonTrackAssociation.collections = cms.VPSet(collections)
+            elif label.startswith("HLT") or label in onDemand:
+                process.mypath.remove(getattr(process, label))  # -- shared with the HLT paths / still available on demand
+            else:
+                delattr(process, label)
+
+        trackNames  = [ trackName  for trackName,  keep in zip(trackNames,  keepTrack) if keep ]
+        trackLabels = [ trackLabel for trackLabel, keep in zip(trackLabels, keepTrack) if keep ]
+        assoLabels  = [ assoLabel  for assoLabel,  keep in zip(assoLabels,  keepTrack) if keep ]
+        process.ntupler.trackCollectionNames  = cms.untracked.vstring(   trackNames )
+        process.ntupler.trackCollectionLabels = cms.untracked.VInputTag( trackLabels )
+        process.ntupler.associationLabels     = cms.untracked.VInputTag( assoLabels )
+
+    if dryRun:
+        printSchedulePruning("customizerFuncForMuonHLTNtupler", kept, removed, dryRun)
+
+    # -- both backends on the same events: per-collection agreement (best TP, quality) and time per event, reference "hits"
+    # -- NTTiming only has associateRecoToSim; the whole chain of each backend (simHitTPAssocProducer or hltTPClusterProducer,
+    # -- then hltTrackAssociatorByHits_<backend>) is timed per module label by the FastTimerService (job summary and JSON)
+    if isDIGI and (compareAssociators or associatorBackend == "quick" or not process.mypath.contains(process.hltTrackAssociatorByHits)):
+        associatorModules = []
+        if not process.mypath.contains(process.hltTrackAssociatorByHits):
+            associatorModules.append(process.hltTrackAssociatorByHits)
+        if hasattr(process, "simHitTPAssocProducer") and not process.mypath.contains(process.simHitTPAssocProducer):
+            associatorModules.append(process.simHitTPAssocProducer)
+        if compareAssociators:
+            for backend in ["hits", "quick"]:
+                setattr(process, "hltTrackAssociatorByHits_"+backend, hltTrackAssociatorForBackend(process, backend,
+                    pixelSimLinkSrc = cms.InputTag("prunedDigiSimLinks","siPixel"),
+                    stripSimLinkSrc = cms.InputTag("prunedDigiSimLinks","siStrip"),
+                    pixelClusterSrc = cms.InputTag("hltSiPixelClusters" + sysTag),
+                    stripClusterSrc = cms.InputTag("hltSiStripRawToClustersFacility" + sysTag),
+                ))
+                associatorModules.append(getattr(process, "hltTrackAssociatorByHits_"+backend))
+
+            process.associatorComparison = cms.EDAnalyzer("MuonHLTAssociatorComparison",
+                associatorNames       = cms.untracked.vstring("hits", "quick"),
+                associators           = cms.untracked.VInputTag("hltTrackAssociatorByHits_hits", "hltTrackAssociatorByHits_quick"),
+                trackCollectionNames  = cms.untracked.vstring( [ trackName.replace("Associated", "") for trackName in trackNames ] ),
+                trackCollectionLabels = cms.untracked.VInputTag( trackLabels ),
+                trackingParticle      = cms.untracked.InputTag("mix","MergedTrackTruth")
+            )
+            process.myendpath += process.associatorComparison
+
+            enableFastTimerSummary(process, "associatorComparison_timing.json")
+
+        if hasattr(process, "hltTPClusterProducer"):
+            associatorModules.append(process.hltTPClusterProducer)
+        process.hltAssociatorTask = cms.Task(*associatorModules)
+        process.myendpath.associate(process.hltAssociatorTask)
+
+    # -- hltMuonTrackAssociation against the per-collection MuonAssociatorEDProducer it replaces, on the same events:
+    # -- the products have to be identical (MuonHLTAssociationComparison, endJob), the time of hltMuonTrackAssociation and
+    # -- of the sum of the Ahlt* modules from the FastTimerService (sharedAssociationComparison_timing.json)
+    if isDIGI and sharedTrackAssociation and compareSharedTrackAssociation and assoLabels and not dryRun:
+        refLabels = [ assoLabel.split(":")[1] for assoLabel in assoLabels ]
+        process.sharedAssociationComparison = cms.EDAnalyzer("MuonHLTAssociationComparison",
+            trackCollectionNames  = cms.untracked.vstring( [ trackName.replace("Associated", "") for trackName in trackNames ] ),
+            trackCollectionLabels = cms.untracked.VInputTag( trackLabels ),
+            referenceAssociations = cms.untracked.VInputTag( refLabels ),
+            testAssociations      = cms.untracked.VInputTag( assoLabels ),
+        )
+        process.myendpath += process.sharedAssociationComparison
+        process.sharedAssociationReferenceTask = cms.Task(*[ getattr(process, refLabel) for refLabel in refLabels ])
+        process.myendpath.associate(process.sharedAssociationReferenceTask)
+
+        enableFastTimerSummary(process, "sharedAssociationComparison_timing.json")
+
     return process
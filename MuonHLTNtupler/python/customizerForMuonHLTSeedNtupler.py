@@ -2,54 +2,37 @@
 # -- add two lines in the HLT config.:
 # from MuonHLTTool.MuonHLTNtupler.customizerForMuonHLTSeedNtupler import *
 # process = customizerFuncForMuonHLTSeedNtupler(process, "MYHLT")
+# -- with mergeWithNtupler = True (after customizerFuncForMuonHLTNtupler), the seed ntuple is filled by the ntupler module itself
+# -- (process.ntupler.seedNtuple, trees in ntupler/seedNtupler) instead of a MuonHLTSeedNtupler on its own path: one module, one schedule;
+# -- the track association of a collection both read is shared only when the ntupler's association has the same configuration
+# -- (TP collection, associator and cuts) as the seed ntuple's own one
 
 import FWCore.ParameterSet.Config as cms
 import HLTrigger.Configuration.MuonHLTForRun3.mvaScale as _mvaScale
 
-def customizerFuncForMuonHLTSeedNtupler(process, newProcessName = "MYHLT", isDIGI = True):
+def customizerFuncForMuonHLTSeedNtupler(process, newProcessName = "MYHLT", isDIGI = True, reuseTrackAssociation = True, mergeWithNtupler = False,
+                                        associatorBackend = "hits", dryRun = False):
     if hasattr(process, "DQMOutput"):
         del process.DQMOutput
 
+    if mergeWithNtupler and not (hasattr(process, "ntupler") and hasattr(process, "myendpath")):
+        raise Exception("customizerFuncForMuonHLTSeedNtupler: mergeWithNtupler = True needs customizerFuncForMuonHLTNtupler to be applied first")
+
     from MuonHLTTool.MuonHLTNtupler.ntupler_seed_cfi import seedNtuplerBase
-    #import SimTracker.TrackAssociatorProducers.quickTrackAssociatorByHits_cfi
-    import SimTracker.TrackAssociatorProducers.trackAssociatorByHits_cfi
-    from SimTracker.TrackerHitAssociation.tpClusterProducer_cfi import tpClusterProducer as _tpClusterProducer
+    from MuonHLTTool.MuonHLTNtupler.customizerForMuonHLTNtupler import hltTrackAssociatorForBackend, printSchedulePruning, trackAssociationConfig
 
     from SimGeneral.TrackingAnalysis.simHitTPAssociation_cfi import simHitTPAssocProducer as _simHitTPAssocProducer
-    process.simHitTPAssocProducer = _simHitTPAssocProducer.clone()
-
-    # process.hltTPClusterProducer = _tpClusterProducer.clone(
-    #   pixelClusterSrc = "hltSiPixelClusters",
-    #   stripClusterSrc = "hltSiStripRawToClustersFacility"
-    # )
-
-    # process.hltTrackAssociatorByHits = SimTracker.TrackAssociatorProducers.quickTrackAssociatorByHits_cfi.quickTrackAssociatorByHits.clone()
-    # process.hltTrackAssociatorByHits.cluster2TPSrc            = cms.InputTag("hltTPClusterProducer")
-    # process.hltTrackAssociatorByHits.UseGrouped               = cms.bool( False )
-    # process.hltTrackAssociatorByHits.UseSplitting             = cms.bool( False )
-    # process.hltTrackAssociatorByHits.ThreeHitTracksAreSpecial = cms.bool( False )
-
-    # process.hltSeedAssociatorByHits = SimTracker.TrackAssociatorProducers.quickTrackAssociatorByHits_cfi.quickTrackAssociatorByHits.clone()
-    # process.hltSeedAssociatorByHits.cluster2TPSrc            = cms.InputTag("hltTPClusterProducer")
-    # process.hltSeedAssociatorByHits.UseGrouped               = cms.bool( False )
-    # process.hltSeedAssociatorByHits.UseSplitting             = cms.bool( False )
-    # process.hltSeedAssociatorByHits.ThreeHitTracksAreSpecial = cms.bool( False )
-    # process.hltSeedAssociatorByHits.Cut_RecoToSim = cms.double(0.)
-
-    process.hltTrackAssociatorByHits = SimTracker.TrackAssociatorProducers.trackAssociatorByHits_cfi.trackAssociatorByHits.clone(
-        UsePixels = cms.bool(True),
-        UseGrouped = cms.bool(True),
-        UseSplitting = cms.bool(True),
-        ThreeHitTracksAreSpecial = cms.bool(False),
-        associatePixel = cms.bool(True),
-        associateStrip = cms.bool(True),
-        usePhase2Tracker = cms.bool(False),
+    # -- read by the "hits" backend associators under this fixed label; mergeWithNtupler: the ntupler's one, if it kept it
+    if not mergeWithNtupler or (isDIGI and associatorBackend == "hits" and not hasattr(process, "simHitTPAssocProducer")):
+        process.simHitTPAssocProducer = _simHitTPAssocProducer.clone()
+
+    # -- associatorBackend "hits" (trackAssociatorByHits) or "quick" (quickTrackAssociatorByHits), see hltTrackAssociatorForBackend
+    # -- own label: hltTrackAssociatorByHits of customizerFuncForMuonHLTNtupler (other sim links and clusters) is left as it is
+    process.hltSeedTrackAssociatorByHits = hltTrackAssociatorForBackend(process, associatorBackend,
         pixelSimLinkSrc = cms.InputTag("simSiPixelDigis"),
         stripSimLinkSrc = cms.InputTag("simSiStripDigis"),
-        phase2TrackerSimLinkSrc  = cms.InputTag("simSiPixelDigis","Tracker"),
-        associateRecoTracks = cms.bool(True)
     )
-    process.hltSeedAssociatorByHits = process.hltTrackAssociatorByHits.clone(
+    process.hltSeedAssociatorByHits = process.hltSeedTrackAssociatorByHits.clone(
         Cut_RecoToSim = cms.double(0.)
     )
 
@@ -74,10 +57,63 @@ def customizerFuncForMuonHLTSeedNtupler(process, newProcessName = "MYHLT", isDIG
     process.seedNtupler.hltIter2IterL3FromL1MuonTrack                     = cms.untracked.InputTag("hltIter0IterL3FromL1MuonTrackSelectionHighPurity",    "", newProcessName)
     process.seedNtupler.hltIter3IterL3FromL1MuonTrack                     = cms.untracked.InputTag("hltIter3IterL3FromL1MuonTrackSelectionHighPurity",    "", newProcessName)
 
-    process.seedNtupler.associator = cms.untracked.InputTag("hltTrackAssociatorByHits")
+    process.seedNtupler.associator = cms.untracked.InputTag("hltSeedTrackAssociatorByHits")
     process.seedNtupler.seedAssociator = cms.untracked.InputTag("hltSeedAssociatorByHits")
     process.seedNtupler.trackingParticle = cms.untracked.InputTag("mix","MergedTrackTruth")
 
+    # -- track to TP association by hits produced once per track collection and consumed by the ntupler,
+    # -- instead of being recomputed inside the module
+    # -- mergeWithNtupler: a collection already associated for the MuonHLTNtupler on mypath (hltMuonTrackAssociation or its Ahlt*
+    # -- producers) is read from there if that association has the configuration of the seed ntupler's one (trackAssociationConfig);
+    # -- with the default ones (MuonAssociatorByHits on TPmu vs trackAssociatorByHits on all TPs) each keeps its own
+    trackAssociationModules = []
+    sharedTrackAssociations = []
+    if isDIGI and reuseTrackAssociation:
+        from SimTracker.TrackAssociation.trackingParticleRecoTrackAsssociation_cfi import trackingParticleRecoTrackAsssociation as _trackingParticleRecoTrackAsssociation
+
+        def tagKey(tag):
+            tag = tag if isinstance(tag, cms.InputTag) else cms.InputTag(tag)
+            return (tag.getModuleLabel(), tag.getProductInstanceLabel(), tag.getProcessName())
+
+        ntuplerAssociations = {}
+        if mergeWithNtupler:
+            for trackTag, assoTag in zip(process.ntupler.trackCollectionLabels, process.ntupler.associationLabels):
+                ntuplerAssociations[tagKey(trackTag)] = tagKey(assoTag)
+
+        trackNames = [
+            "hltIterL3OIMuonTrack",
+            "hltIter0IterL3MuonTrack",
+            "hltIter2IterL3MuonTrack",
+            "hltIter3IterL3MuonTrack",
+            "hltIter0IterL3FromL1MuonTrack",
+            "hltIter2IterL3FromL1MuonTrack",
+            "hltIter3IterL3FromL1MuonTrack",
+        ]
+        assoLabels = {}  # -- one producer per distinct track collection
+        for trackName in trackNames:
+            trackTag = getattr(process.seedNtupler, trackName)
+            seedAssociation = _trackingParticleRecoTrackAsssociation.clone(
+                associator = cms.InputTag("hltSeedTrackAssociatorByHits"),
+                label_tp = cms.InputTag("mix","MergedTrackTruth"),
+                label_tr = cms.InputTag(trackTag.getModuleLabel(), trackTag.getProductInstanceLabel(), trackTag.getProcessName()),
+                ignoremissingtrackcollection = cms.untracked.bool(True)
+            )
+
+            if tagKey(trackTag) in ntuplerAssociations:
+                ntuplerAssociation = ntuplerAssociations[tagKey(trackTag)]
+                if trackAssociationConfig(process, getattr(process, ntuplerAssociation[0]), ntuplerAssociation[1]) == trackAssociationConfig(process, seedAssociation):
+                    setattr(process.seedNtupler, trackName+"Association", cms.untracked.InputTag(*ntuplerAssociation))
+                    sharedTrackAssociations.append(":".join(ntuplerAssociation[:2]).rstrip(":"))
+                    continue
+
+            if trackTag.getModuleLabel() not in assoLabels:
+                assoLabel = trackTag.getModuleLabel() + "TPAssociation"
+                setattr(process, assoLabel, seedAssociation)
+                trackAssociationModules.append(getattr(process, assoLabel))
+                assoLabels[trackTag.getModuleLabel()] = assoLabel
+
+            setattr(process.seedNtupler, trackName+"Association", cms.untracked.InputTag(assoLabels[trackTag.getModuleLabel()]))
+
     process.seedNtupler.mvaFileHltIter2IterL3MuonPixelSeeds_B                      = cms.FileInPath("RecoMuon/TrackerSeedGenerator/data/xgb_Run3_Iter0_PatatrackSeeds_barrel_v3.xml")
     process.seedNtupler.mvaFileHltIter2IterL3FromL1MuonPixelSeeds_B                = cms.FileInPath("RecoMuon/TrackerSeedGenerator/data/xgb_Run3_Iter0FromL1_PatatrackSeeds_barrel_v3.xml")
     process.seedNtupler.mvaFileHltIter2IterL3MuonPixelSeeds_E                      = cms.FileInPath("RecoMuon/TrackerSeedGenerator/data/xgb_Run3_Iter0_PatatrackSeeds_endcap_v3.xml")
@@ -97,7 +133,25 @@ def customizerFuncForMuonHLTSeedNtupler(process, newProcessName = "MYHLT", isDIG
       closeFileFast = cms.untracked.bool(False),
     )
 
-    if isDIGI:
+    if mergeWithNtupler:
+        # -- the muon sequences are already on process.mypath unless the ntupler runs the PPOnAA ones
+        # -- the seed ntuple parameters go to the ntupler (seedNtuple), no MuonHLTSeedNtupler module; its associators and track associations on demand
+        if not process.mypath.contains(process.HLTBeginSequence):
+            process.mypath.insert(0, process.HLTBeginSequence)
+        if not process.mypath.contains(process.hltIterL3OISeedsFromL2Muons):
+            process.mypath *= process.HLTL2muonrecoSequence*process.HLTL3muonrecoSequence
+        process.ntupler.seedNtuple = cms.untracked.PSet(**process.seedNtupler.parameters_())
+        del process.seedNtupler
+        if isDIGI:
+            process.seedAssociatorTask = cms.Task(process.hltSeedTrackAssociatorByHits, process.hltSeedAssociatorByHits, *trackAssociationModules)
+            if associatorBackend == "hits" and not process.mypath.contains(process.simHitTPAssocProducer):
+                process.seedAssociatorTask.add(process.simHitTPAssocProducer)
+            if hasattr(process, "hltTPClusterProducer"):
+                process.seedAssociatorTask.add(process.hltTPClusterProducer)
+            process.myendpath.associate(process.seedAssociatorTask)
+        if hasattr(process, "myseedpath"):
+            del process.myseedpath
+    elif isDIGI:
         process.myseedpath = cms.Path(process.HLTBeginSequence*
                                       #process.HLTL2muonrecoSequencePPOnAA*
                                       #process.HLTL3muonrecoPPOnAASequence*
@@ -105,9 +159,15 @@ def customizerFuncForMuonHLTSeedNtupler(process, newProcessName = "MYHLT", isDIG
                                       process.HLTL3muonrecoSequence*
                                       # process.hltTPClusterProducer*
                                       process.simHitTPAssocProducer*
-                                      process.hltTrackAssociatorByHits*
+                                      process.hltSeedTrackAssociatorByHits*
                                       process.hltSeedAssociatorByHits*
                                       process.seedNtupler)
+        # -- the association producers (and the cluster to TP map of the quick associator) run on demand, when asked for
+        if hasattr(process, "hltTPClusterProducer"):
+            trackAssociationModules.append(process.hltTPClusterProducer)
+        if trackAssociationModules:
+            process.seedTrackAssociationTask = cms.Task(*trackAssociationModules)
+            process.myseedpath.associate(process.seedTrackAssociationTask)
     else:
         process.myseedpath = cms.Path(process.HLTBeginSequence*
                                       #process.HLTL2muonrecoSequencePPOnAA*
@@ -116,4 +176,36 @@ def customizerFuncForMuonHLTSeedNtupler(process, newProcessName = "MYHLT", isDIG
                                       process.HLTL3muonrecoSequence*
                                       process.seedNtupler)
 
+    # -- schedule pruning, as in customizerFuncForMuonHLTNtupler: simHitTPAssocProducer is read only by the "hits" backend
+    # -- associators, the track associations already run on demand; dryRun: only print what would be removed
+    # -- mergeWithNtupler: simHitTPAssocProducer belongs to the ntupler schedule, on demand in seedAssociatorTask for the "hits" backend
+    seedPath = process.mypath if mergeWithNtupler else process.myseedpath
+    kept, removed = [], []
+    for label in ["HLTBeginSequence", "HLTL2muonrecoSequence", "HLTL3muonrecoSequence", "hltSeedTrackAssociatorByHits", "hltSeedAssociatorByHits", "seedNtupler"]:
+        if hasattr(process, label) and seedPath.contains(getattr(process, label)):
+            kept.append((label, "seedNtupler"))
+    if mergeWithNtupler:
+        kept.append(("ntupler", "seed ntuple filled by the ntupler (seedNtuple)"))
+        if isDIGI:
+            kept.append(("hltSeedTrackAssociatorByHits", "seedNtupler (on demand)"))
+            kept.append(("hltSeedAssociatorByHits", "seedNtupler (on demand)"))
+    for module in trackAssociationModules:
+        if module.label_() != "hltTPClusterProducer":
+            kept.append((module.label_(), "seedNtupler (on demand)"))
+    for assoLabel in sorted(set(sharedTrackAssociations)):
+        kept.append((assoLabel, "seedNtupler, shared with the ntupler"))
+    if mergeWithNtupler and isDIGI and associatorBackend == "hits":
+        kept.append(("simHitTPAssocProducer", "hltSeedTrackAssociatorByHits, hltSeedAssociatorByHits (on demand)"))
+    elif not mergeWithNtupler and hasattr(process, "simHitTPAssocProducer") and seedPath.contains(process.simHitTPAssocProducer):
+        if associatorBackend == "hits":
+            kept.append(("simHitTPAssocProducer", "hltSeedTrackAssociatorByHits, hltSeedAssociatorByHits"))
+        else:
+            removed.append(("simHitTPAssocProducer", "not read by the seed ntupler nor the quick associators"))
+
+    if not dryRun:
+        for label, reason in removed:
+            delattr(process, label)
+    else:
+        printSchedulePruning("customizerFuncForMuonHLTSeedNtupler", kept, removed, dryRun)
+
     return process
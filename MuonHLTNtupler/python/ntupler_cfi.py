@@ -8,6 +8,10 @@ ntuplerBase = cms.EDAnalyzer("MuonHLTNtupler",
 	offlineVertex     = cms.untracked.InputTag("offlinePrimaryVertices"),
 	offlineMuon       = cms.untracked.InputTag("muons"),
 	beamSpot          = cms.untracked.InputTag("hltOnlineBeamSpot"),
+	# -- miniAOD: pat::Muon (offlineMuon) and pat::TriggerObjectStandAlone (triggerObjects) read from MiniAOD, no HLT rerun, see test/Run_ntupler.py
+	# -- only the groups event, HLT, muon, muonMatch, L1Muon, gen are filled
+	miniAOD           = cms.untracked.bool(False),
+	triggerObjects    = cms.untracked.InputTag("slimmedPatTrigger"),
         hiCentralitySrc = cms.InputTag("hiCentrality"),
         hiCentralityBinSrc = cms.InputTag("centralityBin", "HFtowers"),
 
@@ -42,6 +46,10 @@ ntuplerBase = cms.EDAnalyzer("MuonHLTNtupler",
 	hltIterL3FromL1MuonTrimmedPixelVertices           = cms.untracked.InputTag("hltIterL3FromL1MuonTrimmedPixelVertices",             "", "MYHLT"),
 
 	doMVA  = cms.bool(True),
+
+	# -- track collections (trackCollectionNames) whose seeds are evaluated with the Iter2(FromL1)MuonPixelSeeds MVA, matched by name
+	mvaFromL2TrackCollections = cms.untracked.vstring("hltIter0IterL3MuonTrackAssociated", "hltIter2IterL3MuonTrackAssociated"),
+	mvaFromL1TrackCollections = cms.untracked.vstring("hltIter0IterL3FromL1MuonTrackAssociated", "hltIter2IterL3FromL1MuonTrackAssociated"),
 	doHI  = cms.bool(False),
 	doSeed = cms.bool(True),
 
@@ -56,6 +64,79 @@ ntuplerBase = cms.EDAnalyzer("MuonHLTNtupler",
         propagatorAny = cms.ESInputTag( "","SteppingHelixPropagatorAny" ),
         propagatorOpposite = cms.ESInputTag( "","hltESPSteppingHelixPropagatorOpposite" ),
 
+	# -- propagator and tracker geometry are cached per IOV; True also times the per-event rebuild (printed in endJob)
+	benchmarkESCache = cms.untracked.bool(False),
+
+	# -- packed offline muon ID and isolation working points, muon_selectorBits (bit layout: MuonHLTNtupler/interface/MuonSelectorBits.h)
+	doMuonSelectorBits = cms.untracked.bool(False),
+
+	# -- best match (index, dR) of each offline muon in the online collections: muon_<name>_idx, muon_<name>_dR
+	# -- collection: L1Muon, L2Muon, L3Muon, TkMuon, iterL3OI_inner, iterL3IOFromL2_inner, iterL3FromL2_inner, iterL3IOFromL1,
+	# --             iterL3MuonNoID, iterL3Muon, or HLTObj / MYHLTObj with filter = encoded filter tag ("label::process")
+	doMuonMatch = cms.untracked.bool(False),
+	muonMatch = cms.untracked.VPSet(
+		cms.PSet( name = cms.string("L1Muon"),         collection = cms.string("L1Muon"),         dR = cms.double(0.3), minPt = cms.double(-1.) ),
+		cms.PSet( name = cms.string("L2Muon"),         collection = cms.string("L2Muon"),         dR = cms.double(0.3), minPt = cms.double(-1.) ),
+		cms.PSet( name = cms.string("L3Muon"),         collection = cms.string("L3Muon"),         dR = cms.double(0.1), minPt = cms.double(-1.) ),
+		cms.PSet( name = cms.string("TkMuon"),         collection = cms.string("TkMuon"),         dR = cms.double(0.1), minPt = cms.double(-1.) ),
+		cms.PSet( name = cms.string("iterL3OI"),       collection = cms.string("iterL3OI_inner"),       dR = cms.double(0.1), minPt = cms.double(-1.) ),
+		cms.PSet( name = cms.string("iterL3IOFromL2"), collection = cms.string("iterL3IOFromL2_inner"), dR = cms.double(0.1), minPt = cms.double(-1.) ),
+		cms.PSet( name = cms.string("iterL3FromL2"),   collection = cms.string("iterL3FromL2_inner"),   dR = cms.double(0.1), minPt = cms.double(-1.) ),
+		cms.PSet( name = cms.string("iterL3IOFromL1"), collection = cms.string("iterL3IOFromL1"), dR = cms.double(0.1), minPt = cms.double(-1.) ),
+		cms.PSet( name = cms.string("iterL3MuonNoID"), collection = cms.string("iterL3MuonNoID"), dR = cms.double(0.1), minPt = cms.double(-1.) ),
+		cms.PSet( name = cms.string("iterL3Muon"),     collection = cms.string("iterL3Muon"),     dR = cms.double(0.1), minPt = cms.double(-1.) ),
+		# cms.PSet( name = cms.string("IsoMu24"),   collection = cms.string("HLTObj"),   filter = cms.string("hltL3crIsoL1sSingleMu22L1f0L2f10QL3f24QL3trkIsoFiltered0p07::HLT"),   dR = cms.double(0.1), minPt = cms.double(-1.) ),
+		# cms.PSet( name = cms.string("myIsoMu24"), collection = cms.string("MYHLTObj"), filter = cms.string("hltL3crIsoL1sSingleMu22L1f0L2f10QL3f24QL3trkIsoFiltered0p07::MYHLT"), dR = cms.double(0.1), minPt = cms.double(-1.) ),
+	),
+
+	# -- HLT menu variants rerun in the same job (addMenuVariant in customizerForMuonHLTNtupler.py): vec_<name>_firedTrigger, vec_<name>_filterName,
+	# -- vec_<name>_HLTObj_pt/eta/phi (paths and filters ending with suffix, stored without it) and vec_<name>_iterL3Muon_pt/eta/phi (empty iterL3Muon: none)
+	# -- cms.PSet( name = cms.string("menuB"), suffix = cms.string("MenuB"), triggerResults = cms.InputTag("TriggerResults::MYHLT"),
+	# --           triggerEvent = cms.InputTag("hltTriggerSummaryAOD::MYHLT"), iterL3Muon = cms.InputTag("hltIterL3MuonsMenuB::MYHLT") )
+	menuVariants = cms.untracked.VPSet(),
+
+	# -- friend tree: only these branch groups (+ isRealData, runNum, lumiBlockNum, eventNum) are written, empty = full ntuple
+	# -- groups: event, HLT, MYHLT, variants, muon, muonMatch, HLTMuon, L1Muon, iterL3, tracks, gen, TP
+	# -- friendReference: existing ntuple of the same input, every written (run, lumi, event) has to be in it (any order)
+	# -- and every one of its events has to be written: the job fails otherwise (one reference per job when split)
+	friendBranchGroups = cms.untracked.vstring(),
+	friendReference = cms.untracked.string(""),
+	friendReferenceTree = cms.untracked.string("ntupler/ntuple"),
+
+	# -- deterministic sampling: only a fraction of the events, chosen by a hash of (run, lumi, event, sampleSeed), is filled
+	# -- same events in every re-run and job splitting; fraction, seed and event counts in the metadata tree
+	sampleFraction = cms.untracked.double(1.),
+	sampleSeed = cms.untracked.uint32(0),
+
+	# -- "lumi" tree: per lumi section event counts, <truePU>, <instLumi>, <nVertex>, L1 muon multiplicities and trigger accept counts
+	doLumiSummary = cms.untracked.bool(True),
+
+	# -- per-event limits of the expensive sections, 0: no limit; flagged events: budgetOverflow bits (budgetBit in MuonHLTNtupler.h), summary in endJob
+	# -- maxTracks / maxTPs: loops of each track collection / TP collection truncated; maxEventTime (ms): later sections skipped
+	eventBudget = cms.untracked.PSet(
+		maxTracks = cms.uint32(0),
+		maxTPs = cms.uint32(0),
+		maxEventTime = cms.double(0.),
+	),
+
+	# -- efficiency histograms filled in the job (directory "efficiency"): h_<name>_den/num_<pt, eta, phi, nVertex>, h_<name>_ptRes, h_<name>_dR
+	# -- denominator: offline muons with |eta| < maxAbsEta passing all selection bits (names in MuonSelectorBits.h), numerator: matched in muonMatch <match>
+	# -- minPt: offline pT cut for all but the pt histograms; writeNtuple = False: no ntuple tree, histograms only (requires doMuonMatch), only their inputs filled
+	writeNtuple = cms.untracked.bool(True),
+	doEfficiencyHist = cms.untracked.bool(False),
+	efficiencyHist = cms.untracked.VPSet(
+		cms.PSet( name = cms.string("L1MuonOverTight"),    match = cms.string("L1Muon"),     selection = cms.vstring("Tight", "PFIsoTight"), minPt = cms.double(26.), maxAbsEta = cms.double(2.4) ),
+		cms.PSet( name = cms.string("L2MuonOverTight"),    match = cms.string("L2Muon"),     selection = cms.vstring("Tight", "PFIsoTight"), minPt = cms.double(26.), maxAbsEta = cms.double(2.4) ),
+		cms.PSet( name = cms.string("L3MuonOverTight"),    match = cms.string("L3Muon"),     selection = cms.vstring("Tight", "PFIsoTight"), minPt = cms.double(26.), maxAbsEta = cms.double(2.4) ),
+		cms.PSet( name = cms.string("iterL3MuonOverTight"), match = cms.string("iterL3Muon"), selection = cms.vstring("Tight", "PFIsoTight"), minPt = cms.double(26.), maxAbsEta = cms.double(2.4) ),
+	),
+	efficiencyBins = cms.untracked.PSet(
+		pt      = cms.vdouble(2, 18, 22, 24, 26, 30, 40, 50, 60, 120, 200, 300, 500),
+		eta     = cms.vdouble(-2.4, -2.1, -1.6, -1.2, -0.9, -0.3, -0.2, 0, 0.2, 0.3, 0.9, 1.2, 1.6, 2.1, 2.4),
+		phi     = cms.vdouble(-3.1416, -2.8798, -2.3562, -1.8326, -1.3090, -0.7854, -0.2618, 0.2618, 0.7854, 1.3090, 1.8326, 2.3562, 2.8798, 3.1416),
+		nVertex = cms.vdouble([ 2.5 + 2*i for i in range(30) ]),
+	),
+
 	# -- generator information
 	PUSummaryInfo = cms.untracked.InputTag("addPileupInfo"),
 	genEventInfo = cms.untracked.InputTag("generator"),
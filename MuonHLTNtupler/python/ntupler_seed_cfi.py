@@ -24,4 +24,41 @@ seedNtuplerBase = cms.EDAnalyzer("MuonHLTSeedNtupler",
 	hltIter0IterL3FromL1MuonTrack = cms.untracked.InputTag("hltIter0IterL3FromL1MuonTrackSelectionHighPurity",       "", "MYHLT"),
 	hltIter2IterL3FromL1MuonTrack = cms.untracked.InputTag("hltIter2IterL3FromL1MuonTrackSelectionHighPurity",       "", "MYHLT"),
 	hltIter3IterL3FromL1MuonTrack = cms.untracked.InputTag("hltIter3IterL3FromL1MuonTrackSelectionHighPurity",       "", "MYHLT"),
+
+	# -- reco::RecoToSimCollection of each track collection produced upstream (e.g. TrackAssociatorEDProducer)
+	# -- empty: the association is computed in the module with the "associator"
+	hltIterL3OIMuonTrackAssociation          = cms.untracked.InputTag(""),
+	hltIter0IterL3MuonTrackAssociation       = cms.untracked.InputTag(""),
+	hltIter2IterL3MuonTrackAssociation       = cms.untracked.InputTag(""),
+	hltIter3IterL3MuonTrackAssociation       = cms.untracked.InputTag(""),
+	hltIter0IterL3FromL1MuonTrackAssociation = cms.untracked.InputTag(""),
+	hltIter2IterL3FromL1MuonTrackAssociation = cms.untracked.InputTag(""),
+	hltIter3IterL3FromL1MuonTrackAssociation = cms.untracked.InputTag(""),
+
+	# -- True: one NTEvent entry per event with the seeds of each iteration as vector branches (no NThltIter* trees;
+	# -- NtupleAnalyzer/SeedMVA tools: Set_Columnar(kTRUE))
+	doColumnar = cms.bool(False),
+
+	# -- True: also write <binaryExportPrefix>_<iteration>.bin per seed collection (fixed-width records for MVA training)
+	doBinaryExport = cms.bool(False),
+	binaryExportPrefix = cms.string("seedTraining"),
+
+	# -- True: seed-track links are also looked up in the former std::map<tmpTSOD> and the disagreements are counted (summary in endJob)
+	validateSeedTrackLink = cms.bool(False),
+
+	# -- fraction of seeds not matched to a true muon track kept per iteration (1: no downsampling)
+	# -- the keep decision is a hash of (run, event, iteration, seed index); kept seeds get weight = 1/fraction
+	unmatchedSeedKeepFraction = cms.PSet(
+		hltIterL3OI    = cms.double(1.0),
+		hltIter0       = cms.double(1.0),
+		hltIter2       = cms.double(1.0),
+		hltIter3       = cms.double(1.0),
+		hltIter0FromL1 = cms.double(1.0),
+		hltIter2FromL1 = cms.double(1.0),
+		hltIter3FromL1 = cms.double(1.0),
+	),
+
+	# -- per-event seed budget: only the first maxSeeds kept seeds of each collection are associated and filled (0: no limit)
+	# -- truncated collections: bit i of seedBudgetOverflow (i: collection order in beginJob), counts printed in endJob
+	maxSeeds = cms.uint32(0),
 )
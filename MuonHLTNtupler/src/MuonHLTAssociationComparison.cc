@@ -0,0 +1,149 @@
+// -- comparison of track to TP association products on the same events, see the header
+
+#include "MuonHLTTool/MuonHLTNtupler/interface/MuonHLTAssociationComparison.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+
+MuonHLTAssociationComparison::MuonHLTAssociationComparison(const edm::ParameterSet& iConfig):
+trackCollectionNames_(iConfig.getUntrackedParameter<std::vector<std::string>>("trackCollectionNames")),
+qualityTolerance_(iConfig.getUntrackedParameter<double>("qualityTolerance", 1e-6)),
+nEvent_(0)
+{
+  usesResource("TFileService");
+
+  std::vector<edm::InputTag> trackCollectionLabels = iConfig.getUntrackedParameter<std::vector<edm::InputTag>>("trackCollectionLabels");
+  std::vector<edm::InputTag> refLabels  = iConfig.getUntrackedParameter<std::vector<edm::InputTag>>("referenceAssociations");
+  std::vector<edm::InputTag> testLabels = iConfig.getUntrackedParameter<std::vector<edm::InputTag>>("testAssociations");
+  if( trackCollectionLabels.size() != trackCollectionNames_.size() || refLabels.size() != trackCollectionNames_.size() || testLabels.size() != trackCollectionNames_.size() )
+    throw cms::Exception("ConfigurationError") << "MuonHLTAssociationComparison: one track collection, reference and test association per name";
+
+  for( auto ic=0U; ic<trackCollectionNames_.size(); ++ic ) {
+    trackCollectionTokens_.push_back( consumes<edm::View<reco::Track>>(trackCollectionLabels[ic]) );
+    refRecoToSimTokens_.push_back(  consumes<reco::RecoToSimCollection>(refLabels[ic]) );
+    refSimToRecoTokens_.push_back(  consumes<reco::SimToRecoCollection>(refLabels[ic]) );
+    testRecoToSimTokens_.push_back( consumes<reco::RecoToSimCollection>(testLabels[ic]) );
+    testSimToRecoTokens_.push_back( consumes<reco::SimToRecoCollection>(testLabels[ic]) );
+  }
+
+  agreements_.assign( trackCollectionNames_.size(), agreement() );
+}
+
+void MuonHLTAssociationComparison::analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup)
+{
+  nEvent_++;
+
+  for( auto ic=0U; ic<trackCollectionNames_.size(); ++ic ) {
+    agreement& A = agreements_[ic];
+
+    edm::Handle<edm::View<reco::Track>> trkHandle;
+    edm::Handle<reco::RecoToSimCollection> refRecSim, testRecSim;
+    edm::Handle<reco::SimToRecoCollection> refSimRec, testSimRec;
+    const bool hasRef  = iEvent.getByToken(refRecoToSimTokens_[ic], refRecSim)   && iEvent.getByToken(refSimToRecoTokens_[ic], refSimRec);
+    const bool hasTest = iEvent.getByToken(testRecoToSimTokens_[ic], testRecSim) && iEvent.getByToken(testSimToRecoTokens_[ic], testSimRec);
+    if( !iEvent.getByToken(trackCollectionTokens_[ic], trkHandle) || (!hasRef && !hasTest) )
+      continue;
+    if( !hasRef || !hasTest ) {
+      A.nMissing++;
+      continue;
+    }
+    A.nEvent++;
+
+    // -- RecoToSim: the TPs of each track, in the order of the association (best first)
+    for( auto j=0U; j<trkHandle->size(); ++j ) {
+      A.nTrack++;
+      auto refFound  = refRecSim->find(trkHandle->refAt(j));
+      auto testFound = testRecSim->find(trkHandle->refAt(j));
+      const unsigned nRef  = (refFound  == refRecSim->end())  ? 0 : refFound->val.size();
+      const unsigned nTest = (testFound == testRecSim->end()) ? 0 : testFound->val.size();
+
+      bool sameTP = nRef == nTest;
+      double maxDiff = 0.;
+      for( auto k=0U; sameTP && k<nRef; ++k ) {
+        sameTP = refFound->val[k].first.key() == testFound->val[k].first.key();
+        maxDiff = std::max(maxDiff, fabs(refFound->val[k].second - testFound->val[k].second));
+      }
+
+      if( !sameTP )
+        A.nTrackDiffTP++;
+      else if( maxDiff > qualityTolerance_ )
+        A.nTrackDiffQuality++;
+      else
+        A.nTrackSame++;
+      A.maxQualityDiff = std::max(A.maxQualityDiff, maxDiff);
+    }
+
+    // -- SimToReco: the tracks of each TP, TPs in only one of the two products count as different
+    for( const auto& refEntry : *refSimRec ) {
+      A.nTP++;
+      auto testFound = testSimRec->find(refEntry.key);
+      if( testFound == testSimRec->end() || testFound->val.size() != refEntry.val.size() )
+        continue;
+
+      bool same = true;
+      for( auto k=0U; same && k<refEntry.val.size(); ++k )
+        same = refEntry.val[k].first.key() == testFound->val[k].first.key() &&
+               fabs(refEntry.val[k].second - testFound->val[k].second) <= qualityTolerance_;
+      if( same )
+        A.nTPSame++;
+    }
+    for( const auto& testEntry : *testSimRec ) {
+      if( refSimRec->find(testEntry.key) == refSimRec->end() )
+        A.nTP++;
+    }
+  }
+}
+
+void MuonHLTAssociationComparison::endJob()
+{
+  if( nEvent_ == 0 )
+    return;
+
+  // -- summary tree: one entry per collection
+  edm::Service<TFileService> fs;
+  TTree* NTSummary = fs->make<TTree>("NTSummary","NTSummary");
+
+  char collection[128];
+  unsigned long nEvent, nMissing, nTrack, nTrackSame, nTrackDiffTP, nTrackDiffQuality, nTP, nTPSame;
+  double maxQualityDiff;
+  NTSummary->Branch("collection", collection, "collection/C");
+  NTSummary->Branch("nEvent", &nEvent, "nEvent/l");
+  NTSummary->Branch("nMissing", &nMissing, "nMissing/l");
+  NTSummary->Branch("nTrack", &nTrack, "nTrack/l");
+  NTSummary->Branch("nTrackSame", &nTrackSame, "nTrackSame/l");
+  NTSummary->Branch("nTrackDiffTP", &nTrackDiffTP, "nTrackDiffTP/l");
+  NTSummary->Branch("nTrackDiffQuality", &nTrackDiffQuality, "nTrackDiffQuality/l");
+  NTSummary->Branch("nTP", &nTP, "nTP/l");
+  NTSummary->Branch("nTPSame", &nTPSame, "nTPSame/l");
+  NTSummary->Branch("maxQualityDiff", &maxQualityDiff, "maxQualityDiff/D");
+
+  cout << "[MuonHLTAssociationComparison::endJob] " << nEvent_ << " events, test vs reference association" << endl;
+  for( auto ic=0U; ic<trackCollectionNames_.size(); ++ic ) {
+    const agreement& A = agreements_[ic];
+    snprintf(collection, sizeof(collection), "%s", trackCollectionNames_[ic].c_str());
+    nEvent            = A.nEvent;
+    nMissing          = A.nMissing;
+    nTrack            = A.nTrack;
+    nTrackSame        = A.nTrackSame;
+    nTrackDiffTP      = A.nTrackDiffTP;
+    nTrackDiffQuality = A.nTrackDiffQuality;
+    nTP               = A.nTP;
+    nTPSame           = A.nTPSame;
+    maxQualityDiff    = A.maxQualityDiff;
+    NTSummary->Fill();
+
+    cout << "  " << std::left << std::setw(45) << trackCollectionNames_[ic]
+         << " tracks: same " << nTrackSame << "/" << nTrack << ", different TP " << nTrackDiffTP << ", different quality " << nTrackDiffQuality
+         << "; TPs: same " << nTPSame << "/" << nTP << "; max. |quality diff.| " << maxQualityDiff;
+    if( nMissing > 0 )
+      cout << "; " << nMissing << " events with one product only";
+    cout << endl;
+  }
+}
+
+DEFINE_FWK_MODULE(MuonHLTAssociationComparison);
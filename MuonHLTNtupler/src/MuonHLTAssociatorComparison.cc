@@ -0,0 +1,191 @@
+// -- comparison of track to TP associators on the same events, see the header
+
+#include "MuonHLTTool/MuonHLTNtupler/interface/MuonHLTAssociatorComparison.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+
+MuonHLTAssociatorComparison::MuonHLTAssociatorComparison(const edm::ParameterSet& iConfig):
+associatorNames_(iConfig.getUntrackedParameter<std::vector<std::string>>("associatorNames")),
+trackCollectionNames_(iConfig.getUntrackedParameter<std::vector<std::string>>("trackCollectionNames")),
+trackingParticleToken_(consumes<TrackingParticleCollection>(iConfig.getUntrackedParameter<edm::InputTag>("trackingParticle"))),
+nEvent_(0),
+NTTiming_(nullptr),
+eventNum_(0)
+{
+  usesResource("TFileService");
+
+  std::vector<edm::InputTag> associatorLabels = iConfig.getUntrackedParameter<std::vector<edm::InputTag>>("associators");
+  std::vector<edm::InputTag> trackCollectionLabels = iConfig.getUntrackedParameter<std::vector<edm::InputTag>>("trackCollectionLabels");
+  if( associatorNames_.size() != associatorLabels.size() || associatorLabels.size() < 2 )
+    throw cms::Exception("ConfigurationError") << "MuonHLTAssociatorComparison: at least two associators, one name each";
+  if( trackCollectionNames_.size() != trackCollectionLabels.size() )
+    throw cms::Exception("ConfigurationError") << "MuonHLTAssociatorComparison: one name per track collection";
+
+  for( const auto& label : associatorLabels )
+    associatorTokens_.push_back( consumes<reco::TrackToTrackingParticleAssociator>(label) );
+  for( const auto& label : trackCollectionLabels )
+    trackCollectionTokens_.push_back( consumes<edm::View<reco::Track>>(label) );
+
+  agreements_.assign( trackCollectionNames_.size(), std::vector<agreement>(associatorNames_.size()) );
+  time_.assign( trackCollectionNames_.size()*associatorNames_.size(), 0. );
+  nTrack_.assign( trackCollectionNames_.size(), 0 );
+}
+
+void MuonHLTAssociatorComparison::beginJob()
+{
+  edm::Service<TFileService> fs;
+
+  NTTiming_ = fs->make<TTree>("NTTiming","NTTiming");
+  NTTiming_->Branch("eventNum", &eventNum_, "eventNum/l");
+  for( auto ic=0U; ic<trackCollectionNames_.size(); ++ic ) {
+    NTTiming_->Branch(("nTrack_"+trackCollectionNames_[ic]).c_str(), &nTrack_[ic], ("nTrack_"+trackCollectionNames_[ic]+"/I").c_str());
+    for( auto ia=0U; ia<associatorNames_.size(); ++ia ) {
+      std::string name = "time_"+associatorNames_[ia]+"_"+trackCollectionNames_[ic];
+      NTTiming_->Branch(name.c_str(), &time_[ic*associatorNames_.size()+ia], (name+"/F").c_str());
+    }
+  }
+
+  for( auto ic=0U; ic<trackCollectionNames_.size(); ++ic ) {
+    for( auto ia=1U; ia<associatorNames_.size(); ++ia ) {
+      std::string name = "h_qualityDiff_"+associatorNames_[ia]+"_"+trackCollectionNames_[ic];
+      agreements_[ic][ia].h_qualityDiff = fs->make<TH1D>(name.c_str(), name.c_str(), 200, -1., 1.);
+    }
+  }
+}
+
+void MuonHLTAssociatorComparison::analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup)
+{
+  eventNum_ = iEvent.id().event();
+  nEvent_++;
+
+  edm::Handle<TrackingParticleCollection> TPCollection;
+  if( !iEvent.getByToken(trackingParticleToken_, TPCollection) )
+    return;
+
+  std::vector<edm::Handle<reco::TrackToTrackingParticleAssociator>> associators(associatorTokens_.size());
+  for( auto ia=0U; ia<associatorTokens_.size(); ++ia )
+    iEvent.getByToken(associatorTokens_[ia], associators[ia]);
+
+  const auto nAsso = associatorNames_.size();
+  for( auto ic=0U; ic<trackCollectionTokens_.size(); ++ic ) {
+    nTrack_[ic] = 0;
+    for( auto ia=0U; ia<nAsso; ++ia )
+      time_[ic*nAsso+ia] = 0.;
+
+    edm::Handle<edm::View<reco::Track>> trkHandle;
+    if( !iEvent.getByToken(trackCollectionTokens_[ic], trkHandle) )
+      continue;
+    nTrack_[ic] = trkHandle->size();
+
+    // -- best TP and its quality per track, for each associator
+    std::vector<std::vector<int>> bestTP(nAsso, std::vector<int>(trkHandle->size(), -1));
+    std::vector<std::vector<double>> bestQuality(nAsso, std::vector<double>(trkHandle->size(), 0.));
+    for( auto ia=0U; ia<nAsso; ++ia ) {
+      if( !associators[ia].isValid() )
+        continue;
+
+      auto start = std::chrono::steady_clock::now();
+      reco::RecoToSimCollection recSimColl = associators[ia]->associateRecoToSim(trkHandle, TPCollection);
+      double dt = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      time_[ic*nAsso+ia] = 1e3*dt;
+      agreements_[ic][ia].time += dt;
+
+      for( auto j=0U; j<trkHandle->size(); ++j ) {
+        auto TPfound = recSimColl.find(trkHandle->refAt(j));
+        if( TPfound != recSimColl.end() && !TPfound->val.empty() ) {
+          bestTP[ia][j]      = TPfound->val[0].first.key();
+          bestQuality[ia][j] = TPfound->val[0].second;
+        }
+      }
+    }
+
+    for( auto ia=0U; ia<nAsso; ++ia ) {
+      agreement& A = agreements_[ic][ia];
+      for( auto j=0U; j<trkHandle->size(); ++j ) {
+        A.nTrack++;
+        const bool matched = bestTP[ia][j] >= 0, refMatched = bestTP[0][j] >= 0;
+        if( matched )
+          A.nMatched++;
+        if( ia == 0 )
+          continue;
+
+        if( matched && refMatched ) {
+          if( bestTP[ia][j] == bestTP[0][j] ) {
+            const double diff = bestQuality[ia][j] - bestQuality[0][j];
+            A.nSameTP++;
+            A.sumQualityDiff += diff;
+            A.sumAbsQualityDiff += fabs(diff);
+            A.h_qualityDiff->Fill(diff);
+          }
+          else
+            A.nDiffTP++;
+        }
+        else if( matched )
+          A.nOnlyThis++;
+        else if( refMatched )
+          A.nOnlyRef++;
+      }
+    }
+  }
+
+  NTTiming_->Fill();
+}
+
+void MuonHLTAssociatorComparison::endJob()
+{
+  if( nEvent_ == 0 )
+    return;
+
+  // -- summary tree: one entry per (collection, associator)
+  edm::Service<TFileService> fs;
+  TTree* NTSummary = fs->make<TTree>("NTSummary","NTSummary");
+
+  char collection[128], associator[128];
+  unsigned long nTrack, nMatched, nSameTP, nDiffTP, nOnlyThis, nOnlyRef;
+  double meanQualityDiff, meanAbsQualityDiff, timePerEvent;
+  NTSummary->Branch("collection", collection, "collection/C");
+  NTSummary->Branch("associator", associator, "associator/C");
+  NTSummary->Branch("nTrack", &nTrack, "nTrack/l");
+  NTSummary->Branch("nMatched", &nMatched, "nMatched/l");
+  NTSummary->Branch("nSameTP", &nSameTP, "nSameTP/l");
+  NTSummary->Branch("nDiffTP", &nDiffTP, "nDiffTP/l");
+  NTSummary->Branch("nOnlyThis", &nOnlyThis, "nOnlyThis/l");
+  NTSummary->Branch("nOnlyRef", &nOnlyRef, "nOnlyRef/l");
+  NTSummary->Branch("meanQualityDiff", &meanQualityDiff, "meanQualityDiff/D");
+  NTSummary->Branch("meanAbsQualityDiff", &meanAbsQualityDiff, "meanAbsQualityDiff/D");
+  NTSummary->Branch("timePerEvent", &timePerEvent, "timePerEvent/D"); // -- ms
+
+  cout << "[MuonHLTAssociatorComparison::endJob] " << nEvent_ << " events, reference: " << associatorNames_[0] << endl;
+  for( auto ic=0U; ic<trackCollectionNames_.size(); ++ic ) {
+    for( auto ia=0U; ia<associatorNames_.size(); ++ia ) {
+      const agreement& A = agreements_[ic][ia];
+      snprintf(collection, sizeof(collection), "%s", trackCollectionNames_[ic].c_str());
+      snprintf(associator, sizeof(associator), "%s", associatorNames_[ia].c_str());
+      nTrack    = A.nTrack;
+      nMatched  = A.nMatched;
+      nSameTP   = A.nSameTP;
+      nDiffTP   = A.nDiffTP;
+      nOnlyThis = A.nOnlyThis;
+      nOnlyRef  = A.nOnlyRef;
+      meanQualityDiff    = A.nSameTP > 0 ? A.sumQualityDiff/A.nSameTP : 0.;
+      meanAbsQualityDiff = A.nSameTP > 0 ? A.sumAbsQualityDiff/A.nSameTP : 0.;
+      timePerEvent = 1e3*A.time/nEvent_;
+      NTSummary->Fill();
+
+      cout << "  " << std::left << std::setw(45) << trackCollectionNames_[ic] << std::setw(10) << associatorNames_[ia]
+           << " matched " << nMatched << "/" << nTrack << std::fixed << std::setprecision(3) << ", " << timePerEvent << " ms/event (associateRecoToSim)";
+      if( ia > 0 )
+        cout << ", same TP " << nSameTP << ", different TP " << nDiffTP << ", only this " << nOnlyThis << ", only ref. " << nOnlyRef
+             << ", <quality diff.> " << meanQualityDiff << ", <|quality diff.|> " << meanAbsQualityDiff;
+      cout << endl;
+    }
+  }
+}
+
+DEFINE_FWK_MODULE(MuonHLTAssociatorComparison);
@@ -61,9 +61,14 @@
 
 
 #include <map>
+#include <memory>
 #include <string>
 #include <iomanip>
+#include <chrono>
+#include <tuple>
+#include <algorithm>
 #include "TTree.h"
+#include "TFile.h"
 
 using namespace std;
 using namespace reco;
@@ -76,13 +81,38 @@ doHI(iConfig.getParameter<bool>("doHI")),
 doSeed(iConfig.getParameter<bool>("doSeed")),
 DebugMode(iConfig.getParameter<bool>("DebugMode")),
 
+friendReference_(iConfig.getUntrackedParameter<std::string>("friendReference", "")),
+friendReferenceTree_(iConfig.getUntrackedParameter<std::string>("friendReferenceTree", "ntupler/ntuple")),
+friendCheck_(false),
+nFriendReference_(0),
+nFilled_(0),
+sampleFraction_(iConfig.getUntrackedParameter<double>("sampleFraction", 1.)),
+sampleSeed_(iConfig.getUntrackedParameter<unsigned int>("sampleSeed", 0)),
+nEventProcessed_(0),
+nEventSampled_(0),
+maxTracks_(iConfig.getUntrackedParameter<edm::ParameterSet>("eventBudget").getParameter<unsigned int>("maxTracks")),
+maxTPs_(iConfig.getUntrackedParameter<edm::ParameterSet>("eventBudget").getParameter<unsigned int>("maxTPs")),
+maxEventTime_(iConfig.getUntrackedParameter<edm::ParameterSet>("eventBudget").getParameter<double>("maxEventTime")),
+budgetOverflow_(0),
+nBudgetOverflow_{},
+doLumiSummary_(iConfig.getUntrackedParameter<bool>("doLumiSummary", true)),
+lumiSummary_(nullptr),
+lumiTree_(nullptr),
+miniAOD_(iConfig.getUntrackedParameter<bool>("miniAOD", false)),
+
 propSetup_(iConfig, consumesCollector()),
 trackerGeometryToken_(esConsumes<TrackerGeometry, TrackerDigiGeometryRecord>()),
+tracker_(nullptr),
+benchmarkESCache_(iConfig.getUntrackedParameter<bool>("benchmarkESCache", false)),
+nESCacheEvent_(0),
+nESCacheRebuild_(0),
+timeESCached_(0.),
+timeESRebuild_(0.),
 
 associatorToken(consumes<reco::TrackToTrackingParticleAssociator>(iConfig.getUntrackedParameter<edm::InputTag>("associator"))),
 trackingParticleToken(consumes<TrackingParticleCollection>(iConfig.getUntrackedParameter<edm::InputTag>("trackingParticle"))),
 t_beamSpot_          ( consumes< reco::BeamSpot >                         (iConfig.getUntrackedParameter<edm::InputTag>("beamSpot"     )) ),
-t_offlineMuon_       ( consumes< std::vector<reco::Muon> >                (iConfig.getUntrackedParameter<edm::InputTag>("offlineMuon"       )) ),
+t_offlineMuon_       ( consumes< edm::View<reco::Muon> >                  (iConfig.getUntrackedParameter<edm::InputTag>("offlineMuon"       )) ),
 t_offlineVertex_     ( consumes< reco::VertexCollection >                 (iConfig.getUntrackedParameter<edm::InputTag>("offlineVertex"     )) ),
 t_triggerResults_    ( consumes< edm::TriggerResults >                    (iConfig.getUntrackedParameter<edm::InputTag>("triggerResults"    )) ),
 t_triggerEvent_      ( consumes< trigger::TriggerEvent >                  (iConfig.getUntrackedParameter<edm::InputTag>("triggerEvent"      )) ),
@@ -128,7 +158,11 @@ t_genl1MatchesByQQuality_  ( consumes< edm::ValueMap<int> >
 t_genl1MatchesByQDeltaR_   ( consumes< edm::ValueMap<float> >                            (iConfig.getParameter<edm::InputTag>("genl1MatchesByQDeltaR"))),
 CentralityTag_(consumes<reco::Centrality>(iConfig.getParameter<edm::InputTag>("hiCentralitySrc"))),
 CentralityBinTag_(consumes<int>(iConfig.getParameter<edm::InputTag>("hiCentralityBinSrc"))),
-bs(0)
+bs(0),
+doMuonMatch_(iConfig.getUntrackedParameter<bool>("doMuonMatch", false)),
+writeNtuple_(iConfig.getUntrackedParameter<bool>("writeNtuple", true)),
+doEfficiencyHist_(iConfig.getUntrackedParameter<bool>("doEfficiencyHist", false)),
+doMuonSelectorBits_(iConfig.getUntrackedParameter<bool>("doMuonSelectorBits", false))
 {
   trackCollectionNames_   = iConfig.getUntrackedParameter<std::vector<std::string>   >("trackCollectionNames");
   trackCollectionLabels_  = iConfig.getUntrackedParameter<std::vector<edm::InputTag> >("trackCollectionLabels");
@@ -145,6 +179,99 @@ bs(0)
     tpTemplates_.push_back(  new tpTemplate()  );
   }
 
+  if( doMuonMatch_ ) {
+    for( const auto& matchConf : iConfig.getUntrackedParameter<std::vector<edm::ParameterSet> >("muonMatch") )
+      add_muonMatch(matchConf);
+  }
+
+  if( doEfficiencyHist_ ) {
+    if( !doMuonMatch_ )
+      throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: doEfficiencyHist requires doMuonMatch (numerators from the muon matches)";
+
+    const edm::ParameterSet binConf = iConfig.getUntrackedParameter<edm::ParameterSet>("efficiencyBins");
+    efficiencyBins_[0] = binConf.getParameter<std::vector<double> >("pt");
+    efficiencyBins_[1] = binConf.getParameter<std::vector<double> >("eta");
+    efficiencyBins_[2] = binConf.getParameter<std::vector<double> >("phi");
+    efficiencyBins_[3] = binConf.getParameter<std::vector<double> >("nVertex");
+
+    for( const auto& histConf : iConfig.getUntrackedParameter<std::vector<edm::ParameterSet> >("efficiencyHist") )
+      add_efficiencyHist(histConf);
+  }
+  if( !writeNtuple_ && !doEfficiencyHist_ )
+    throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: writeNtuple = False without doEfficiencyHist";
+
+  for( const auto& variantConf : iConfig.getUntrackedParameter<std::vector<edm::ParameterSet> >("menuVariants", std::vector<edm::ParameterSet>()) ) {
+    menuVariant V;
+    V.name   = variantConf.getParameter<std::string>("name");
+    V.suffix = variantConf.getParameter<std::string>("suffix");
+    V.triggerResultsToken = consumes< edm::TriggerResults >(variantConf.getParameter<edm::InputTag>("triggerResults"));
+    V.triggerEventToken   = consumes< trigger::TriggerEvent >(variantConf.getParameter<edm::InputTag>("triggerEvent"));
+    const edm::InputTag iterL3MuonTag = variantConf.getParameter<edm::InputTag>("iterL3Muon");
+    V.hasIterL3Muon = !iterL3MuonTag.label().empty();
+    if( V.hasIterL3Muon )
+      V.iterL3MuonToken = consumes< std::vector<reco::Muon> >(iterL3MuonTag);
+    menuVariants_.push_back(V);
+  }
+
+  const std::set<std::string> knownGroups = { "event", "HLT", "MYHLT", "variants", "muon", "muonMatch", "HLTMuon", "L1Muon", "iterL3", "tracks", "gen", "TP" };
+  for( const auto& group : iConfig.getUntrackedParameter<std::vector<std::string> >("friendBranchGroups", std::vector<std::string>()) ) {
+    if( !knownGroups.count(group) )
+      throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: unknown branch group " << group;
+    branchGroups_.insert(group);
+  }
+  if( !(sampleFraction_ > 0. && sampleFraction_ <= 1.) )
+    throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: sampleFraction " << sampleFraction_ << " not in (0, 1]";
+
+  if( !branchGroups_.empty() && !writeNtuple_ )
+    throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: friendBranchGroups requires writeNtuple";
+
+  if( miniAOD_ ) {
+    t_triggerObject_ = consumes< std::vector<pat::TriggerObjectStandAlone> >(iConfig.getUntrackedParameter<edm::InputTag>("triggerObjects"));
+    miniAODProcess_  = iConfig.getUntrackedParameter<edm::InputTag>("triggerResults").process();
+
+    // -- rerun and RAW-only collections are not in MiniAOD: their groups are never written
+    const std::set<std::string> miniAODGroups = { "event", "HLT", "muon", "muonMatch", "L1Muon", "gen" };
+    for( const auto& group : branchGroups_ ) {
+      if( !miniAODGroups.count(group) )
+        throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: branch group " << group << " is not available with miniAOD";
+    }
+    for( const auto& M : muonMatches_ ) {
+      if( !miniAODGroups.count(M.group) )
+        throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: muonMatch " << M.name << " (" << M.group << ") is not available with miniAOD";
+    }
+    if( !menuVariants_.empty() )
+      throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: menuVariants are not available with miniAOD";
+
+    if( branchGroups_.empty() ) {
+      branchGroups_ = miniAODGroups;
+      if( !doMuonMatch_ )
+        branchGroups_.erase("muonMatch");
+    }
+  }
+
+  if( branchGroups_.count("muonMatch") && !doMuonMatch_ )
+    throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: branch group muonMatch requires doMuonMatch";
+
+  fillGroups_ = branchGroups_;
+  if( branchGroups_.count("tracks") )
+    fillGroups_.insert("iterL3");
+  if( branchGroups_.count("muonMatch") ) {
+    fillGroups_.insert("muon");
+    for( const auto& M : muonMatches_ )
+      fillGroups_.insert(M.group);
+  }
+  // -- the lumi summary inputs of the groups a friend tree does not fill are read by Fill_LumiSummaryInputs, no group forced on
+
+  // -- histograms only (writeNtuple = False): only what Fill_EfficiencyHist reads is filled, nVertex (event), the offline muons
+  // -- and their matches (muonMatch and the groups of the matched collections); the gen weight is read there directly
+  fillAllGroups_ = branchGroups_.empty();
+  if( !writeNtuple_ ) {
+    fillAllGroups_ = false;
+    fillGroups_ = { "event", "muon", "muonMatch" };
+    for( const auto& M : muonMatches_ )
+      fillGroups_.insert(M.group);
+  }
+
   mvaFileHltIter2IterL3MuonPixelSeeds_B_                      = iConfig.getParameter<edm::FileInPath>("mvaFileHltIter2IterL3MuonPixelSeeds_B");
   mvaFileHltIter2IterL3FromL1MuonPixelSeeds_B_                = iConfig.getParameter<edm::FileInPath>("mvaFileHltIter2IterL3FromL1MuonPixelSeeds_B");
   mvaFileHltIter2IterL3MuonPixelSeeds_E_                      = iConfig.getParameter<edm::FileInPath>("mvaFileHltIter2IterL3MuonPixelSeeds_E");
@@ -167,10 +294,46 @@ bs(0)
     std::make_pair( std::make_unique<SeedMvaEstimator>(mvaFileHltIter2IterL3FromL1MuonPixelSeeds_B_, mvaScaleMeanHltIter2IterL3FromL1MuonPixelSeeds_B_, mvaScaleStdHltIter2IterL3FromL1MuonPixelSeeds_B_, true, 7),
                     std::make_unique<SeedMvaEstimator>(mvaFileHltIter2IterL3FromL1MuonPixelSeeds_E_, mvaScaleMeanHltIter2IterL3FromL1MuonPixelSeeds_E_, mvaScaleStdHltIter2IterL3FromL1MuonPixelSeeds_E_, true, 7) )
   );
+
+  // -- seed MVA of each track collection, by name: trackCollectionNames may be pruned or reordered by the customizer
+  const std::vector<std::string> mvaFromL2Names = iConfig.getUntrackedParameter<std::vector<std::string> >("mvaFromL2TrackCollections", std::vector<std::string>());
+  const std::vector<std::string> mvaFromL1Names = iConfig.getUntrackedParameter<std::vector<std::string> >("mvaFromL1TrackCollections", std::vector<std::string>());
+  for( const auto& trackName : trackCollectionNames_ ) {
+    const bool fromL2 = std::find(mvaFromL2Names.begin(), mvaFromL2Names.end(), trackName) != mvaFromL2Names.end();
+    const bool fromL1 = std::find(mvaFromL1Names.begin(), mvaFromL1Names.end(), trackName) != mvaFromL1Names.end();
+    if( fromL2 && fromL1 )
+      throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: track collection " << trackName << " in both mvaFromL2TrackCollections and mvaFromL1TrackCollections";
+    trackCollectionMva_.push_back( fromL2 ? &mvaHltIter2IterL3MuonPixelSeeds_ : fromL1 ? &mvaHltIter2IterL3FromL1MuonPixelSeeds_ : nullptr );
+  }
+
+  if( iConfig.existsAs<edm::ParameterSet>("seedNtuple", false) )
+    seedNtuple_ = std::make_unique<MuonHLTSeedNtupleMaker>(iConfig.getUntrackedParameter<edm::ParameterSet>("seedNtuple"), consumesCollector());
 }
 
 void MuonHLTNtupler::analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup)
 {
+  // -- seed ntuple: every event, as the standalone MuonHLTSeedNtupler; not counted in the event time budget below
+  if( seedNtuple_ )
+    seedNtuple_->analyze(iEvent, iSetup);
+
+  eventStart_ = std::chrono::steady_clock::now();
+  budgetOverflow_ = 0;
+
+  nEventProcessed_++;
+  if( doLumiSummary_ ) {
+    const std::pair<int,int> lumiKey(iEvent.id().run(), iEvent.id().luminosityBlock());
+    auto where = lumiSummaries_.find(lumiKey);
+    if( where == lumiSummaries_.end() ) {
+      where = lumiSummaries_.emplace(lumiKey, lumiSummary()).first;
+      where->second.clear(lumiKey.first, lumiKey.second);
+    }
+    lumiSummary_ = &where->second;
+    lumiSummary_->nEvent++;
+  }
+  if( sampleFraction_ < 1. && !SampleEvent(iEvent.id().run(), iEvent.id().luminosityBlock(), iEvent.id().event()) )
+    return;
+  nEventSampled_++;
+
   Init();
 
   // -- basic info.
@@ -196,7 +359,208 @@ void MuonHLTNtupler::analyze(const edm::Event &iEvent, const edm::EventSetup &iS
   bs_dxdzError_ = bs->dxdzError();
   bs_dydzError_ = bs->dydzError();
 
+  Update_ESCache(iSetup);
+
+  if( fillGroup("event") ) Fill_Event(iEvent);
+
+  // -- fill each object (friend tree: only the groups written and the ones they are computed from)
+  // Fill_L1Track(iEvent, iSetup);
+  if( fillGroup("muon") )    Fill_Muon(iEvent, iSetup);
+  if( fillGroup("HLT") ) {
+    if( miniAOD_ ) Fill_HLTMiniAOD(iEvent);
+    else           Fill_HLT(iEvent, 0); // -- original HLT objects saved in data taking
+  }
+  if( fillGroup("MYHLT") )   Fill_HLT(iEvent, 1); // -- rerun objects
+  if( fillGroup("variants") ) {
+    for( auto& V : menuVariants_ )
+      Fill_MenuVariant(iEvent, V);
+  }
+  if( fillGroup("HLTMuon") ) Fill_HLTMuon(iEvent);
+  if( fillGroup("L1Muon") )  Fill_L1Muon(iEvent);
+  if( fillGroup("iterL3") && !budgetTimeExceeded(kBudgetTimeIterL3) ) Fill_IterL3(iEvent, iSetup);
+  if( fillGroup("tracks") )  Fill_TrackTemplates(iEvent); // -- after Fill_IterL3: links to the L3 muons
+  if( doMuonMatch_ && fillGroup("muonMatch") ) Fill_MuonMatch(); // -- after every collection it reads
+  //if( doSeed )  Fill_Seed(iEvent, iSetup);
+  if( !isRealData_ ) {
+    if( fillGroup("gen") ) Fill_GenParticle(iEvent);
+    if( fillGroup("TP") && !budgetTimeExceeded(kBudgetTimeTP) ) Fill_TP(iEvent, TrkParticle);
+  }
+
+  if( friendCheck_ ) Check_FriendKey();
+  if( doLumiSummary_ ) {
+    Fill_LumiSummaryInputs(iEvent);
+    Fill_LumiSummary();
+  }
+  if( doEfficiencyHist_ ) Fill_EfficiencyHist(iEvent);
+
+  for( int bit=0; bit<nBudgetBit; ++bit ) {
+    if( budgetOverflow_ & (1u << bit) )
+      nBudgetOverflow_[bit]++;
+  }
+
+  if( writeNtuple_ ) ntuple_->Fill();
+  nFilled_++;
+}
+
+// -- number of objects to process: n, or limit (and the bit set) if n is above it
+unsigned int MuonHLTNtupler::budgetLimit(size_t n, unsigned int limit, budgetBit bit)
+{
+  if( limit == 0 || n <= limit )
+    return n;
+
+  budgetOverflow_ |= (1u << bit);
+  return limit;
+}
+
+bool MuonHLTNtupler::budgetTimeExceeded(budgetBit bit)
+{
+  if( maxEventTime_ <= 0. )
+    return false;
+  if( 1e3*std::chrono::duration<double>(std::chrono::steady_clock::now() - eventStart_).count() < maxEventTime_ )
+    return false;
+
+  budgetOverflow_ |= (1u << bit);
+  return true;
+}
+
+void MuonHLTNtupler::Fill_LumiSummary()
+{
+  lumiSummary& L = *lumiSummary_;
+  L.nEventSampled++;
+
+  if( truePU_ != -999 )   { L.nTruePU++;      L.sumTruePU += truePU_; }
+  if( instLumi_ != -999 ) { L.nInstLumi++;    L.sumInstLumi += instLumi_; }
+  if( nVertex_ != -999 )  { L.nVertexEvent++; L.sumVertex += nVertex_; }
+
+  if( nL1Muon_ > 0 ) {
+    L.nL1Muon += nL1Muon_;
+    L.nEventL1Muon1++;
+    if( nL1Muon_ > 1 ) L.nEventL1Muon2++;
+  }
+
+  for( const auto& pathName : vec_firedTrigger_ )
+    L.triggerCount[pathName]++;
+  for( const auto& pathName : vec_myFiredTrigger_ )
+    L.myTriggerCount[pathName]++;
+}
+
+// -- Fill_LumiSummary reads truePU, instLumi, nVertex (event), nL1Muon (L1Muon) and the fired paths (HLT, MYHLT)
+// -- friend tree without some of these groups: only those inputs are read here, no trigger object, L1 kinematics or vertex collection filled
+void MuonHLTNtupler::Fill_LumiSummaryInputs(const edm::Event &iEvent)
+{
+  if( !fillGroup("event") ) {
+    edm::Handle<reco::VertexCollection> h_offlineVertex;
+    if( iEvent.getByToken(t_offlineVertex_, h_offlineVertex) )
+      nVertex_ = std::count_if(h_offlineVertex->begin(), h_offlineVertex->end(), [](const reco::Vertex& vtx) { return vtx.isValid(); });
+
+    if( isRealData_ ) {
+      edm::Handle<LumiScalersCollection> h_lumiScaler;
+      if( iEvent.getByToken(t_lumiScaler_, h_lumiScaler) && h_lumiScaler->begin() != h_lumiScaler->end() )
+        instLumi_ = h_lumiScaler->begin()->instantLumi();
+    }
+    else {
+      edm::Handle<std::vector< PileupSummaryInfo > > h_PUSummaryInfo;
+      if( iEvent.getByToken(t_PUSummaryInfo_, h_PUSummaryInfo) ) {
+        for( const auto& PVI : *h_PUSummaryInfo ) {
+          if( PVI.getBunchCrossing() == 0 )
+            truePU_ = PVI.getTrueNumInteractions();
+        }
+      }
+    }
+  }
+
+  if( !fillGroup("L1Muon") ) {
+    edm::Handle<l1t::MuonBxCollection> h_L1Muon;
+    if( iEvent.getByToken(t_L1Muon_, h_L1Muon) )
+      nL1Muon_ = ( h_L1Muon->getFirstBX() <= 0 && h_L1Muon->getLastBX() >= 0 ) ? h_L1Muon->size(0) : 0;
+  }
+
+  if( !fillGroup("HLT") ) {
+    edm::Handle<edm::TriggerResults> h_triggerResults;
+    if( iEvent.getByToken(t_triggerResults_, h_triggerResults) )
+      Fill_FiredTrigger(iEvent, *h_triggerResults, false);
+  }
+
+  if( !miniAOD_ && !fillGroup("MYHLT") ) {
+    edm::Handle<edm::TriggerResults> h_myTriggerResults;
+    if( iEvent.getByToken(t_myTriggerResults_, h_myTriggerResults) )
+      Fill_FiredTrigger(iEvent, *h_myTriggerResults, true);
+  }
+}
 
+// -- one entry per lumi section seen in the job, ordered by (run, lumi)
+void MuonHLTNtupler::Write_LumiSummary()
+{
+  for( const auto& entry : lumiSummaries_ ) {
+    const lumiSummary& L = entry.second;
+    lumi_run_           = L.run;
+    lumi_lumi_          = L.lumi;
+    lumi_nEvent_        = L.nEvent;
+    lumi_nEventSampled_ = L.nEventSampled;
+    lumi_meanTruePU_    = L.nTruePU > 0      ? L.sumTruePU/L.nTruePU      : -999;
+    lumi_meanInstLumi_  = L.nInstLumi > 0    ? L.sumInstLumi/L.nInstLumi  : -999;
+    lumi_meanNVertex_   = L.nVertexEvent > 0 ? L.sumVertex/L.nVertexEvent : -999;
+    lumi_nL1Muon_       = L.nL1Muon;
+    lumi_nEventL1Muon1_ = L.nEventL1Muon1;
+    lumi_nEventL1Muon2_ = L.nEventL1Muon2;
+
+    lumi_trigger_.clear();
+    lumi_triggerCount_.clear();
+    for( const auto& path : L.triggerCount ) {
+      lumi_trigger_.push_back( path.first );
+      lumi_triggerCount_.push_back( path.second );
+    }
+    lumi_myTrigger_.clear();
+    lumi_myTriggerCount_.clear();
+    for( const auto& path : L.myTriggerCount ) {
+      lumi_myTrigger_.push_back( path.first );
+      lumi_myTriggerCount_.push_back( path.second );
+    }
+
+    lumiTree_->Fill();
+  }
+}
+
+void MuonHLTNtupler::Make_LumiBranch()
+{
+  lumiTree_->Branch("runNum", &lumi_run_, "runNum/I");
+  lumiTree_->Branch("lumiBlockNum", &lumi_lumi_, "lumiBlockNum/I");
+  lumiTree_->Branch("nEvent", &lumi_nEvent_, "nEvent/l");
+  lumiTree_->Branch("nEventSampled", &lumi_nEventSampled_, "nEventSampled/l");
+  lumiTree_->Branch("meanTruePU", &lumi_meanTruePU_, "meanTruePU/D");
+  lumiTree_->Branch("meanInstLumi", &lumi_meanInstLumi_, "meanInstLumi/D");
+  lumiTree_->Branch("meanNVertex", &lumi_meanNVertex_, "meanNVertex/D");
+  lumiTree_->Branch("nL1Muon", &lumi_nL1Muon_, "nL1Muon/l");
+  lumiTree_->Branch("nEventL1Muon1", &lumi_nEventL1Muon1_, "nEventL1Muon1/l");
+  lumiTree_->Branch("nEventL1Muon2", &lumi_nEventL1Muon2_, "nEventL1Muon2/l");
+  lumiTree_->Branch("trigger", &lumi_trigger_);
+  lumiTree_->Branch("triggerCount", &lumi_triggerCount_);
+  lumiTree_->Branch("myTrigger", &lumi_myTrigger_);
+  lumiTree_->Branch("myTriggerCount", &lumi_myTriggerCount_);
+}
+
+// -- splitmix64 finalizer: fixed arithmetic, unlike std::hash the result does not depend on the compiler or the platform
+static unsigned long long sampleMix(unsigned long long x)
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+bool MuonHLTNtupler::SampleEvent(unsigned int run, unsigned int lumi, unsigned long long event) const
+{
+  unsigned long long hash = sampleMix( sampleSeed_ );
+  hash = sampleMix( hash ^ run );
+  hash = sampleMix( hash ^ lumi );
+  hash = sampleMix( hash ^ event );
+
+  // -- top 53 bits -> uniform in [0, 1)
+  return (hash >> 11) * 0x1.0p-53 < sampleFraction_;
+}
+
+void MuonHLTNtupler::Fill_Event(const edm::Event &iEvent)
+{
   // -- vertex
   edm::Handle<reco::VertexCollection> h_offlineVertex;
   if( iEvent.getByToken(t_offlineVertex_, h_offlineVertex) )
@@ -276,30 +640,80 @@ void MuonHLTNtupler::analyze(const edm::Event &iEvent, const edm::EventSetup &iS
       } // -- end of PU iteration -- //
     } // -- end of if ( token exists )
   } // -- end of isMC -- //
+}
 
-  // -- fill each object
-  // Fill_L1Track(iEvent, iSetup);
-  Fill_Muon(iEvent, iSetup);
-  Fill_HLT(iEvent, 0); // -- original HLT objects saved in data taking
-  Fill_HLT(iEvent, 1); // -- rerun objects
-  Fill_HLTMuon(iEvent);
-  Fill_L1Muon(iEvent);
-  Fill_IterL3(iEvent, iSetup);
-  //if( doSeed )  Fill_Seed(iEvent, iSetup);
-  if( !isRealData_ ) {
-    Fill_GenParticle(iEvent);
-    Fill_TP(iEvent, TrkParticle);
+void MuonHLTNtupler::beginJob()
+{
+  edm::Service<TFileService> fs;
+  ntuple_ = nullptr;
+  if( writeNtuple_ ) {
+    ntuple_ = fs->make<TTree>("ntuple","ntuple");
+    Make_Branch();
+  }
+
+  if( doEfficiencyHist_ )
+    Make_EfficiencyHist();
+
+  if( seedNtuple_ ) {
+    TFileDirectory seedDir = fs->mkdir("seedNtupler");
+    seedNtuple_->beginJob(seedDir);
+  }
+
+  if( doLumiSummary_ ) {
+    lumiTree_ = fs->make<TTree>("lumi","lumi");
+    Make_LumiBranch();
   }
 
-  ntuple_->Fill();
+  if( !branchGroups_.empty() && !friendReference_.empty() )
+    Load_FriendKeys();
 }
 
-void MuonHLTNtupler::beginJob()
+void MuonHLTNtupler::Load_FriendKeys()
 {
-  edm::Service<TFileService> fs;
-  ntuple_ = fs->make<TTree>("ntuple","ntuple");
+  std::unique_ptr<TFile> f_ref( TFile::Open(friendReference_.c_str(), "READ") );
+  TTree* t_ref = f_ref ? dynamic_cast<TTree*>(f_ref->Get(friendReferenceTree_.c_str())) : nullptr;
+  if( !t_ref )
+    throw cms::Exception("FileOpenError") << "MuonHLTNtupler: no tree " << friendReferenceTree_ << " in " << friendReference_;
+
+  friendKey key;
+  t_ref->SetBranchStatus("*", 0);
+  for( const char* name : {"runNum", "lumiBlockNum", "eventNum"} ) {
+    if( !t_ref->GetBranch(name) )
+      throw cms::Exception("FriendMismatch") << "MuonHLTNtupler: no " << name << " branch in " << friendReference_ << ":" << friendReferenceTree_;
+    t_ref->SetBranchStatus(name, 1);
+  }
+  t_ref->SetBranchAddress("runNum", &key.run);
+  t_ref->SetBranchAddress("lumiBlockNum", &key.lumi);
+  t_ref->SetBranchAddress("eventNum", &key.event);
+
+  for( Long64_t i=0; i<t_ref->GetEntries(); ++i ) {
+    if( t_ref->GetEntry(i) <= 0 )
+      throw cms::Exception("FriendMismatch") << "MuonHLTNtupler: entry " << i << " of " << friendReference_ << " could not be read";
+    if( !friendKeys_.insert(key).second )
+      throw cms::Exception("FriendMismatch") << "MuonHLTNtupler: " << key.run << ":" << key.lumi << ":" << key.event << " twice in " << friendReference_;
+  }
+  if( friendKeys_.empty() )
+    throw cms::Exception("FriendMismatch") << "MuonHLTNtupler: no event in " << friendReference_ << ":" << friendReferenceTree_;
+  nFriendReference_ = friendKeys_.size();
+  friendCheck_ = true;
+
+  t_ref->ResetBranchAddresses();
+  f_ref->Close();
+
+  cout << "[MuonHLTNtupler::Load_FriendKeys] " << friendKeys_.size() << " events in " << friendReference_ << endl;
+}
 
-  Make_Branch();
+// -- every written event has to be in the reference, once; the order is free (file order), see friendKey
+// -- the reference events never written are checked in endJob: the friend tree has to cover the whole reference
+void MuonHLTNtupler::Check_FriendKey()
+{
+  friendKey key;
+  key.run   = runNum_;
+  key.lumi  = lumiBlockNum_;
+  key.event = eventNum_;
+  if( friendKeys_.erase(key) == 0 )
+    throw cms::Exception("FriendMismatch") << "MuonHLTNtupler: " << runNum_ << ":" << lumiBlockNum_ << ":" << eventNum_
+                                           << " is not in " << friendReference_ << " or was already written";
 }
 
 void MuonHLTNtupler::Init()
@@ -420,6 +834,9 @@ void MuonHLTNtupler::Init()
   vec_myHLTObj_eta_.clear();
   vec_myHLTObj_phi_.clear();
 
+  for( auto& V : menuVariants_ )
+    V.clear();
+
   MuonIterSeedMap.clear();
   hltIterL3OIMuonTrackMap.clear();
   hltIter0IterL3MuonTrackMap.clear();
@@ -452,6 +869,7 @@ void MuonHLTNtupler::Init()
     muon_isHighPt_[i] = 0;
     muon_isHighPtNew_[i] = 0;
     muon_isSoft_[i] = 0;
+    muon_selectorBits_[i] = 0;
 
     muon_iso03_sumPt_[i] = -999;
     muon_iso03_hadEt_[i] = -999;
@@ -837,34 +1255,39 @@ void MuonHLTNtupler::Init()
 
 void MuonHLTNtupler::Make_Branch()
 {
+  // -- key of the event: always written, also in a friend tree (friendBranchGroups)
   ntuple_->Branch("isRealData", &isRealData_, "isRealData/O"); // -- O: boolean -- //
   ntuple_->Branch("runNum",&runNum_,"runNum/I");
   ntuple_->Branch("lumiBlockNum",&lumiBlockNum_,"lumiBlockNum/I");
   ntuple_->Branch("eventNum",&eventNum_,"eventNum/l"); // -- unsigned long long -- //
-  ntuple_->Branch("bs_x0", &bs_x0_, "bs_x0/D");
-  ntuple_->Branch("bs_y0", &bs_y0_, "bs_y0/D");
-  ntuple_->Branch("bs_z0", &bs_z0_, "bs_z0/D");
-  ntuple_->Branch("bs_sigmaZ", &bs_sigmaZ_, "bs_sigmaZ/D");
-  ntuple_->Branch("bs_dxdz", &bs_dxdz_, "bs_dxdz/D");
-  ntuple_->Branch("bs_dydz", &bs_dydz_, "bs_dydz/D");
-  ntuple_->Branch("bs_x0Error", &bs_x0Error_, "bs_x0Error/D");
-  ntuple_->Branch("bs_y0Error", &bs_y0Error_, "bs_y0Error/D");
-  ntuple_->Branch("bs_z0Error", &bs_z0Error_, "bs_z0Error/D");
-  ntuple_->Branch("bs_sigmaZ0Error", &bs_sigmaZ0Error_, "bs_sigmaZ0Error/D");
-  ntuple_->Branch("bs_dxdzError", &bs_dxdzError_, "bs_dxdzError/D");
-  ntuple_->Branch("bs_dydzError", &bs_dydzError_, "bs_dydzError/D");
-  ntuple_->Branch("nVertex", &nVertex_, "nVertex/I");
-  ntuple_->Branch("bunchID", &bunchID_, "bunchID/D");
-  ntuple_->Branch("instLumi", &instLumi_, "instLumi/D");
-  ntuple_->Branch("dataPU", &dataPU_, "dataPU/D");
-  ntuple_->Branch("dataPURMS", &dataPURMS_, "dataPURMS/D");
-  ntuple_->Branch("bunchLumi", &bunchLumi_, "bunchLumi/D");
-  ntuple_->Branch("offlineInstLumi", &offlineInstLumi_, "offlineInstLumi/D");
-  ntuple_->Branch("offlineDataPU", &offlineDataPU_, "offlineDataPU/D");
-  ntuple_->Branch("offlineDataPURMS", &offlineDataPURMS_, "offlineDataPURMS/D");
-  ntuple_->Branch("offlineBunchLumi", &offlineBunchLumi_, "offlineBunchLumi/D");
-  ntuple_->Branch("truePU", &truePU_, "truePU/I");
-if( doHI ){
+
+  if( writeGroup("event") ) {
+    ntuple_->Branch("bs_x0", &bs_x0_, "bs_x0/D");
+    ntuple_->Branch("bs_y0", &bs_y0_, "bs_y0/D");
+    ntuple_->Branch("bs_z0", &bs_z0_, "bs_z0/D");
+    ntuple_->Branch("bs_sigmaZ", &bs_sigmaZ_, "bs_sigmaZ/D");
+    ntuple_->Branch("bs_dxdz", &bs_dxdz_, "bs_dxdz/D");
+    ntuple_->Branch("bs_dydz", &bs_dydz_, "bs_dydz/D");
+    ntuple_->Branch("bs_x0Error", &bs_x0Error_, "bs_x0Error/D");
+    ntuple_->Branch("bs_y0Error", &bs_y0Error_, "bs_y0Error/D");
+    ntuple_->Branch("bs_z0Error", &bs_z0Error_, "bs_z0Error/D");
+    ntuple_->Branch("bs_sigmaZ0Error", &bs_sigmaZ0Error_, "bs_sigmaZ0Error/D");
+    ntuple_->Branch("bs_dxdzError", &bs_dxdzError_, "bs_dxdzError/D");
+    ntuple_->Branch("bs_dydzError", &bs_dydzError_, "bs_dydzError/D");
+    ntuple_->Branch("nVertex", &nVertex_, "nVertex/I");
+    ntuple_->Branch("bunchID", &bunchID_, "bunchID/D");
+    ntuple_->Branch("instLumi", &instLumi_, "instLumi/D");
+    ntuple_->Branch("dataPU", &dataPU_, "dataPU/D");
+    ntuple_->Branch("dataPURMS", &dataPURMS_, "dataPURMS/D");
+    ntuple_->Branch("bunchLumi", &bunchLumi_, "bunchLumi/D");
+    ntuple_->Branch("offlineInstLumi", &offlineInstLumi_, "offlineInstLumi/D");
+    ntuple_->Branch("offlineDataPU", &offlineDataPU_, "offlineDataPU/D");
+    ntuple_->Branch("offlineDataPURMS", &offlineDataPURMS_, "offlineDataPURMS/D");
+    ntuple_->Branch("offlineBunchLumi", &offlineBunchLumi_, "offlineBunchLumi/D");
+    ntuple_->Branch("truePU", &truePU_, "truePU/I");
+    ntuple_->Branch("budgetOverflow", &budgetOverflow_, "budgetOverflow/i"); // -- budgetBit in MuonHLTNtupler.h
+  }
+if( doHI && writeGroup("muon") ){ // -- filled in Fill_Muon
   ntuple_->Branch("hi_cBin",&hi_cBin);
   ntuple_->Branch("hiHF", &hiHF);
   ntuple_->Branch("hiHFplus", &hiHFplus);
@@ -882,433 +1305,681 @@ if( doHI ){
 }
 
 
-  ntuple_->Branch("rho_ECAL", &rho_ECAL_, "rho_ECAL/D");
-  ntuple_->Branch("rho_HCAL", &rho_HCAL_, "rho_HCAL/D");
-
-  ntuple_->Branch("genEventWeight", &genEventWeight_, "genEventWeight/D");
-  ntuple_->Branch("nGenParticle", &nGenParticle_, "nGenParticle/I");
-  ntuple_->Branch("genParticle_ID", &genParticle_ID_, "genParticle_ID[nGenParticle]/I");
-  ntuple_->Branch("genParticle_status", &genParticle_status_, "genParticle_status[nGenParticle]/I");
-  ntuple_->Branch("genParticle_mother", &genParticle_mother_, "genParticle_mother[nGenParticle]/I");
-  ntuple_->Branch("genParticle_pt", &genParticle_pt_, "genParticle_pt[nGenParticle]/D");
-  ntuple_->Branch("genParticle_eta", &genParticle_eta_, "genParticle_eta[nGenParticle]/D");
-  ntuple_->Branch("genParticle_phi", &genParticle_phi_, "genParticle_phi[nGenParticle]/D");
-  ntuple_->Branch("genParticle_px", &genParticle_px_, "genParticle_px[nGenParticle]/D");
-  ntuple_->Branch("genParticle_py", &genParticle_py_, "genParticle_py[nGenParticle]/D");
-  ntuple_->Branch("genParticle_pz", &genParticle_pz_, "genParticle_pz[nGenParticle]/D");
-  ntuple_->Branch("genParticle_energy", &genParticle_energy_, "genParticle_energy[nGenParticle]/D");
-  ntuple_->Branch("genParticle_charge", &genParticle_charge_, "genParticle_charge[nGenParticle]/D");
-  ntuple_->Branch("genParticle_isPrompt", &genParticle_isPrompt_, "genParticle_isPrompt[nGenParticle]/I");
-  ntuple_->Branch("genParticle_isPromptFinalState", &genParticle_isPromptFinalState_, "genParticle_isPromptFinalState[nGenParticle]/I");
-  ntuple_->Branch("genParticle_isTauDecayProduct", &genParticle_isTauDecayProduct_, "genParticle_isTauDecayProduct[nGenParticle]/I");
-  ntuple_->Branch("genParticle_isPromptTauDecayProduct", &genParticle_isPromptTauDecayProduct_, "genParticle_isPromptTauDecayProduct[nGenParticle]/I");
-  ntuple_->Branch("genParticle_isDirectPromptTauDecayProductFinalState", &genParticle_isDirectPromptTauDecayProductFinalState_, "genParticle_isDirectPromptTauDecayProductFinalState[nGenParticle]/I");
-  ntuple_->Branch("genParticle_isHardProcess", &genParticle_isHardProcess_, "genParticle_isHardProcess[nGenParticle]/I");
-  ntuple_->Branch("genParticle_isLastCopy", &genParticle_isLastCopy_, "genParticle_isLastCopy[nGenParticle]/I");
-  ntuple_->Branch("genParticle_isLastCopyBeforeFSR", &genParticle_isLastCopyBeforeFSR_, "genParticle_isLastCopyBeforeFSR[nGenParticle]/I");
-  ntuple_->Branch("genParticle_isPromptDecayed", &genParticle_isPromptDecayed_, "genParticle_isPromptDecayed[nGenParticle]/I");
-  ntuple_->Branch("genParticle_isDecayedLeptonHadron", &genParticle_isDecayedLeptonHadron_, "genParticle_isDecayedLeptonHadron[nGenParticle]/I");
-  ntuple_->Branch("genParticle_fromHardProcessBeforeFSR", &genParticle_fromHardProcessBeforeFSR_, "genParticle_fromHardProcessBeforeFSR[nGenParticle]/I");
-  ntuple_->Branch("genParticle_fromHardProcessDecayed", &genParticle_fromHardProcessDecayed_, "genParticle_fromHardProcessDecayed[nGenParticle]/I");
-  ntuple_->Branch("genParticle_fromHardProcessFinalState", &genParticle_fromHardProcessFinalState_, "genParticle_fromHardProcessFinalState[nGenParticle]/I");
-  ntuple_->Branch("genParticle_isMostlyLikePythia6Status3", &genParticle_isMostlyLikePythia6Status3_, "genParticle_isMostlyLikePythia6Status3[nGenParticle]/I");
-  ntuple_->Branch("genParticle_l1pt", &genParticle_l1pt_, "genParticle_l1pt[nGenParticle]/D");
-  ntuple_->Branch("genParticle_l1eta", &genParticle_l1eta_, "genParticle_l1eta[nGenParticle]/D");
-  ntuple_->Branch("genParticle_l1phi", &genParticle_l1phi_, "genParticle_l1phi[nGenParticle]/D");
-  ntuple_->Branch("genParticle_l1charge", &genParticle_l1charge_, "genParticle_l1charge[nGenParticle]/D");
-  ntuple_->Branch("genParticle_l1q", &genParticle_l1q_, "genParticle_l1q[nGenParticle]/I");
-  ntuple_->Branch("genParticle_l1dr", &genParticle_l1dr_, "genParticle_l1dr[nGenParticle]/D");
-  ntuple_->Branch("genParticle_l1ptByQ", &genParticle_l1ptByQ_, "genParticle_l1ptByQ[nGenParticle]/D");
-  ntuple_->Branch("genParticle_l1etaByQ", &genParticle_l1etaByQ_, "genParticle_l1etaByQ[nGenParticle]/D");
-  ntuple_->Branch("genParticle_l1phiByQ", &genParticle_l1phiByQ_, "genParticle_l1phiByQ[nGenParticle]/D");
-  ntuple_->Branch("genParticle_l1chargeByQ", &genParticle_l1chargeByQ_, "genParticle_l1chargeByQ[nGenParticle]/D");
-  ntuple_->Branch("genParticle_l1qByQ", &genParticle_l1qByQ_, "genParticle_l1qByQ[nGenParticle]/I");
-  ntuple_->Branch("genParticle_l1drByQ", &genParticle_l1drByQ_, "genParticle_l1drByQ[nGenParticle]/D");
-
-  ntuple_->Branch("vec_firedTrigger", &vec_firedTrigger_);
-  ntuple_->Branch("vec_filterName", &vec_filterName_);
-  ntuple_->Branch("vec_HLTObj_pt", &vec_HLTObj_pt_);
-  ntuple_->Branch("vec_HLTObj_eta", &vec_HLTObj_eta_);
-  ntuple_->Branch("vec_HLTObj_phi", &vec_HLTObj_phi_);
-
-  ntuple_->Branch("vec_myFiredTrigger", &vec_myFiredTrigger_);
-  ntuple_->Branch("vec_myFilterName", &vec_myFilterName_);
-  ntuple_->Branch("vec_myHLTObj_pt", &vec_myHLTObj_pt_);
-  ntuple_->Branch("vec_myHLTObj_eta", &vec_myHLTObj_eta_);
-  ntuple_->Branch("vec_myHLTObj_phi", &vec_myHLTObj_phi_);
-
-  ntuple_->Branch("nMuon", &nMuon_, "nMuon/I");
-
-  ntuple_->Branch("muon_pt", &muon_pt_, "muon_pt[nMuon]/D");
-  ntuple_->Branch("muon_eta", &muon_eta_, "muon_eta[nMuon]/D");
-  ntuple_->Branch("muon_phi", &muon_phi_, "muon_phi[nMuon]/D");
-  ntuple_->Branch("muon_px", &muon_px_, "muon_px[nMuon]/D");
-  ntuple_->Branch("muon_py", &muon_py_, "muon_py[nMuon]/D");
-  ntuple_->Branch("muon_pz", &muon_pz_, "muon_pz[nMuon]/D");
-  ntuple_->Branch("muon_dB", &muon_dB_, "muon_dB[nMuon]/D");
-  ntuple_->Branch("muon_charge", &muon_charge_, "muon_charge[nMuon]/D");
-  ntuple_->Branch("muon_isGLB", &muon_isGLB_, "muon_isGLB[nMuon]/I");
-  ntuple_->Branch("muon_isSTA", &muon_isSTA_, "muon_isSTA[nMuon]/I");
-  ntuple_->Branch("muon_isTRK", &muon_isTRK_, "muon_isTRK[nMuon]/I");
-  ntuple_->Branch("muon_isPF", &muon_isPF_, "muon_isPF[nMuon]/I");
-  ntuple_->Branch("muon_isTight", &muon_isTight_, "muon_isTight[nMuon]/I");
-  ntuple_->Branch("muon_isMedium", &muon_isMedium_, "muon_isMedium[nMuon]/I");
-  ntuple_->Branch("muon_isLoose", &muon_isLoose_, "muon_isLoose[nMuon]/I");
-  ntuple_->Branch("muon_isHighPt", &muon_isHighPt_, "muon_isHighPt[nMuon]/I");
-  ntuple_->Branch("muon_isHighPtNew", &muon_isHighPtNew_, "muon_isHighPtNew[nMuon]/I");
-  ntuple_->Branch("muon_isSoft", &muon_isSoft_, "muon_isSoft[nMuon]/I");
-
-  ntuple_->Branch("muon_iso03_sumPt", &muon_iso03_sumPt_, "muon_iso03_sumPt[nMuon]/D");
-  ntuple_->Branch("muon_iso03_hadEt", &muon_iso03_hadEt_, "muon_iso03_hadEt[nMuon]/D");
-  ntuple_->Branch("muon_iso03_emEt", &muon_iso03_emEt_, "muon_iso03_emEt[nMuon]/D");
-  ntuple_->Branch("muon_PFIso03_charged", &muon_PFIso03_charged_, "muon_PFIso03_charged[nMuon]/D");
-  ntuple_->Branch("muon_PFIso03_neutral", &muon_PFIso03_neutral_, "muon_PFIso03_neutral[nMuon]/D");
-  ntuple_->Branch("muon_PFIso03_photon", &muon_PFIso03_photon_, "muon_PFIso03_photon[nMuon]/D");
-  ntuple_->Branch("muon_PFIso03_sumPU", &muon_PFIso03_sumPU_, "muon_PFIso03_sumPU[nMuon]/D");
-  ntuple_->Branch("muon_PFIso04_charged", &muon_PFIso04_charged_, "muon_PFIso04_charged[nMuon]/D");
-  ntuple_->Branch("muon_PFIso04_neutral", &muon_PFIso04_neutral_, "muon_PFIso04_neutral[nMuon]/D");
-  ntuple_->Branch("muon_PFIso04_photon", &muon_PFIso04_photon_, "muon_PFIso04_photon[nMuon]/D");
-  ntuple_->Branch("muon_PFIso04_sumPU", &muon_PFIso04_sumPU_, "muon_PFIso04_sumPU[nMuon]/D");
-
-  ntuple_->Branch("muon_PFCluster03_ECAL", &muon_PFCluster03_ECAL_, "muon_PFCluster03_ECAL[nMuon]/D");
-  ntuple_->Branch("muon_PFCluster03_HCAL", &muon_PFCluster03_HCAL_, "muon_PFCluster03_HCAL[nMuon]/D");
-  ntuple_->Branch("muon_PFCluster04_ECAL", &muon_PFCluster04_ECAL_, "muon_PFCluster04_ECAL[nMuon]/D");
-  ntuple_->Branch("muon_PFCluster04_HCAL", &muon_PFCluster04_HCAL_, "muon_PFCluster04_HCAL[nMuon]/D");
-  ntuple_->Branch("muon_inner_trkChi2", &muon_inner_trkChi2_, "muon_inner_trkChi2[nMuon]/D");
-  ntuple_->Branch("muon_inner_validFraction", &muon_inner_validFraction_, "muon_inner_validFraction[nMuon]/D");
-  ntuple_->Branch("muon_inner_trackerLayers", &muon_inner_trackerLayers_, "muon_inner_trackerLayers[nMuon]/I");
-  ntuple_->Branch("muon_inner_trackerHits", &muon_inner_trackerHits_, "muon_inner_trackerHits[nMuon]/I");
-  ntuple_->Branch("muon_inner_lostTrackerHits", &muon_inner_lostTrackerHits_, "muon_inner_lostTrackerHits[nMuon]/I");
-  ntuple_->Branch("muon_inner_lostTrackerHitsIn", &muon_inner_lostTrackerHitsIn_, "muon_inner_lostTrackerHitsIn[nMuon]/I");
-  ntuple_->Branch("muon_inner_lostTrackerHitsOut", &muon_inner_lostTrackerHitsOut_, "muon_inner_lostTrackerHitsOut[nMuon]/I");
-  ntuple_->Branch("muon_inner_lostPixelHits", &muon_inner_lostPixelHits_, "muon_inner_lostPixelHits[nMuon]/I");
-  ntuple_->Branch("muon_inner_lostPixelBarrelHits", &muon_inner_lostPixelBarrelHits_, "muon_inner_lostPixelBarrelHits[nMuon]/I");
-  ntuple_->Branch("muon_inner_lostPixelEndcapHits", &muon_inner_lostPixelEndcapHits_, "muon_inner_lostPixelEndcapHits[nMuon]/I");
-  ntuple_->Branch("muon_inner_lostStripHits", &muon_inner_lostStripHits_, "muon_inner_lostStripHits[nMuon]/I");
-  ntuple_->Branch("muon_inner_lostStripTIBHits", &muon_inner_lostStripTIBHits_, "muon_inner_lostStripTIBHits[nMuon]/I");
-  ntuple_->Branch("muon_inner_lostStripTIDHits", &muon_inner_lostStripTIDHits_, "muon_inner_lostStripTIDHits[nMuon]/I");
-  ntuple_->Branch("muon_inner_lostStripTOBHits", &muon_inner_lostStripTOBHits_, "muon_inner_lostStripTOBHits[nMuon]/I");
-  ntuple_->Branch("muon_inner_lostStripTECHits", &muon_inner_lostStripTECHits_, "muon_inner_lostStripTECHits[nMuon]/I");
-  ntuple_->Branch("muon_inner_pixelLayers", &muon_inner_pixelLayers_, "muon_inner_pixelLayers[nMuon]/I");
-  ntuple_->Branch("muon_inner_pixelHits", &muon_inner_pixelHits_, "muon_inner_pixelHits[nMuon]/I");
-  ntuple_->Branch("muon_global_muonHits", &muon_global_muonHits_, "muon_global_muonHits[nMuon]/I");
-  ntuple_->Branch("muon_global_trkChi2", &muon_global_trkChi2_, "muon_global_trkChi2[nMuon]/D");
-  ntuple_->Branch("muon_global_trackerLayers", &muon_global_trackerLayers_, "muon_global_trackerLayers[nMuon]/I");
-  ntuple_->Branch("muon_global_trackerHits", &muon_global_trackerHits_, "muon_global_trackerHits[nMuon]/I");
-  ntuple_->Branch("muon_momentumChi2", &muon_momentumChi2_, "muon_momentumChi2[nMuon]/D");
-  ntuple_->Branch("muon_positionChi2", &muon_positionChi2_, "muon_positionChi2[nMuon]/D");
-  ntuple_->Branch("muon_glbKink", &muon_glbKink_, "muon_glbKink[nMuon]/D");
-  ntuple_->Branch("muon_glbTrackProbability", &muon_glbTrackProbability_, "muon_glbTrackProbability[nMuon]/D");
-  ntuple_->Branch("muon_globalDeltaEtaPhi", &muon_globalDeltaEtaPhi_, "muon_globalDeltaEtaPhi[nMuon]/D");
-  ntuple_->Branch("muon_localDistance", &muon_localDistance_, "muon_localDistance[nMuon]/D");
-  ntuple_->Branch("muon_staRelChi2", &muon_staRelChi2_, "muon_staRelChi2[nMuon]/D");
-  ntuple_->Branch("muon_tightMatch", &muon_tightMatch_, "muon_tightMatch[nMuon]/I");
-  ntuple_->Branch("muon_trkKink", &muon_trkKink_, "muon_trkKink[nMuon]/D");
-  ntuple_->Branch("muon_trkRelChi2", &muon_trkRelChi2_, "muon_trkRelChi2[nMuon]/D");
-  ntuple_->Branch("muon_segmentCompatibility", &muon_segmentCompatibility_, "muon_segmentCompatibility[nMuon]/D");
-
-  ntuple_->Branch("muon_pt_tuneP", &muon_pt_tuneP_, "muon_pt_tuneP[nMuon]/D");
-  ntuple_->Branch("muon_ptError_tuneP", &muon_ptError_tuneP_, "muon_ptError_tuneP[nMuon]/D");
-  ntuple_->Branch("muon_dxyVTX_best", &muon_dxyVTX_best_, "muon_dxyVTX_best[nMuon]/D");
-  ntuple_->Branch("muon_dzVTX_best", &muon_dzVTX_best_, "muon_dzVTX_best[nMuon]/D");
-  ntuple_->Branch("muon_nMatchedStation", &muon_nMatchedStation_, "muon_nMatchedStation[nMuon]/I");
-  ntuple_->Branch("muon_nMatchedRPCLayer", &muon_nMatchedRPCLayer_, "muon_nMatchedRPCLayer[nMuon]/I");
-  ntuple_->Branch("muon_stationMask", &muon_stationMask_, "muon_stationMask[nMuon]/I");
-  ntuple_->Branch("muon_dxy_bs", &muon_dxy_bs_, "muon_dxy_bs[nMuon]/D");
-  ntuple_->Branch("muon_dxyError_bs", &muon_dxyError_bs_, "muon_dxyError_bs[nMuon]/D");
-  ntuple_->Branch("muon_dz_bs", &muon_dz_bs_, "muon_dz_bs[nMuon]/D");
-  ntuple_->Branch("muon_dzError", &muon_dzError_, "muon_dzError[nMuon]/D");
-  ntuple_->Branch("muon_IPSig", &muon_IPSig_, "muon_IPSig[nMuon]/D");
-  ntuple_->Branch("muon_l1pt", &muon_l1pt_, "muon_l1pt[nMuon]/D");
-  ntuple_->Branch("muon_l1eta", &muon_l1eta_, "muon_l1eta[nMuon]/D");
-  ntuple_->Branch("muon_l1phi", &muon_l1phi_, "muon_l1phi[nMuon]/D");
-  ntuple_->Branch("muon_l1charge", &muon_l1charge_, "muon_l1charge[nMuon]/D");
-  ntuple_->Branch("muon_l1q", &muon_l1q_, "muon_l1q[nMuon]/I");
-  ntuple_->Branch("muon_l1dr", &muon_l1dr_, "muon_l1dr[nMuon]/D");
-  ntuple_->Branch("muon_l1ptByQ", &muon_l1ptByQ_, "muon_l1ptByQ[nMuon]/D");
-  ntuple_->Branch("muon_l1etaByQ", &muon_l1etaByQ_, "muon_l1etaByQ[nMuon]/D");
-  ntuple_->Branch("muon_l1phiByQ", &muon_l1phiByQ_, "muon_l1phiByQ[nMuon]/D");
-  ntuple_->Branch("muon_l1chargeByQ", &muon_l1chargeByQ_, "muon_l1chargeByQ[nMuon]/D");
-  ntuple_->Branch("muon_l1qByQ", &muon_l1qByQ_, "muon_l1qByQ[nMuon]/I");
-  ntuple_->Branch("muon_l1drByQ", &muon_l1drByQ_, "muon_l1drByQ[nMuon]/D");
-
-  ntuple_->Branch("muon_nl1t", &muon_nl1t_, "muon_nl1t[nMuon]/I");
-  ntuple_->Branch("muon_l1tpt", &muon_l1tpt_);
-  ntuple_->Branch("muon_l1teta", &muon_l1teta_);
-  ntuple_->Branch("muon_l1tpropeta", &muon_l1tpropeta_);
-  ntuple_->Branch("muon_l1tphi", &muon_l1tphi_);
-  ntuple_->Branch("muon_l1tpropphi", &muon_l1tpropphi_);
-  ntuple_->Branch("muon_l1tcharge", &muon_l1tcharge_);
-  ntuple_->Branch("muon_l1tq", &muon_l1tq_);
-  ntuple_->Branch("muon_l1tdr", &muon_l1tdr_);
-
-  ntuple_->Branch("nL3Muon", &nL3Muon_, "nL3Muon/I");
-  ntuple_->Branch("L3Muon_pt", &L3Muon_pt_, "L3Muon_pt[nL3Muon]/D");
-  ntuple_->Branch("L3Muon_eta", &L3Muon_eta_, "L3Muon_eta[nL3Muon]/D");
-  ntuple_->Branch("L3Muon_phi", &L3Muon_phi_, "L3Muon_phi[nL3Muon]/D");
-  ntuple_->Branch("L3Muon_charge", &L3Muon_charge_, "L3Muon_charge[nL3Muon]/D");
-  ntuple_->Branch("L3Muon_trkPt", &L3Muon_trkPt_, "L3Muon_trkPt[nL3Muon]/D");
-  ntuple_->Branch("L3Muon_ECALIso", &L3Muon_ECALIso_, "L3Muon_ECALIso[nL3Muon]/D");
-  ntuple_->Branch("L3Muon_HCALIso", &L3Muon_HCALIso_, "L3Muon_HCALIso[nL3Muon]/D");
-  ntuple_->Branch("L3Muon_trkIso",  &L3Muon_trkIso_,  "L3Muon_trkIso[nL3Muon]/D");
-
-  ntuple_->Branch("nL2Muon", &nL2Muon_, "nL2Muon/I");
-  ntuple_->Branch("L2Muon_pt", &L2Muon_pt_, "L2Muon_pt[nL2Muon]/D");
-  ntuple_->Branch("L2Muon_eta", &L2Muon_eta_, "L2Muon_eta[nL2Muon]/D");
-  ntuple_->Branch("L2Muon_phi", &L2Muon_phi_, "L2Muon_phi[nL2Muon]/D");
-  ntuple_->Branch("L2Muon_charge", &L2Muon_charge_, "L2Muon_charge[nL2Muon]/D");
-  ntuple_->Branch("L2Muon_trkPt", &L2Muon_trkPt_, "L2Muon_trkPt[nL2Muon]/D");
-
-  ntuple_->Branch("nTkMuon", &nTkMuon_, "nTkMuon/I");
-  ntuple_->Branch("TkMuon_pt", &TkMuon_pt_, "TkMuon_pt[nTkMuon]/D");
-  ntuple_->Branch("TkMuon_eta", &TkMuon_eta_, "TkMuon_eta[nTkMuon]/D");
-  ntuple_->Branch("TkMuon_phi", &TkMuon_phi_, "TkMuon_phi[nTkMuon]/D");
-  ntuple_->Branch("TkMuon_charge", &TkMuon_charge_, "TkMuon_charge[nTkMuon]/D");
-  ntuple_->Branch("TkMuon_trkPt", &TkMuon_trkPt_, "TkMuon_trkPt[nTkMuon]/D");
-
-  ntuple_->Branch("nL1Muon", &nL1Muon_, "nL1Muon/I");
-  ntuple_->Branch("L1Muon_pt", &L1Muon_pt_, "L1Muon_pt[nL1Muon]/D");
-  ntuple_->Branch("L1Muon_eta", &L1Muon_eta_, "L1Muon_eta[nL1Muon]/D");
-  ntuple_->Branch("L1Muon_phi", &L1Muon_phi_, "L1Muon_phi[nL1Muon]/D");
-  ntuple_->Branch("L1Muon_charge", &L1Muon_charge_, "L1Muon_charge[nL1Muon]/D");
-  ntuple_->Branch("L1Muon_quality", &L1Muon_quality_, "L1Muon_quality[nL1Muon]/D");
-  ntuple_->Branch("L1Muon_etaAtVtx", &L1Muon_etaAtVtx_, "L1Muon_etaAtVtx[nL1Muon]/D");
-  ntuple_->Branch("L1Muon_phiAtVtx", &L1Muon_phiAtVtx_, "L1Muon_phiAtVtx[nL1Muon]/D");
-
-  ntuple_->Branch("nIterL3OI", &nIterL3OI_, "nIterL3OI/I");
-  ntuple_->Branch("iterL3OI_inner_pt", &iterL3OI_inner_pt_, "iterL3OI_inner_pt[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_inner_eta", &iterL3OI_inner_eta_, "iterL3OI_inner_eta[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_inner_phi", &iterL3OI_inner_phi_, "iterL3OI_inner_phi[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_inner_charge", &iterL3OI_inner_charge_, "iterL3OI_inner_charge[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_inner_trkChi2", &iterL3OI_inner_trkChi2_, "iterL3OI_inner_trkChi2[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_inner_validFraction", &iterL3OI_inner_validFraction_, "iterL3OI_inner_validFraction[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_inner_trackerLayers", &iterL3OI_inner_trackerLayers_, "iterL3OI_inner_trackerLayers[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_trackerHits", &iterL3OI_inner_trackerHits_, "iterL3OI_inner_trackerHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_lostTrackerHits", &iterL3OI_inner_lostTrackerHits_, "iterL3OI_inner_lostTrackerHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_lostTrackerHitsIn", &iterL3OI_inner_lostTrackerHitsIn_, "iterL3OI_inner_lostTrackerHitsIn[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_lostTrackerHitsOut", &iterL3OI_inner_lostTrackerHitsOut_, "iterL3OI_inner_lostTrackerHitsOut[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_lostPixelHits", &iterL3OI_inner_lostPixelHits_, "iterL3OI_inner_lostPixelHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_lostPixelBarrelHits", &iterL3OI_inner_lostPixelBarrelHits_, "iterL3OI_inner_lostPixelBarrelHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_lostPixelEndcapHits", &iterL3OI_inner_lostPixelEndcapHits_, "iterL3OI_inner_lostPixelEndcapHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_lostStripHits", &iterL3OI_inner_lostStripHits_, "iterL3OI_inner_lostStripHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_lostStripTIBHits", &iterL3OI_inner_lostStripTIBHits_, "iterL3OI_inner_lostStripTIBHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_lostStripTIDHits", &iterL3OI_inner_lostStripTIDHits_, "iterL3OI_inner_lostStripTIDHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_lostStripTOBHits", &iterL3OI_inner_lostStripTOBHits_, "iterL3OI_inner_lostStripTOBHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_lostStripTECHits", &iterL3OI_inner_lostStripTECHits_, "iterL3OI_inner_lostStripTECHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_pixelLayers", &iterL3OI_inner_pixelLayers_, "iterL3OI_inner_pixelLayers[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_inner_pixelHits", &iterL3OI_inner_pixelHits_, "iterL3OI_inner_pixelHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_outer_pt", &iterL3OI_outer_pt_, "iterL3OI_outer_pt[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_outer_eta", &iterL3OI_outer_eta_, "iterL3OI_outer_eta[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_outer_phi", &iterL3OI_outer_phi_, "iterL3OI_outer_phi[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_outer_charge", &iterL3OI_outer_charge_, "iterL3OI_outer_charge[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_global_pt", &iterL3OI_global_pt_, "iterL3OI_global_pt[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_global_eta", &iterL3OI_global_eta_, "iterL3OI_global_eta[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_global_phi", &iterL3OI_global_phi_, "iterL3OI_global_phi[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_global_charge", &iterL3OI_global_charge_, "iterL3OI_global_charge[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_global_muonHits", &iterL3OI_global_muonHits_, "iterL3OI_global_muonHits[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_global_trkChi2", &iterL3OI_global_trkChi2_, "iterL3OI_global_trkChi2[nIterL3OI]/D");
-  ntuple_->Branch("iterL3OI_global_trackerLayers", &iterL3OI_global_trackerLayers_, "iterL3OI_global_trackerLayers[nIterL3OI]/I");
-  ntuple_->Branch("iterL3OI_global_trackerHits", &iterL3OI_global_trackerHits_, "iterL3OI_global_trackerHits[nIterL3OI]/I");
-
-  ntuple_->Branch("nIterL3IOFromL2", &nIterL3IOFromL2_, "nIterL3IOFromL2/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_pt", &iterL3IOFromL2_inner_pt_, "iterL3IOFromL2_inner_pt[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_inner_eta", &iterL3IOFromL2_inner_eta_, "iterL3IOFromL2_inner_eta[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_inner_phi", &iterL3IOFromL2_inner_phi_, "iterL3IOFromL2_inner_phi[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_inner_charge", &iterL3IOFromL2_inner_charge_, "iterL3IOFromL2_inner_charge[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_inner_trkChi2", &iterL3IOFromL2_inner_trkChi2_, "iterL3IOFromL2_inner_trkChi2[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_inner_validFraction", &iterL3IOFromL2_inner_validFraction_, "iterL3IOFromL2_inner_validFraction[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_inner_trackerLayers", &iterL3IOFromL2_inner_trackerLayers_, "iterL3IOFromL2_inner_trackerLayers[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_trackerHits", &iterL3IOFromL2_inner_trackerHits_, "iterL3IOFromL2_inner_trackerHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_lostTrackerHits", &iterL3IOFromL2_inner_lostTrackerHits_, "iterL3IOFromL2_inner_lostTrackerHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_lostTrackerHitsIn", &iterL3IOFromL2_inner_lostTrackerHitsIn_, "iterL3IOFromL2_inner_lostTrackerHitsIn[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_lostTrackerHitsOut", &iterL3IOFromL2_inner_lostTrackerHitsOut_, "iterL3IOFromL2_inner_lostTrackerHitsOut[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_lostPixelHits", &iterL3IOFromL2_inner_lostPixelHits_, "iterL3IOFromL2_inner_lostPixelHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_lostPixelBarrelHits", &iterL3IOFromL2_inner_lostPixelBarrelHits_, "iterL3IOFromL2_inner_lostPixelBarrelHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_lostPixelEndcapHits", &iterL3IOFromL2_inner_lostPixelEndcapHits_, "iterL3IOFromL2_inner_lostPixelEndcapHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_lostStripHits", &iterL3IOFromL2_inner_lostStripHits_, "iterL3IOFromL2_inner_lostStripHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_lostStripTIBHits", &iterL3IOFromL2_inner_lostStripTIBHits_, "iterL3IOFromL2_inner_lostStripTIBHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_lostStripTIDHits", &iterL3IOFromL2_inner_lostStripTIDHits_, "iterL3IOFromL2_inner_lostStripTIDHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_lostStripTOBHits", &iterL3IOFromL2_inner_lostStripTOBHits_, "iterL3IOFromL2_inner_lostStripTOBHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_lostStripTECHits", &iterL3IOFromL2_inner_lostStripTECHits_, "iterL3IOFromL2_inner_lostStripTECHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_pixelLayers", &iterL3IOFromL2_inner_pixelLayers_, "iterL3IOFromL2_inner_pixelLayers[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_inner_pixelHits", &iterL3IOFromL2_inner_pixelHits_, "iterL3IOFromL2_inner_pixelHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_outer_pt", &iterL3IOFromL2_outer_pt_, "iterL3IOFromL2_outer_pt[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_outer_eta", &iterL3IOFromL2_outer_eta_, "iterL3IOFromL2_outer_eta[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_outer_phi", &iterL3IOFromL2_outer_phi_, "iterL3IOFromL2_outer_phi[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_outer_charge", &iterL3IOFromL2_outer_charge_, "iterL3IOFromL2_outer_charge[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_global_pt", &iterL3IOFromL2_global_pt_, "iterL3IOFromL2_global_pt[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_global_eta", &iterL3IOFromL2_global_eta_, "iterL3IOFromL2_global_eta[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_global_phi", &iterL3IOFromL2_global_phi_, "iterL3IOFromL2_global_phi[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_global_charge", &iterL3IOFromL2_global_charge_, "iterL3IOFromL2_global_charge[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_global_muonHits", &iterL3IOFromL2_global_muonHits_, "iterL3IOFromL2_global_muonHits[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_global_trkChi2", &iterL3IOFromL2_global_trkChi2_, "iterL3IOFromL2_global_trkChi2[nIterL3IOFromL2]/D");
-  ntuple_->Branch("iterL3IOFromL2_global_trackerLayers", &iterL3IOFromL2_global_trackerLayers_, "iterL3IOFromL2_global_trackerLayers[nIterL3IOFromL2]/I");
-  ntuple_->Branch("iterL3IOFromL2_global_trackerHits", &iterL3IOFromL2_global_trackerHits_, "iterL3IOFromL2_global_trackerHits[nIterL3IOFromL2]/I");
-
-  ntuple_->Branch("nIterL3FromL2", &nIterL3FromL2_, "nIterL3FromL2/I");
-  ntuple_->Branch("iterL3FromL2_inner_pt", &iterL3FromL2_inner_pt_, "iterL3FromL2_inner_pt[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_inner_eta", &iterL3FromL2_inner_eta_, "iterL3FromL2_inner_eta[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_inner_phi", &iterL3FromL2_inner_phi_, "iterL3FromL2_inner_phi[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_inner_charge", &iterL3FromL2_inner_charge_, "iterL3FromL2_inner_charge[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_inner_trkChi2", &iterL3FromL2_inner_trkChi2_, "iterL3FromL2_inner_trkChi2[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_inner_validFraction", &iterL3FromL2_inner_validFraction_, "iterL3FromL2_inner_validFraction[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_inner_trackerLayers", &iterL3FromL2_inner_trackerLayers_, "iterL3FromL2_inner_trackerLayers[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_trackerHits", &iterL3FromL2_inner_trackerHits_, "iterL3FromL2_inner_trackerHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_lostTrackerHits", &iterL3FromL2_inner_lostTrackerHits_, "iterL3FromL2_inner_lostTrackerHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_lostTrackerHitsIn", &iterL3FromL2_inner_lostTrackerHitsIn_, "iterL3FromL2_inner_lostTrackerHitsIn[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_lostTrackerHitsOut", &iterL3FromL2_inner_lostTrackerHitsOut_, "iterL3FromL2_inner_lostTrackerHitsOut[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_lostPixelHits", &iterL3FromL2_inner_lostPixelHits_, "iterL3FromL2_inner_lostPixelHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_lostPixelBarrelHits", &iterL3FromL2_inner_lostPixelBarrelHits_, "iterL3FromL2_inner_lostPixelBarrelHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_lostPixelEndcapHits", &iterL3FromL2_inner_lostPixelEndcapHits_, "iterL3FromL2_inner_lostPixelEndcapHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_lostStripHits", &iterL3FromL2_inner_lostStripHits_, "iterL3FromL2_inner_lostStripHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_lostStripTIBHits", &iterL3FromL2_inner_lostStripTIBHits_, "iterL3FromL2_inner_lostStripTIBHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_lostStripTIDHits", &iterL3FromL2_inner_lostStripTIDHits_, "iterL3FromL2_inner_lostStripTIDHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_lostStripTOBHits", &iterL3FromL2_inner_lostStripTOBHits_, "iterL3FromL2_inner_lostStripTOBHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_lostStripTECHits", &iterL3FromL2_inner_lostStripTECHits_, "iterL3FromL2_inner_lostStripTECHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_pixelLayers", &iterL3FromL2_inner_pixelLayers_, "iterL3FromL2_inner_pixelLayers[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_inner_pixelHits", &iterL3FromL2_inner_pixelHits_, "iterL3FromL2_inner_pixelHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_outer_pt", &iterL3FromL2_outer_pt_, "iterL3FromL2_outer_pt[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_outer_eta", &iterL3FromL2_outer_eta_, "iterL3FromL2_outer_eta[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_outer_phi", &iterL3FromL2_outer_phi_, "iterL3FromL2_outer_phi[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_outer_charge", &iterL3FromL2_outer_charge_, "iterL3FromL2_outer_charge[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_global_pt", &iterL3FromL2_global_pt_, "iterL3FromL2_global_pt[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_global_eta", &iterL3FromL2_global_eta_, "iterL3FromL2_global_eta[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_global_phi", &iterL3FromL2_global_phi_, "iterL3FromL2_global_phi[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_global_charge", &iterL3FromL2_global_charge_, "iterL3FromL2_global_charge[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_global_muonHits", &iterL3FromL2_global_muonHits_, "iterL3FromL2_global_muonHits[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_global_trkChi2", &iterL3FromL2_global_trkChi2_, "iterL3FromL2_global_trkChi2[nIterL3FromL2]/D");
-  ntuple_->Branch("iterL3FromL2_global_trackerLayers", &iterL3FromL2_global_trackerLayers_, "iterL3FromL2_global_trackerLayers[nIterL3FromL2]/I");
-  ntuple_->Branch("iterL3FromL2_global_trackerHits", &iterL3FromL2_global_trackerHits_, "iterL3FromL2_global_trackerHits[nIterL3FromL2]/I");
-
-  ntuple_->Branch("nIterL3IOFromL1", &nIterL3IOFromL1_, "nIterL3IOFromL1/I");
-  ntuple_->Branch("iterL3IOFromL1_pt", &iterL3IOFromL1_pt_, "iterL3IOFromL1_pt[nIterL3IOFromL1]/D");
-  ntuple_->Branch("iterL3IOFromL1_eta", &iterL3IOFromL1_eta_, "iterL3IOFromL1_eta[nIterL3IOFromL1]/D");
-  ntuple_->Branch("iterL3IOFromL1_phi", &iterL3IOFromL1_phi_, "iterL3IOFromL1_phi[nIterL3IOFromL1]/D");
-  ntuple_->Branch("iterL3IOFromL1_charge", &iterL3IOFromL1_charge_, "iterL3IOFromL1_charge[nIterL3IOFromL1]/D");
-  ntuple_->Branch("iterL3IOFromL1_muonHits", &iterL3IOFromL1_muonHits_, "iterL3IOFromL1_muonHits[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_trkChi2", &iterL3IOFromL1_trkChi2_, "iterL3IOFromL1_trkChi2[nIterL3IOFromL1]/D");
-  ntuple_->Branch("iterL3IOFromL1_validFraction", &iterL3IOFromL1_validFraction_, "iterL3IOFromL1_validFraction[nIterL3IOFromL1]/D");
-  ntuple_->Branch("iterL3IOFromL1_trackerLayers", &iterL3IOFromL1_trackerLayers_, "iterL3IOFromL1_trackerLayers[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_trackerHits", &iterL3IOFromL1_trackerHits_, "iterL3IOFromL1_trackerHits[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_lostTrackerHits", &iterL3IOFromL1_lostTrackerHits_, "iterL3IOFromL1_lostTrackerHits[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_lostTrackerHitsIn", &iterL3IOFromL1_lostTrackerHitsIn_, "iterL3IOFromL1_lostTrackerHitsIn[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_lostTrackerHitsOut", &iterL3IOFromL1_lostTrackerHitsOut_, "iterL3IOFromL1_lostTrackerHitsOut[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_lostPixelHits", &iterL3IOFromL1_lostPixelHits_, "iterL3IOFromL1_lostPixelHits[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_lostPixelBarrelHits", &iterL3IOFromL1_lostPixelBarrelHits_, "iterL3IOFromL1_lostPixelBarrelHits[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_lostPixelEndcapHits", &iterL3IOFromL1_lostPixelEndcapHits_, "iterL3IOFromL1_lostPixelEndcapHits[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_lostStripHits", &iterL3IOFromL1_lostStripHits_, "iterL3IOFromL1_lostStripHits[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_lostStripTIBHits", &iterL3IOFromL1_lostStripTIBHits_, "iterL3IOFromL1_lostStripTIBHits[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_lostStripTIDHits", &iterL3IOFromL1_lostStripTIDHits_, "iterL3IOFromL1_lostStripTIDHits[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_lostStripTOBHits", &iterL3IOFromL1_lostStripTOBHits_, "iterL3IOFromL1_lostStripTOBHits[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_lostStripTECHits", &iterL3IOFromL1_lostStripTECHits_, "iterL3IOFromL1_lostStripTECHits[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_pixelLayers", &iterL3IOFromL1_pixelLayers_, "iterL3IOFromL1_pixelLayers[nIterL3IOFromL1]/I");
-  ntuple_->Branch("iterL3IOFromL1_pixelHits", &iterL3IOFromL1_pixelHits_, "iterL3IOFromL1_pixelHits[nIterL3IOFromL1]/I");
-
-  ntuple_->Branch("nIterL3MuonNoID",       &nIterL3MuonNoID_,       "nIterL3MuonNoID/I");
-  ntuple_->Branch("iterL3MuonNoID_pt",     &iterL3MuonNoID_pt_,     "iterL3MuonNoID_pt[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_innerPt",     &iterL3MuonNoID_innerPt_,     "iterL3MuonNoID_innerPt[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_eta",    &iterL3MuonNoID_eta_,    "iterL3MuonNoID_eta[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_phi",    &iterL3MuonNoID_phi_,    "iterL3MuonNoID_phi[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_charge", &iterL3MuonNoID_charge_, "iterL3MuonNoID_charge[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_isGLB",  &iterL3MuonNoID_isGLB_,  "iterL3MuonNoID_isGLB[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_isSTA",  &iterL3MuonNoID_isSTA_,  "iterL3MuonNoID_isSTA[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_isTRK",  &iterL3MuonNoID_isTRK_,  "iterL3MuonNoID_isTRK[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_trkChi2", &iterL3MuonNoID_inner_trkChi2_, "iterL3MuonNoID_inner_trkChi2[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_inner_validFraction", &iterL3MuonNoID_inner_validFraction_, "iterL3MuonNoID_inner_validFraction[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_inner_trackerLayers", &iterL3MuonNoID_inner_trackerLayers_, "iterL3MuonNoID_inner_trackerLayers[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_trackerHits", &iterL3MuonNoID_inner_trackerHits_, "iterL3MuonNoID_inner_trackerHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_lostTrackerHits", &iterL3MuonNoID_inner_lostTrackerHits_, "iterL3MuonNoID_inner_lostTrackerHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_lostTrackerHitsIn", &iterL3MuonNoID_inner_lostTrackerHitsIn_, "iterL3MuonNoID_inner_lostTrackerHitsIn[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_lostTrackerHitsOut", &iterL3MuonNoID_inner_lostTrackerHitsOut_, "iterL3MuonNoID_inner_lostTrackerHitsOut[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_lostPixelHits", &iterL3MuonNoID_inner_lostPixelHits_, "iterL3MuonNoID_inner_lostPixelHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_lostPixelBarrelHits", &iterL3MuonNoID_inner_lostPixelBarrelHits_, "iterL3MuonNoID_inner_lostPixelBarrelHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_lostPixelEndcapHits", &iterL3MuonNoID_inner_lostPixelEndcapHits_, "iterL3MuonNoID_inner_lostPixelEndcapHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_lostStripHits", &iterL3MuonNoID_inner_lostStripHits_, "iterL3MuonNoID_inner_lostStripHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_lostStripTIBHits", &iterL3MuonNoID_inner_lostStripTIBHits_, "iterL3MuonNoID_inner_lostStripTIBHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_lostStripTIDHits", &iterL3MuonNoID_inner_lostStripTIDHits_, "iterL3MuonNoID_inner_lostStripTIDHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_lostStripTOBHits", &iterL3MuonNoID_inner_lostStripTOBHits_, "iterL3MuonNoID_inner_lostStripTOBHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_lostStripTECHits", &iterL3MuonNoID_inner_lostStripTECHits_, "iterL3MuonNoID_inner_lostStripTECHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_pixelLayers", &iterL3MuonNoID_inner_pixelLayers_, "iterL3MuonNoID_inner_pixelLayers[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_inner_pixelHits", &iterL3MuonNoID_inner_pixelHits_, "iterL3MuonNoID_inner_pixelHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_global_muonHits", &iterL3MuonNoID_global_muonHits_, "iterL3MuonNoID_global_muonHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_global_trkChi2", &iterL3MuonNoID_global_trkChi2_, "iterL3MuonNoID_global_trkChi2[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_global_trackerLayers", &iterL3MuonNoID_global_trackerLayers_, "iterL3MuonNoID_global_trackerLayers[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_global_trackerHits", &iterL3MuonNoID_global_trackerHits_, "iterL3MuonNoID_global_trackerHits[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_momentumChi2", &iterL3MuonNoID_momentumChi2_, "iterL3MuonNoID_momentumChi2[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_positionChi2", &iterL3MuonNoID_positionChi2_, "iterL3MuonNoID_positionChi2[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_glbKink", &iterL3MuonNoID_glbKink_, "iterL3MuonNoID_glbKink[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_glbTrackProbability", &iterL3MuonNoID_glbTrackProbability_, "iterL3MuonNoID_glbTrackProbability[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_globalDeltaEtaPhi", &iterL3MuonNoID_globalDeltaEtaPhi_, "iterL3MuonNoID_globalDeltaEtaPhi[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_localDistance", &iterL3MuonNoID_localDistance_, "iterL3MuonNoID_localDistance[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_staRelChi2", &iterL3MuonNoID_staRelChi2_, "iterL3MuonNoID_staRelChi2[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_tightMatch", &iterL3MuonNoID_tightMatch_, "iterL3MuonNoID_tightMatch[nIterL3MuonNoID]/I");
-  ntuple_->Branch("iterL3MuonNoID_trkKink", &iterL3MuonNoID_trkKink_, "iterL3MuonNoID_trkKink[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_trkRelChi2", &iterL3MuonNoID_trkRelChi2_, "iterL3MuonNoID_trkRelChi2[nIterL3MuonNoID]/D");
-  ntuple_->Branch("iterL3MuonNoID_segmentCompatibility", &iterL3MuonNoID_segmentCompatibility_, "iterL3MuonNoID_segmentCompatibility[nIterL3MuonNoID]/D");
-
-  ntuple_->Branch("nIterL3Muon",       &nIterL3Muon_,       "nIterL3Muon/I");
-  ntuple_->Branch("iterL3Muon_pt",     &iterL3Muon_pt_,     "iterL3Muon_pt[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_innerPt", &iterL3Muon_innerPt_, "iterL3Muon_innerPt[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_eta",    &iterL3Muon_eta_,    "iterL3Muon_eta[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_phi",    &iterL3Muon_phi_,    "iterL3Muon_phi[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_charge", &iterL3Muon_charge_, "iterL3Muon_charge[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_isGLB",  &iterL3Muon_isGLB_,  "iterL3Muon_isGLB[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_isSTA",  &iterL3Muon_isSTA_,  "iterL3Muon_isSTA[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_isTRK",  &iterL3Muon_isTRK_,  "iterL3Muon_isTRK[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_trkChi2", &iterL3Muon_inner_trkChi2_, "iterL3Muon_inner_trkChi2[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_inner_validFraction", &iterL3Muon_inner_validFraction_, "iterL3Muon_inner_validFraction[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_inner_trackerLayers", &iterL3Muon_inner_trackerLayers_, "iterL3Muon_inner_trackerLayers[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_trackerHits", &iterL3Muon_inner_trackerHits_, "iterL3Muon_inner_trackerHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_lostTrackerHits", &iterL3Muon_inner_lostTrackerHits_, "iterL3Muon_inner_lostTrackerHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_lostTrackerHitsIn", &iterL3Muon_inner_lostTrackerHitsIn_, "iterL3Muon_inner_lostTrackerHitsIn[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_lostTrackerHitsOut", &iterL3Muon_inner_lostTrackerHitsOut_, "iterL3Muon_inner_lostTrackerHitsOut[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_lostPixelHits", &iterL3Muon_inner_lostPixelHits_, "iterL3Muon_inner_lostPixelHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_lostPixelBarrelHits", &iterL3Muon_inner_lostPixelBarrelHits_, "iterL3Muon_inner_lostPixelBarrelHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_lostPixelEndcapHits", &iterL3Muon_inner_lostPixelEndcapHits_, "iterL3Muon_inner_lostPixelEndcapHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_lostStripHits", &iterL3Muon_inner_lostStripHits_, "iterL3Muon_inner_lostStripHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_lostStripTIBHits", &iterL3Muon_inner_lostStripTIBHits_, "iterL3Muon_inner_lostStripTIBHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_lostStripTIDHits", &iterL3Muon_inner_lostStripTIDHits_, "iterL3Muon_inner_lostStripTIDHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_lostStripTOBHits", &iterL3Muon_inner_lostStripTOBHits_, "iterL3Muon_inner_lostStripTOBHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_lostStripTECHits", &iterL3Muon_inner_lostStripTECHits_, "iterL3Muon_inner_lostStripTECHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_pixelLayers", &iterL3Muon_inner_pixelLayers_, "iterL3Muon_inner_pixelLayers[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_inner_pixelHits", &iterL3Muon_inner_pixelHits_, "iterL3Muon_inner_pixelHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_global_muonHits", &iterL3Muon_global_muonHits_, "iterL3Muon_global_muonHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_global_trkChi2", &iterL3Muon_global_trkChi2_, "iterL3Muon_global_trkChi2[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_global_trackerLayers", &iterL3Muon_global_trackerLayers_, "iterL3Muon_global_trackerLayers[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_global_trackerHits", &iterL3Muon_global_trackerHits_, "iterL3Muon_global_trackerHits[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_momentumChi2", &iterL3Muon_momentumChi2_, "iterL3Muon_momentumChi2[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_positionChi2", &iterL3Muon_positionChi2_, "iterL3Muon_positionChi2[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_glbKink", &iterL3Muon_glbKink_, "iterL3Muon_glbKink[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_glbTrackProbability", &iterL3Muon_glbTrackProbability_, "iterL3Muon_glbTrackProbability[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_globalDeltaEtaPhi", &iterL3Muon_globalDeltaEtaPhi_, "iterL3Muon_globalDeltaEtaPhi[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_localDistance", &iterL3Muon_localDistance_, "iterL3Muon_localDistance[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_staRelChi2", &iterL3Muon_staRelChi2_, "iterL3Muon_staRelChi2[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_tightMatch", &iterL3Muon_tightMatch_, "iterL3Muon_tightMatch[nIterL3Muon]/I");
-  ntuple_->Branch("iterL3Muon_trkKink", &iterL3Muon_trkKink_, "iterL3Muon_trkKink[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_trkRelChi2", &iterL3Muon_trkRelChi2_, "iterL3Muon_trkRelChi2[nIterL3Muon]/D");
-  ntuple_->Branch("iterL3Muon_segmentCompatibility", &iterL3Muon_segmentCompatibility_, "iterL3Muon_segmentCompatibility[nIterL3Muon]/D");
-
-  TrkParticle->setBranch(ntuple_,"TP");
-
-  VThltIterL3MuonTrimmedPixelVertices->setBranch(ntuple_,"hltIterL3MuonTrimmedPixelVertices");
-  VThltIterL3FromL1MuonTrimmedPixelVertices->setBranch(ntuple_,"hltIterL3FromL1MuonTrimmedPixelVertices");
+  if( writeGroup("event") ) {
+    ntuple_->Branch("rho_ECAL", &rho_ECAL_, "rho_ECAL/D");
+    ntuple_->Branch("rho_HCAL", &rho_HCAL_, "rho_HCAL/D");
+  }
 
-  for( unsigned int i = 0; i < trackCollectionNames_.size(); ++i) {
-    TString trkName = TString(trackCollectionNames_.at(i));
-    TString tpName  = "tpTo_" + TString(trackCollectionNames_.at(i));
+  if( writeGroup("gen") ) {
+    ntuple_->Branch("genEventWeight", &genEventWeight_, "genEventWeight/D");
+    ntuple_->Branch("nGenParticle", &nGenParticle_, "nGenParticle/I");
+    ntuple_->Branch("genParticle_ID", &genParticle_ID_, "genParticle_ID[nGenParticle]/I");
+    ntuple_->Branch("genParticle_status", &genParticle_status_, "genParticle_status[nGenParticle]/I");
+    ntuple_->Branch("genParticle_mother", &genParticle_mother_, "genParticle_mother[nGenParticle]/I");
+    ntuple_->Branch("genParticle_pt", &genParticle_pt_, "genParticle_pt[nGenParticle]/D");
+    ntuple_->Branch("genParticle_eta", &genParticle_eta_, "genParticle_eta[nGenParticle]/D");
+    ntuple_->Branch("genParticle_phi", &genParticle_phi_, "genParticle_phi[nGenParticle]/D");
+    ntuple_->Branch("genParticle_px", &genParticle_px_, "genParticle_px[nGenParticle]/D");
+    ntuple_->Branch("genParticle_py", &genParticle_py_, "genParticle_py[nGenParticle]/D");
+    ntuple_->Branch("genParticle_pz", &genParticle_pz_, "genParticle_pz[nGenParticle]/D");
+    ntuple_->Branch("genParticle_energy", &genParticle_energy_, "genParticle_energy[nGenParticle]/D");
+    ntuple_->Branch("genParticle_charge", &genParticle_charge_, "genParticle_charge[nGenParticle]/D");
+    ntuple_->Branch("genParticle_isPrompt", &genParticle_isPrompt_, "genParticle_isPrompt[nGenParticle]/I");
+    ntuple_->Branch("genParticle_isPromptFinalState", &genParticle_isPromptFinalState_, "genParticle_isPromptFinalState[nGenParticle]/I");
+    ntuple_->Branch("genParticle_isTauDecayProduct", &genParticle_isTauDecayProduct_, "genParticle_isTauDecayProduct[nGenParticle]/I");
+    ntuple_->Branch("genParticle_isPromptTauDecayProduct", &genParticle_isPromptTauDecayProduct_, "genParticle_isPromptTauDecayProduct[nGenParticle]/I");
+    ntuple_->Branch("genParticle_isDirectPromptTauDecayProductFinalState", &genParticle_isDirectPromptTauDecayProductFinalState_, "genParticle_isDirectPromptTauDecayProductFinalState[nGenParticle]/I");
+    ntuple_->Branch("genParticle_isHardProcess", &genParticle_isHardProcess_, "genParticle_isHardProcess[nGenParticle]/I");
+    ntuple_->Branch("genParticle_isLastCopy", &genParticle_isLastCopy_, "genParticle_isLastCopy[nGenParticle]/I");
+    ntuple_->Branch("genParticle_isLastCopyBeforeFSR", &genParticle_isLastCopyBeforeFSR_, "genParticle_isLastCopyBeforeFSR[nGenParticle]/I");
+    ntuple_->Branch("genParticle_isPromptDecayed", &genParticle_isPromptDecayed_, "genParticle_isPromptDecayed[nGenParticle]/I");
+    ntuple_->Branch("genParticle_isDecayedLeptonHadron", &genParticle_isDecayedLeptonHadron_, "genParticle_isDecayedLeptonHadron[nGenParticle]/I");
+    ntuple_->Branch("genParticle_fromHardProcessBeforeFSR", &genParticle_fromHardProcessBeforeFSR_, "genParticle_fromHardProcessBeforeFSR[nGenParticle]/I");
+    ntuple_->Branch("genParticle_fromHardProcessDecayed", &genParticle_fromHardProcessDecayed_, "genParticle_fromHardProcessDecayed[nGenParticle]/I");
+    ntuple_->Branch("genParticle_fromHardProcessFinalState", &genParticle_fromHardProcessFinalState_, "genParticle_fromHardProcessFinalState[nGenParticle]/I");
+    ntuple_->Branch("genParticle_isMostlyLikePythia6Status3", &genParticle_isMostlyLikePythia6Status3_, "genParticle_isMostlyLikePythia6Status3[nGenParticle]/I");
+    ntuple_->Branch("genParticle_l1pt", &genParticle_l1pt_, "genParticle_l1pt[nGenParticle]/D");
+    ntuple_->Branch("genParticle_l1eta", &genParticle_l1eta_, "genParticle_l1eta[nGenParticle]/D");
+    ntuple_->Branch("genParticle_l1phi", &genParticle_l1phi_, "genParticle_l1phi[nGenParticle]/D");
+    ntuple_->Branch("genParticle_l1charge", &genParticle_l1charge_, "genParticle_l1charge[nGenParticle]/D");
+    ntuple_->Branch("genParticle_l1q", &genParticle_l1q_, "genParticle_l1q[nGenParticle]/I");
+    ntuple_->Branch("genParticle_l1dr", &genParticle_l1dr_, "genParticle_l1dr[nGenParticle]/D");
+    ntuple_->Branch("genParticle_l1ptByQ", &genParticle_l1ptByQ_, "genParticle_l1ptByQ[nGenParticle]/D");
+    ntuple_->Branch("genParticle_l1etaByQ", &genParticle_l1etaByQ_, "genParticle_l1etaByQ[nGenParticle]/D");
+    ntuple_->Branch("genParticle_l1phiByQ", &genParticle_l1phiByQ_, "genParticle_l1phiByQ[nGenParticle]/D");
+    ntuple_->Branch("genParticle_l1chargeByQ", &genParticle_l1chargeByQ_, "genParticle_l1chargeByQ[nGenParticle]/D");
+    ntuple_->Branch("genParticle_l1qByQ", &genParticle_l1qByQ_, "genParticle_l1qByQ[nGenParticle]/I");
+    ntuple_->Branch("genParticle_l1drByQ", &genParticle_l1drByQ_, "genParticle_l1drByQ[nGenParticle]/D");
+  }
+
+  if( writeGroup("HLT") ) {
+    ntuple_->Branch("vec_firedTrigger", &vec_firedTrigger_);
+    ntuple_->Branch("vec_filterName", &vec_filterName_);
+    ntuple_->Branch("vec_HLTObj_pt", &vec_HLTObj_pt_);
+    ntuple_->Branch("vec_HLTObj_eta", &vec_HLTObj_eta_);
+    ntuple_->Branch("vec_HLTObj_phi", &vec_HLTObj_phi_);
+  }
+
+  if( writeGroup("MYHLT") ) {
+    ntuple_->Branch("vec_myFiredTrigger", &vec_myFiredTrigger_);
+    ntuple_->Branch("vec_myFilterName", &vec_myFilterName_);
+    ntuple_->Branch("vec_myHLTObj_pt", &vec_myHLTObj_pt_);
+    ntuple_->Branch("vec_myHLTObj_eta", &vec_myHLTObj_eta_);
+    ntuple_->Branch("vec_myHLTObj_phi", &vec_myHLTObj_phi_);
+  }
+
+  if( writeGroup("variants") ) {
+    for( auto& V : menuVariants_ ) {
+      ntuple_->Branch(("vec_"+V.name+"_firedTrigger").c_str(), &V.firedTrigger);
+      ntuple_->Branch(("vec_"+V.name+"_filterName").c_str(), &V.filterName);
+      ntuple_->Branch(("vec_"+V.name+"_HLTObj_pt").c_str(), &V.HLTObj_pt);
+      ntuple_->Branch(("vec_"+V.name+"_HLTObj_eta").c_str(), &V.HLTObj_eta);
+      ntuple_->Branch(("vec_"+V.name+"_HLTObj_phi").c_str(), &V.HLTObj_phi);
+      if( V.hasIterL3Muon ) {
+        ntuple_->Branch(("vec_"+V.name+"_iterL3Muon_pt").c_str(), &V.iterL3Muon_pt);
+        ntuple_->Branch(("vec_"+V.name+"_iterL3Muon_eta").c_str(), &V.iterL3Muon_eta);
+        ntuple_->Branch(("vec_"+V.name+"_iterL3Muon_phi").c_str(), &V.iterL3Muon_phi);
+      }
+    }
+  }
+
+  if( writeGroup("muon") ) {
+    ntuple_->Branch("nMuon", &nMuon_, "nMuon/I");
+
+    ntuple_->Branch("muon_pt", &muon_pt_, "muon_pt[nMuon]/D");
+    ntuple_->Branch("muon_eta", &muon_eta_, "muon_eta[nMuon]/D");
+    ntuple_->Branch("muon_phi", &muon_phi_, "muon_phi[nMuon]/D");
+    ntuple_->Branch("muon_px", &muon_px_, "muon_px[nMuon]/D");
+    ntuple_->Branch("muon_py", &muon_py_, "muon_py[nMuon]/D");
+    ntuple_->Branch("muon_pz", &muon_pz_, "muon_pz[nMuon]/D");
+    ntuple_->Branch("muon_dB", &muon_dB_, "muon_dB[nMuon]/D");
+    ntuple_->Branch("muon_charge", &muon_charge_, "muon_charge[nMuon]/D");
+    ntuple_->Branch("muon_isGLB", &muon_isGLB_, "muon_isGLB[nMuon]/I");
+    ntuple_->Branch("muon_isSTA", &muon_isSTA_, "muon_isSTA[nMuon]/I");
+    ntuple_->Branch("muon_isTRK", &muon_isTRK_, "muon_isTRK[nMuon]/I");
+    ntuple_->Branch("muon_isPF", &muon_isPF_, "muon_isPF[nMuon]/I");
+    ntuple_->Branch("muon_isTight", &muon_isTight_, "muon_isTight[nMuon]/I");
+    ntuple_->Branch("muon_isMedium", &muon_isMedium_, "muon_isMedium[nMuon]/I");
+    ntuple_->Branch("muon_isLoose", &muon_isLoose_, "muon_isLoose[nMuon]/I");
+    ntuple_->Branch("muon_isHighPt", &muon_isHighPt_, "muon_isHighPt[nMuon]/I");
+    ntuple_->Branch("muon_isHighPtNew", &muon_isHighPtNew_, "muon_isHighPtNew[nMuon]/I");
+    ntuple_->Branch("muon_isSoft", &muon_isSoft_, "muon_isSoft[nMuon]/I");
+    if( doMuonSelectorBits_ )
+      ntuple_->Branch("muon_selectorBits", &muon_selectorBits_, "muon_selectorBits[nMuon]/i");
+
+    ntuple_->Branch("muon_iso03_sumPt", &muon_iso03_sumPt_, "muon_iso03_sumPt[nMuon]/D");
+    ntuple_->Branch("muon_iso03_hadEt", &muon_iso03_hadEt_, "muon_iso03_hadEt[nMuon]/D");
+    ntuple_->Branch("muon_iso03_emEt", &muon_iso03_emEt_, "muon_iso03_emEt[nMuon]/D");
+    ntuple_->Branch("muon_PFIso03_charged", &muon_PFIso03_charged_, "muon_PFIso03_charged[nMuon]/D");
+    ntuple_->Branch("muon_PFIso03_neutral", &muon_PFIso03_neutral_, "muon_PFIso03_neutral[nMuon]/D");
+    ntuple_->Branch("muon_PFIso03_photon", &muon_PFIso03_photon_, "muon_PFIso03_photon[nMuon]/D");
+    ntuple_->Branch("muon_PFIso03_sumPU", &muon_PFIso03_sumPU_, "muon_PFIso03_sumPU[nMuon]/D");
+    ntuple_->Branch("muon_PFIso04_charged", &muon_PFIso04_charged_, "muon_PFIso04_charged[nMuon]/D");
+    ntuple_->Branch("muon_PFIso04_neutral", &muon_PFIso04_neutral_, "muon_PFIso04_neutral[nMuon]/D");
+    ntuple_->Branch("muon_PFIso04_photon", &muon_PFIso04_photon_, "muon_PFIso04_photon[nMuon]/D");
+    ntuple_->Branch("muon_PFIso04_sumPU", &muon_PFIso04_sumPU_, "muon_PFIso04_sumPU[nMuon]/D");
+
+    ntuple_->Branch("muon_PFCluster03_ECAL", &muon_PFCluster03_ECAL_, "muon_PFCluster03_ECAL[nMuon]/D");
+    ntuple_->Branch("muon_PFCluster03_HCAL", &muon_PFCluster03_HCAL_, "muon_PFCluster03_HCAL[nMuon]/D");
+    ntuple_->Branch("muon_PFCluster04_ECAL", &muon_PFCluster04_ECAL_, "muon_PFCluster04_ECAL[nMuon]/D");
+    ntuple_->Branch("muon_PFCluster04_HCAL", &muon_PFCluster04_HCAL_, "muon_PFCluster04_HCAL[nMuon]/D");
+    ntuple_->Branch("muon_inner_trkChi2", &muon_inner_trkChi2_, "muon_inner_trkChi2[nMuon]/D");
+    ntuple_->Branch("muon_inner_validFraction", &muon_inner_validFraction_, "muon_inner_validFraction[nMuon]/D");
+    ntuple_->Branch("muon_inner_trackerLayers", &muon_inner_trackerLayers_, "muon_inner_trackerLayers[nMuon]/I");
+    ntuple_->Branch("muon_inner_trackerHits", &muon_inner_trackerHits_, "muon_inner_trackerHits[nMuon]/I");
+    ntuple_->Branch("muon_inner_lostTrackerHits", &muon_inner_lostTrackerHits_, "muon_inner_lostTrackerHits[nMuon]/I");
+    ntuple_->Branch("muon_inner_lostTrackerHitsIn", &muon_inner_lostTrackerHitsIn_, "muon_inner_lostTrackerHitsIn[nMuon]/I");
+    ntuple_->Branch("muon_inner_lostTrackerHitsOut", &muon_inner_lostTrackerHitsOut_, "muon_inner_lostTrackerHitsOut[nMuon]/I");
+    ntuple_->Branch("muon_inner_lostPixelHits", &muon_inner_lostPixelHits_, "muon_inner_lostPixelHits[nMuon]/I");
+    ntuple_->Branch("muon_inner_lostPixelBarrelHits", &muon_inner_lostPixelBarrelHits_, "muon_inner_lostPixelBarrelHits[nMuon]/I");
+    ntuple_->Branch("muon_inner_lostPixelEndcapHits", &muon_inner_lostPixelEndcapHits_, "muon_inner_lostPixelEndcapHits[nMuon]/I");
+    ntuple_->Branch("muon_inner_lostStripHits", &muon_inner_lostStripHits_, "muon_inner_lostStripHits[nMuon]/I");
+    ntuple_->Branch("muon_inner_lostStripTIBHits", &muon_inner_lostStripTIBHits_, "muon_inner_lostStripTIBHits[nMuon]/I");
+    ntuple_->Branch("muon_inner_lostStripTIDHits", &muon_inner_lostStripTIDHits_, "muon_inner_lostStripTIDHits[nMuon]/I");
+    ntuple_->Branch("muon_inner_lostStripTOBHits", &muon_inner_lostStripTOBHits_, "muon_inner_lostStripTOBHits[nMuon]/I");
+    ntuple_->Branch("muon_inner_lostStripTECHits", &muon_inner_lostStripTECHits_, "muon_inner_lostStripTECHits[nMuon]/I");
+    ntuple_->Branch("muon_inner_pixelLayers", &muon_inner_pixelLayers_, "muon_inner_pixelLayers[nMuon]/I");
+    ntuple_->Branch("muon_inner_pixelHits", &muon_inner_pixelHits_, "muon_inner_pixelHits[nMuon]/I");
+    ntuple_->Branch("muon_global_muonHits", &muon_global_muonHits_, "muon_global_muonHits[nMuon]/I");
+    ntuple_->Branch("muon_global_trkChi2", &muon_global_trkChi2_, "muon_global_trkChi2[nMuon]/D");
+    ntuple_->Branch("muon_global_trackerLayers", &muon_global_trackerLayers_, "muon_global_trackerLayers[nMuon]/I");
+    ntuple_->Branch("muon_global_trackerHits", &muon_global_trackerHits_, "muon_global_trackerHits[nMuon]/I");
+    ntuple_->Branch("muon_momentumChi2", &muon_momentumChi2_, "muon_momentumChi2[nMuon]/D");
+    ntuple_->Branch("muon_positionChi2", &muon_positionChi2_, "muon_positionChi2[nMuon]/D");
+    ntuple_->Branch("muon_glbKink", &muon_glbKink_, "muon_glbKink[nMuon]/D");
+    ntuple_->Branch("muon_glbTrackProbability", &muon_glbTrackProbability_, "muon_glbTrackProbability[nMuon]/D");
+    ntuple_->Branch("muon_globalDeltaEtaPhi", &muon_globalDeltaEtaPhi_, "muon_globalDeltaEtaPhi[nMuon]/D");
+    ntuple_->Branch("muon_localDistance", &muon_localDistance_, "muon_localDistance[nMuon]/D");
+    ntuple_->Branch("muon_staRelChi2", &muon_staRelChi2_, "muon_staRelChi2[nMuon]/D");
+    ntuple_->Branch("muon_tightMatch", &muon_tightMatch_, "muon_tightMatch[nMuon]/I");
+    ntuple_->Branch("muon_trkKink", &muon_trkKink_, "muon_trkKink[nMuon]/D");
+    ntuple_->Branch("muon_trkRelChi2", &muon_trkRelChi2_, "muon_trkRelChi2[nMuon]/D");
+    ntuple_->Branch("muon_segmentCompatibility", &muon_segmentCompatibility_, "muon_segmentCompatibility[nMuon]/D");
+
+    ntuple_->Branch("muon_pt_tuneP", &muon_pt_tuneP_, "muon_pt_tuneP[nMuon]/D");
+    ntuple_->Branch("muon_ptError_tuneP", &muon_ptError_tuneP_, "muon_ptError_tuneP[nMuon]/D");
+    ntuple_->Branch("muon_dxyVTX_best", &muon_dxyVTX_best_, "muon_dxyVTX_best[nMuon]/D");
+    ntuple_->Branch("muon_dzVTX_best", &muon_dzVTX_best_, "muon_dzVTX_best[nMuon]/D");
+    ntuple_->Branch("muon_nMatchedStation", &muon_nMatchedStation_, "muon_nMatchedStation[nMuon]/I");
+    ntuple_->Branch("muon_nMatchedRPCLayer", &muon_nMatchedRPCLayer_, "muon_nMatchedRPCLayer[nMuon]/I");
+    ntuple_->Branch("muon_stationMask", &muon_stationMask_, "muon_stationMask[nMuon]/I");
+    ntuple_->Branch("muon_dxy_bs", &muon_dxy_bs_, "muon_dxy_bs[nMuon]/D");
+    ntuple_->Branch("muon_dxyError_bs", &muon_dxyError_bs_, "muon_dxyError_bs[nMuon]/D");
+    ntuple_->Branch("muon_dz_bs", &muon_dz_bs_, "muon_dz_bs[nMuon]/D");
+    ntuple_->Branch("muon_dzError", &muon_dzError_, "muon_dzError[nMuon]/D");
+    ntuple_->Branch("muon_IPSig", &muon_IPSig_, "muon_IPSig[nMuon]/D");
+    ntuple_->Branch("muon_l1pt", &muon_l1pt_, "muon_l1pt[nMuon]/D");
+    ntuple_->Branch("muon_l1eta", &muon_l1eta_, "muon_l1eta[nMuon]/D");
+    ntuple_->Branch("muon_l1phi", &muon_l1phi_, "muon_l1phi[nMuon]/D");
+    ntuple_->Branch("muon_l1charge", &muon_l1charge_, "muon_l1charge[nMuon]/D");
+    ntuple_->Branch("muon_l1q", &muon_l1q_, "muon_l1q[nMuon]/I");
+    ntuple_->Branch("muon_l1dr", &muon_l1dr_, "muon_l1dr[nMuon]/D");
+    ntuple_->Branch("muon_l1ptByQ", &muon_l1ptByQ_, "muon_l1ptByQ[nMuon]/D");
+    ntuple_->Branch("muon_l1etaByQ", &muon_l1etaByQ_, "muon_l1etaByQ[nMuon]/D");
+    ntuple_->Branch("muon_l1phiByQ", &muon_l1phiByQ_, "muon_l1phiByQ[nMuon]/D");
+    ntuple_->Branch("muon_l1chargeByQ", &muon_l1chargeByQ_, "muon_l1chargeByQ[nMuon]/D");
+    ntuple_->Branch("muon_l1qByQ", &muon_l1qByQ_, "muon_l1qByQ[nMuon]/I");
+    ntuple_->Branch("muon_l1drByQ", &muon_l1drByQ_, "muon_l1drByQ[nMuon]/D");
+
+    ntuple_->Branch("muon_nl1t", &muon_nl1t_, "muon_nl1t[nMuon]/I");
+    ntuple_->Branch("muon_l1tpt", &muon_l1tpt_);
+    ntuple_->Branch("muon_l1teta", &muon_l1teta_);
+    ntuple_->Branch("muon_l1tpropeta", &muon_l1tpropeta_);
+    ntuple_->Branch("muon_l1tphi", &muon_l1tphi_);
+    ntuple_->Branch("muon_l1tpropphi", &muon_l1tpropphi_);
+    ntuple_->Branch("muon_l1tcharge", &muon_l1tcharge_);
+    ntuple_->Branch("muon_l1tq", &muon_l1tq_);
+    ntuple_->Branch("muon_l1tdr", &muon_l1tdr_);
+  }
 
-    trkTemplates_.at(i)->setBranch(ntuple_, trkName );
-    tpTemplates_.at(i)->setBranch(ntuple_,  tpName );
+  if( writeGroup("muonMatch") ) {
+    if( !writeGroup("muon") )
+      ntuple_->Branch("nMuon", &nMuon_, "nMuon/I"); // -- counter of the muon_<name>_* arrays
+
+    for( auto& M : muonMatches_ ) {
+      ntuple_->Branch(("muon_"+M.name+"_idx").c_str(), &M.idx,     ("muon_"+M.name+"_idx[nMuon]/I").c_str());
+      ntuple_->Branch(("muon_"+M.name+"_dR").c_str(),  &M.matchDR, ("muon_"+M.name+"_dR[nMuon]/D").c_str());
+    }
+  }
+
+  if( writeGroup("HLTMuon") ) {
+    ntuple_->Branch("nL3Muon", &nL3Muon_, "nL3Muon/I");
+    ntuple_->Branch("L3Muon_pt", &L3Muon_pt_, "L3Muon_pt[nL3Muon]/D");
+    ntuple_->Branch("L3Muon_eta", &L3Muon_eta_, "L3Muon_eta[nL3Muon]/D");
+    ntuple_->Branch("L3Muon_phi", &L3Muon_phi_, "L3Muon_phi[nL3Muon]/D");
+    ntuple_->Branch("L3Muon_charge", &L3Muon_charge_, "L3Muon_charge[nL3Muon]/D");
+    ntuple_->Branch("L3Muon_trkPt", &L3Muon_trkPt_, "L3Muon_trkPt[nL3Muon]/D");
+    ntuple_->Branch("L3Muon_ECALIso", &L3Muon_ECALIso_, "L3Muon_ECALIso[nL3Muon]/D");
+    ntuple_->Branch("L3Muon_HCALIso", &L3Muon_HCALIso_, "L3Muon_HCALIso[nL3Muon]/D");
+    ntuple_->Branch("L3Muon_trkIso",  &L3Muon_trkIso_,  "L3Muon_trkIso[nL3Muon]/D");
+
+    ntuple_->Branch("nL2Muon", &nL2Muon_, "nL2Muon/I");
+    ntuple_->Branch("L2Muon_pt", &L2Muon_pt_, "L2Muon_pt[nL2Muon]/D");
+    ntuple_->Branch("L2Muon_eta", &L2Muon_eta_, "L2Muon_eta[nL2Muon]/D");
+    ntuple_->Branch("L2Muon_phi", &L2Muon_phi_, "L2Muon_phi[nL2Muon]/D");
+    ntuple_->Branch("L2Muon_charge", &L2Muon_charge_, "L2Muon_charge[nL2Muon]/D");
+    ntuple_->Branch("L2Muon_trkPt", &L2Muon_trkPt_, "L2Muon_trkPt[nL2Muon]/D");
+
+    ntuple_->Branch("nTkMuon", &nTkMuon_, "nTkMuon/I");
+    ntuple_->Branch("TkMuon_pt", &TkMuon_pt_, "TkMuon_pt[nTkMuon]/D");
+    ntuple_->Branch("TkMuon_eta", &TkMuon_eta_, "TkMuon_eta[nTkMuon]/D");
+    ntuple_->Branch("TkMuon_phi", &TkMuon_phi_, "TkMuon_phi[nTkMuon]/D");
+    ntuple_->Branch("TkMuon_charge", &TkMuon_charge_, "TkMuon_charge[nTkMuon]/D");
+    ntuple_->Branch("TkMuon_trkPt", &TkMuon_trkPt_, "TkMuon_trkPt[nTkMuon]/D");
+
+  }
+
+  if( writeGroup("L1Muon") ) {
+    ntuple_->Branch("nL1Muon", &nL1Muon_, "nL1Muon/I");
+    ntuple_->Branch("L1Muon_pt", &L1Muon_pt_, "L1Muon_pt[nL1Muon]/D");
+    ntuple_->Branch("L1Muon_eta", &L1Muon_eta_, "L1Muon_eta[nL1Muon]/D");
+    ntuple_->Branch("L1Muon_phi", &L1Muon_phi_, "L1Muon_phi[nL1Muon]/D");
+    ntuple_->Branch("L1Muon_charge", &L1Muon_charge_, "L1Muon_charge[nL1Muon]/D");
+    ntuple_->Branch("L1Muon_quality", &L1Muon_quality_, "L1Muon_quality[nL1Muon]/D");
+    ntuple_->Branch("L1Muon_etaAtVtx", &L1Muon_etaAtVtx_, "L1Muon_etaAtVtx[nL1Muon]/D");
+    ntuple_->Branch("L1Muon_phiAtVtx", &L1Muon_phiAtVtx_, "L1Muon_phiAtVtx[nL1Muon]/D");
+  }
+
+  if( writeGroup("iterL3") ) {
+    ntuple_->Branch("nIterL3OI", &nIterL3OI_, "nIterL3OI/I");
+    ntuple_->Branch("iterL3OI_inner_pt", &iterL3OI_inner_pt_, "iterL3OI_inner_pt[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_inner_eta", &iterL3OI_inner_eta_, "iterL3OI_inner_eta[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_inner_phi", &iterL3OI_inner_phi_, "iterL3OI_inner_phi[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_inner_charge", &iterL3OI_inner_charge_, "iterL3OI_inner_charge[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_inner_trkChi2", &iterL3OI_inner_trkChi2_, "iterL3OI_inner_trkChi2[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_inner_validFraction", &iterL3OI_inner_validFraction_, "iterL3OI_inner_validFraction[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_inner_trackerLayers", &iterL3OI_inner_trackerLayers_, "iterL3OI_inner_trackerLayers[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_trackerHits", &iterL3OI_inner_trackerHits_, "iterL3OI_inner_trackerHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_lostTrackerHits", &iterL3OI_inner_lostTrackerHits_, "iterL3OI_inner_lostTrackerHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_lostTrackerHitsIn", &iterL3OI_inner_lostTrackerHitsIn_, "iterL3OI_inner_lostTrackerHitsIn[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_lostTrackerHitsOut", &iterL3OI_inner_lostTrackerHitsOut_, "iterL3OI_inner_lostTrackerHitsOut[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_lostPixelHits", &iterL3OI_inner_lostPixelHits_, "iterL3OI_inner_lostPixelHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_lostPixelBarrelHits", &iterL3OI_inner_lostPixelBarrelHits_, "iterL3OI_inner_lostPixelBarrelHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_lostPixelEndcapHits", &iterL3OI_inner_lostPixelEndcapHits_, "iterL3OI_inner_lostPixelEndcapHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_lostStripHits", &iterL3OI_inner_lostStripHits_, "iterL3OI_inner_lostStripHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_lostStripTIBHits", &iterL3OI_inner_lostStripTIBHits_, "iterL3OI_inner_lostStripTIBHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_lostStripTIDHits", &iterL3OI_inner_lostStripTIDHits_, "iterL3OI_inner_lostStripTIDHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_lostStripTOBHits", &iterL3OI_inner_lostStripTOBHits_, "iterL3OI_inner_lostStripTOBHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_lostStripTECHits", &iterL3OI_inner_lostStripTECHits_, "iterL3OI_inner_lostStripTECHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_pixelLayers", &iterL3OI_inner_pixelLayers_, "iterL3OI_inner_pixelLayers[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_inner_pixelHits", &iterL3OI_inner_pixelHits_, "iterL3OI_inner_pixelHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_outer_pt", &iterL3OI_outer_pt_, "iterL3OI_outer_pt[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_outer_eta", &iterL3OI_outer_eta_, "iterL3OI_outer_eta[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_outer_phi", &iterL3OI_outer_phi_, "iterL3OI_outer_phi[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_outer_charge", &iterL3OI_outer_charge_, "iterL3OI_outer_charge[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_global_pt", &iterL3OI_global_pt_, "iterL3OI_global_pt[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_global_eta", &iterL3OI_global_eta_, "iterL3OI_global_eta[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_global_phi", &iterL3OI_global_phi_, "iterL3OI_global_phi[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_global_charge", &iterL3OI_global_charge_, "iterL3OI_global_charge[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_global_muonHits", &iterL3OI_global_muonHits_, "iterL3OI_global_muonHits[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_global_trkChi2", &iterL3OI_global_trkChi2_, "iterL3OI_global_trkChi2[nIterL3OI]/D");
+    ntuple_->Branch("iterL3OI_global_trackerLayers", &iterL3OI_global_trackerLayers_, "iterL3OI_global_trackerLayers[nIterL3OI]/I");
+    ntuple_->Branch("iterL3OI_global_trackerHits", &iterL3OI_global_trackerHits_, "iterL3OI_global_trackerHits[nIterL3OI]/I");
+
+    ntuple_->Branch("nIterL3IOFromL2", &nIterL3IOFromL2_, "nIterL3IOFromL2/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_pt", &iterL3IOFromL2_inner_pt_, "iterL3IOFromL2_inner_pt[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_inner_eta", &iterL3IOFromL2_inner_eta_, "iterL3IOFromL2_inner_eta[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_inner_phi", &iterL3IOFromL2_inner_phi_, "iterL3IOFromL2_inner_phi[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_inner_charge", &iterL3IOFromL2_inner_charge_, "iterL3IOFromL2_inner_charge[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_inner_trkChi2", &iterL3IOFromL2_inner_trkChi2_, "iterL3IOFromL2_inner_trkChi2[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_inner_validFraction", &iterL3IOFromL2_inner_validFraction_, "iterL3IOFromL2_inner_validFraction[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_inner_trackerLayers", &iterL3IOFromL2_inner_trackerLayers_, "iterL3IOFromL2_inner_trackerLayers[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_trackerHits", &iterL3IOFromL2_inner_trackerHits_, "iterL3IOFromL2_inner_trackerHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_lostTrackerHits", &iterL3IOFromL2_inner_lostTrackerHits_, "iterL3IOFromL2_inner_lostTrackerHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_lostTrackerHitsIn", &iterL3IOFromL2_inner_lostTrackerHitsIn_, "iterL3IOFromL2_inner_lostTrackerHitsIn[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_lostTrackerHitsOut", &iterL3IOFromL2_inner_lostTrackerHitsOut_, "iterL3IOFromL2_inner_lostTrackerHitsOut[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_lostPixelHits", &iterL3IOFromL2_inner_lostPixelHits_, "iterL3IOFromL2_inner_lostPixelHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_lostPixelBarrelHits", &iterL3IOFromL2_inner_lostPixelBarrelHits_, "iterL3IOFromL2_inner_lostPixelBarrelHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_lostPixelEndcapHits", &iterL3IOFromL2_inner_lostPixelEndcapHits_, "iterL3IOFromL2_inner_lostPixelEndcapHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_lostStripHits", &iterL3IOFromL2_inner_lostStripHits_, "iterL3IOFromL2_inner_lostStripHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_lostStripTIBHits", &iterL3IOFromL2_inner_lostStripTIBHits_, "iterL3IOFromL2_inner_lostStripTIBHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_lostStripTIDHits", &iterL3IOFromL2_inner_lostStripTIDHits_, "iterL3IOFromL2_inner_lostStripTIDHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_lostStripTOBHits", &iterL3IOFromL2_inner_lostStripTOBHits_, "iterL3IOFromL2_inner_lostStripTOBHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_lostStripTECHits", &iterL3IOFromL2_inner_lostStripTECHits_, "iterL3IOFromL2_inner_lostStripTECHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_pixelLayers", &iterL3IOFromL2_inner_pixelLayers_, "iterL3IOFromL2_inner_pixelLayers[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_inner_pixelHits", &iterL3IOFromL2_inner_pixelHits_, "iterL3IOFromL2_inner_pixelHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_outer_pt", &iterL3IOFromL2_outer_pt_, "iterL3IOFromL2_outer_pt[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_outer_eta", &iterL3IOFromL2_outer_eta_, "iterL3IOFromL2_outer_eta[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_outer_phi", &iterL3IOFromL2_outer_phi_, "iterL3IOFromL2_outer_phi[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_outer_charge", &iterL3IOFromL2_outer_charge_, "iterL3IOFromL2_outer_charge[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_global_pt", &iterL3IOFromL2_global_pt_, "iterL3IOFromL2_global_pt[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_global_eta", &iterL3IOFromL2_global_eta_, "iterL3IOFromL2_global_eta[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_global_phi", &iterL3IOFromL2_global_phi_, "iterL3IOFromL2_global_phi[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_global_charge", &iterL3IOFromL2_global_charge_, "iterL3IOFromL2_global_charge[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_global_muonHits", &iterL3IOFromL2_global_muonHits_, "iterL3IOFromL2_global_muonHits[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_global_trkChi2", &iterL3IOFromL2_global_trkChi2_, "iterL3IOFromL2_global_trkChi2[nIterL3IOFromL2]/D");
+    ntuple_->Branch("iterL3IOFromL2_global_trackerLayers", &iterL3IOFromL2_global_trackerLayers_, "iterL3IOFromL2_global_trackerLayers[nIterL3IOFromL2]/I");
+    ntuple_->Branch("iterL3IOFromL2_global_trackerHits", &iterL3IOFromL2_global_trackerHits_, "iterL3IOFromL2_global_trackerHits[nIterL3IOFromL2]/I");
+
+    ntuple_->Branch("nIterL3FromL2", &nIterL3FromL2_, "nIterL3FromL2/I");
+    ntuple_->Branch("iterL3FromL2_inner_pt", &iterL3FromL2_inner_pt_, "iterL3FromL2_inner_pt[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_inner_eta", &iterL3FromL2_inner_eta_, "iterL3FromL2_inner_eta[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_inner_phi", &iterL3FromL2_inner_phi_, "iterL3FromL2_inner_phi[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_inner_charge", &iterL3FromL2_inner_charge_, "iterL3FromL2_inner_charge[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_inner_trkChi2", &iterL3FromL2_inner_trkChi2_, "iterL3FromL2_inner_trkChi2[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_inner_validFraction", &iterL3FromL2_inner_validFraction_, "iterL3FromL2_inner_validFraction[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_inner_trackerLayers", &iterL3FromL2_inner_trackerLayers_, "iterL3FromL2_inner_trackerLayers[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_trackerHits", &iterL3FromL2_inner_trackerHits_, "iterL3FromL2_inner_trackerHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_lostTrackerHits", &iterL3FromL2_inner_lostTrackerHits_, "iterL3FromL2_inner_lostTrackerHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_lostTrackerHitsIn", &iterL3FromL2_inner_lostTrackerHitsIn_, "iterL3FromL2_inner_lostTrackerHitsIn[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_lostTrackerHitsOut", &iterL3FromL2_inner_lostTrackerHitsOut_, "iterL3FromL2_inner_lostTrackerHitsOut[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_lostPixelHits", &iterL3FromL2_inner_lostPixelHits_, "iterL3FromL2_inner_lostPixelHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_lostPixelBarrelHits", &iterL3FromL2_inner_lostPixelBarrelHits_, "iterL3FromL2_inner_lostPixelBarrelHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_lostPixelEndcapHits", &iterL3FromL2_inner_lostPixelEndcapHits_, "iterL3FromL2_inner_lostPixelEndcapHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_lostStripHits", &iterL3FromL2_inner_lostStripHits_, "iterL3FromL2_inner_lostStripHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_lostStripTIBHits", &iterL3FromL2_inner_lostStripTIBHits_, "iterL3FromL2_inner_lostStripTIBHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_lostStripTIDHits", &iterL3FromL2_inner_lostStripTIDHits_, "iterL3FromL2_inner_lostStripTIDHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_lostStripTOBHits", &iterL3FromL2_inner_lostStripTOBHits_, "iterL3FromL2_inner_lostStripTOBHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_lostStripTECHits", &iterL3FromL2_inner_lostStripTECHits_, "iterL3FromL2_inner_lostStripTECHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_pixelLayers", &iterL3FromL2_inner_pixelLayers_, "iterL3FromL2_inner_pixelLayers[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_inner_pixelHits", &iterL3FromL2_inner_pixelHits_, "iterL3FromL2_inner_pixelHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_outer_pt", &iterL3FromL2_outer_pt_, "iterL3FromL2_outer_pt[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_outer_eta", &iterL3FromL2_outer_eta_, "iterL3FromL2_outer_eta[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_outer_phi", &iterL3FromL2_outer_phi_, "iterL3FromL2_outer_phi[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_outer_charge", &iterL3FromL2_outer_charge_, "iterL3FromL2_outer_charge[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_global_pt", &iterL3FromL2_global_pt_, "iterL3FromL2_global_pt[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_global_eta", &iterL3FromL2_global_eta_, "iterL3FromL2_global_eta[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_global_phi", &iterL3FromL2_global_phi_, "iterL3FromL2_global_phi[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_global_charge", &iterL3FromL2_global_charge_, "iterL3FromL2_global_charge[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_global_muonHits", &iterL3FromL2_global_muonHits_, "iterL3FromL2_global_muonHits[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_global_trkChi2", &iterL3FromL2_global_trkChi2_, "iterL3FromL2_global_trkChi2[nIterL3FromL2]/D");
+    ntuple_->Branch("iterL3FromL2_global_trackerLayers", &iterL3FromL2_global_trackerLayers_, "iterL3FromL2_global_trackerLayers[nIterL3FromL2]/I");
+    ntuple_->Branch("iterL3FromL2_global_trackerHits", &iterL3FromL2_global_trackerHits_, "iterL3FromL2_global_trackerHits[nIterL3FromL2]/I");
+
+    ntuple_->Branch("nIterL3IOFromL1", &nIterL3IOFromL1_, "nIterL3IOFromL1/I");
+    ntuple_->Branch("iterL3IOFromL1_pt", &iterL3IOFromL1_pt_, "iterL3IOFromL1_pt[nIterL3IOFromL1]/D");
+    ntuple_->Branch("iterL3IOFromL1_eta", &iterL3IOFromL1_eta_, "iterL3IOFromL1_eta[nIterL3IOFromL1]/D");
+    ntuple_->Branch("iterL3IOFromL1_phi", &iterL3IOFromL1_phi_, "iterL3IOFromL1_phi[nIterL3IOFromL1]/D");
+    ntuple_->Branch("iterL3IOFromL1_charge", &iterL3IOFromL1_charge_, "iterL3IOFromL1_charge[nIterL3IOFromL1]/D");
+    ntuple_->Branch("iterL3IOFromL1_muonHits", &iterL3IOFromL1_muonHits_, "iterL3IOFromL1_muonHits[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_trkChi2", &iterL3IOFromL1_trkChi2_, "iterL3IOFromL1_trkChi2[nIterL3IOFromL1]/D");
+    ntuple_->Branch("iterL3IOFromL1_validFraction", &iterL3IOFromL1_validFraction_, "iterL3IOFromL1_validFraction[nIterL3IOFromL1]/D");
+    ntuple_->Branch("iterL3IOFromL1_trackerLayers", &iterL3IOFromL1_trackerLayers_, "iterL3IOFromL1_trackerLayers[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_trackerHits", &iterL3IOFromL1_trackerHits_, "iterL3IOFromL1_trackerHits[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_lostTrackerHits", &iterL3IOFromL1_lostTrackerHits_, "iterL3IOFromL1_lostTrackerHits[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_lostTrackerHitsIn", &iterL3IOFromL1_lostTrackerHitsIn_, "iterL3IOFromL1_lostTrackerHitsIn[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_lostTrackerHitsOut", &iterL3IOFromL1_lostTrackerHitsOut_, "iterL3IOFromL1_lostTrackerHitsOut[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_lostPixelHits", &iterL3IOFromL1_lostPixelHits_, "iterL3IOFromL1_lostPixelHits[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_lostPixelBarrelHits", &iterL3IOFromL1_lostPixelBarrelHits_, "iterL3IOFromL1_lostPixelBarrelHits[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_lostPixelEndcapHits", &iterL3IOFromL1_lostPixelEndcapHits_, "iterL3IOFromL1_lostPixelEndcapHits[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_lostStripHits", &iterL3IOFromL1_lostStripHits_, "iterL3IOFromL1_lostStripHits[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_lostStripTIBHits", &iterL3IOFromL1_lostStripTIBHits_, "iterL3IOFromL1_lostStripTIBHits[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_lostStripTIDHits", &iterL3IOFromL1_lostStripTIDHits_, "iterL3IOFromL1_lostStripTIDHits[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_lostStripTOBHits", &iterL3IOFromL1_lostStripTOBHits_, "iterL3IOFromL1_lostStripTOBHits[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_lostStripTECHits", &iterL3IOFromL1_lostStripTECHits_, "iterL3IOFromL1_lostStripTECHits[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_pixelLayers", &iterL3IOFromL1_pixelLayers_, "iterL3IOFromL1_pixelLayers[nIterL3IOFromL1]/I");
+    ntuple_->Branch("iterL3IOFromL1_pixelHits", &iterL3IOFromL1_pixelHits_, "iterL3IOFromL1_pixelHits[nIterL3IOFromL1]/I");
+
+    ntuple_->Branch("nIterL3MuonNoID",       &nIterL3MuonNoID_,       "nIterL3MuonNoID/I");
+    ntuple_->Branch("iterL3MuonNoID_pt",     &iterL3MuonNoID_pt_,     "iterL3MuonNoID_pt[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_innerPt",     &iterL3MuonNoID_innerPt_,     "iterL3MuonNoID_innerPt[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_eta",    &iterL3MuonNoID_eta_,    "iterL3MuonNoID_eta[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_phi",    &iterL3MuonNoID_phi_,    "iterL3MuonNoID_phi[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_charge", &iterL3MuonNoID_charge_, "iterL3MuonNoID_charge[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_isGLB",  &iterL3MuonNoID_isGLB_,  "iterL3MuonNoID_isGLB[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_isSTA",  &iterL3MuonNoID_isSTA_,  "iterL3MuonNoID_isSTA[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_isTRK",  &iterL3MuonNoID_isTRK_,  "iterL3MuonNoID_isTRK[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_trkChi2", &iterL3MuonNoID_inner_trkChi2_, "iterL3MuonNoID_inner_trkChi2[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_inner_validFraction", &iterL3MuonNoID_inner_validFraction_, "iterL3MuonNoID_inner_validFraction[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_inner_trackerLayers", &iterL3MuonNoID_inner_trackerLayers_, "iterL3MuonNoID_inner_trackerLayers[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_trackerHits", &iterL3MuonNoID_inner_trackerHits_, "iterL3MuonNoID_inner_trackerHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_lostTrackerHits", &iterL3MuonNoID_inner_lostTrackerHits_, "iterL3MuonNoID_inner_lostTrackerHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_lostTrackerHitsIn", &iterL3MuonNoID_inner_lostTrackerHitsIn_, "iterL3MuonNoID_inner_lostTrackerHitsIn[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_lostTrackerHitsOut", &iterL3MuonNoID_inner_lostTrackerHitsOut_, "iterL3MuonNoID_inner_lostTrackerHitsOut[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_lostPixelHits", &iterL3MuonNoID_inner_lostPixelHits_, "iterL3MuonNoID_inner_lostPixelHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_lostPixelBarrelHits", &iterL3MuonNoID_inner_lostPixelBarrelHits_, "iterL3MuonNoID_inner_lostPixelBarrelHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_lostPixelEndcapHits", &iterL3MuonNoID_inner_lostPixelEndcapHits_, "iterL3MuonNoID_inner_lostPixelEndcapHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_lostStripHits", &iterL3MuonNoID_inner_lostStripHits_, "iterL3MuonNoID_inner_lostStripHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_lostStripTIBHits", &iterL3MuonNoID_inner_lostStripTIBHits_, "iterL3MuonNoID_inner_lostStripTIBHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_lostStripTIDHits", &iterL3MuonNoID_inner_lostStripTIDHits_, "iterL3MuonNoID_inner_lostStripTIDHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_lostStripTOBHits", &iterL3MuonNoID_inner_lostStripTOBHits_, "iterL3MuonNoID_inner_lostStripTOBHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_lostStripTECHits", &iterL3MuonNoID_inner_lostStripTECHits_, "iterL3MuonNoID_inner_lostStripTECHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_pixelLayers", &iterL3MuonNoID_inner_pixelLayers_, "iterL3MuonNoID_inner_pixelLayers[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_inner_pixelHits", &iterL3MuonNoID_inner_pixelHits_, "iterL3MuonNoID_inner_pixelHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_global_muonHits", &iterL3MuonNoID_global_muonHits_, "iterL3MuonNoID_global_muonHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_global_trkChi2", &iterL3MuonNoID_global_trkChi2_, "iterL3MuonNoID_global_trkChi2[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_global_trackerLayers", &iterL3MuonNoID_global_trackerLayers_, "iterL3MuonNoID_global_trackerLayers[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_global_trackerHits", &iterL3MuonNoID_global_trackerHits_, "iterL3MuonNoID_global_trackerHits[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_momentumChi2", &iterL3MuonNoID_momentumChi2_, "iterL3MuonNoID_momentumChi2[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_positionChi2", &iterL3MuonNoID_positionChi2_, "iterL3MuonNoID_positionChi2[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_glbKink", &iterL3MuonNoID_glbKink_, "iterL3MuonNoID_glbKink[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_glbTrackProbability", &iterL3MuonNoID_glbTrackProbability_, "iterL3MuonNoID_glbTrackProbability[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_globalDeltaEtaPhi", &iterL3MuonNoID_globalDeltaEtaPhi_, "iterL3MuonNoID_globalDeltaEtaPhi[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_localDistance", &iterL3MuonNoID_localDistance_, "iterL3MuonNoID_localDistance[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_staRelChi2", &iterL3MuonNoID_staRelChi2_, "iterL3MuonNoID_staRelChi2[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_tightMatch", &iterL3MuonNoID_tightMatch_, "iterL3MuonNoID_tightMatch[nIterL3MuonNoID]/I");
+    ntuple_->Branch("iterL3MuonNoID_trkKink", &iterL3MuonNoID_trkKink_, "iterL3MuonNoID_trkKink[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_trkRelChi2", &iterL3MuonNoID_trkRelChi2_, "iterL3MuonNoID_trkRelChi2[nIterL3MuonNoID]/D");
+    ntuple_->Branch("iterL3MuonNoID_segmentCompatibility", &iterL3MuonNoID_segmentCompatibility_, "iterL3MuonNoID_segmentCompatibility[nIterL3MuonNoID]/D");
+
+    ntuple_->Branch("nIterL3Muon",       &nIterL3Muon_,       "nIterL3Muon/I");
+    ntuple_->Branch("iterL3Muon_pt",     &iterL3Muon_pt_,     "iterL3Muon_pt[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_innerPt", &iterL3Muon_innerPt_, "iterL3Muon_innerPt[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_eta",    &iterL3Muon_eta_,    "iterL3Muon_eta[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_phi",    &iterL3Muon_phi_,    "iterL3Muon_phi[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_charge", &iterL3Muon_charge_, "iterL3Muon_charge[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_isGLB",  &iterL3Muon_isGLB_,  "iterL3Muon_isGLB[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_isSTA",  &iterL3Muon_isSTA_,  "iterL3Muon_isSTA[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_isTRK",  &iterL3Muon_isTRK_,  "iterL3Muon_isTRK[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_trkChi2", &iterL3Muon_inner_trkChi2_, "iterL3Muon_inner_trkChi2[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_inner_validFraction", &iterL3Muon_inner_validFraction_, "iterL3Muon_inner_validFraction[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_inner_trackerLayers", &iterL3Muon_inner_trackerLayers_, "iterL3Muon_inner_trackerLayers[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_trackerHits", &iterL3Muon_inner_trackerHits_, "iterL3Muon_inner_trackerHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_lostTrackerHits", &iterL3Muon_inner_lostTrackerHits_, "iterL3Muon_inner_lostTrackerHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_lostTrackerHitsIn", &iterL3Muon_inner_lostTrackerHitsIn_, "iterL3Muon_inner_lostTrackerHitsIn[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_lostTrackerHitsOut", &iterL3Muon_inner_lostTrackerHitsOut_, "iterL3Muon_inner_lostTrackerHitsOut[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_lostPixelHits", &iterL3Muon_inner_lostPixelHits_, "iterL3Muon_inner_lostPixelHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_lostPixelBarrelHits", &iterL3Muon_inner_lostPixelBarrelHits_, "iterL3Muon_inner_lostPixelBarrelHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_lostPixelEndcapHits", &iterL3Muon_inner_lostPixelEndcapHits_, "iterL3Muon_inner_lostPixelEndcapHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_lostStripHits", &iterL3Muon_inner_lostStripHits_, "iterL3Muon_inner_lostStripHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_lostStripTIBHits", &iterL3Muon_inner_lostStripTIBHits_, "iterL3Muon_inner_lostStripTIBHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_lostStripTIDHits", &iterL3Muon_inner_lostStripTIDHits_, "iterL3Muon_inner_lostStripTIDHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_lostStripTOBHits", &iterL3Muon_inner_lostStripTOBHits_, "iterL3Muon_inner_lostStripTOBHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_lostStripTECHits", &iterL3Muon_inner_lostStripTECHits_, "iterL3Muon_inner_lostStripTECHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_pixelLayers", &iterL3Muon_inner_pixelLayers_, "iterL3Muon_inner_pixelLayers[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_inner_pixelHits", &iterL3Muon_inner_pixelHits_, "iterL3Muon_inner_pixelHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_global_muonHits", &iterL3Muon_global_muonHits_, "iterL3Muon_global_muonHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_global_trkChi2", &iterL3Muon_global_trkChi2_, "iterL3Muon_global_trkChi2[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_global_trackerLayers", &iterL3Muon_global_trackerLayers_, "iterL3Muon_global_trackerLayers[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_global_trackerHits", &iterL3Muon_global_trackerHits_, "iterL3Muon_global_trackerHits[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_momentumChi2", &iterL3Muon_momentumChi2_, "iterL3Muon_momentumChi2[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_positionChi2", &iterL3Muon_positionChi2_, "iterL3Muon_positionChi2[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_glbKink", &iterL3Muon_glbKink_, "iterL3Muon_glbKink[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_glbTrackProbability", &iterL3Muon_glbTrackProbability_, "iterL3Muon_glbTrackProbability[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_globalDeltaEtaPhi", &iterL3Muon_globalDeltaEtaPhi_, "iterL3Muon_globalDeltaEtaPhi[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_localDistance", &iterL3Muon_localDistance_, "iterL3Muon_localDistance[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_staRelChi2", &iterL3Muon_staRelChi2_, "iterL3Muon_staRelChi2[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_tightMatch", &iterL3Muon_tightMatch_, "iterL3Muon_tightMatch[nIterL3Muon]/I");
+    ntuple_->Branch("iterL3Muon_trkKink", &iterL3Muon_trkKink_, "iterL3Muon_trkKink[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_trkRelChi2", &iterL3Muon_trkRelChi2_, "iterL3Muon_trkRelChi2[nIterL3Muon]/D");
+    ntuple_->Branch("iterL3Muon_segmentCompatibility", &iterL3Muon_segmentCompatibility_, "iterL3Muon_segmentCompatibility[nIterL3Muon]/D");
+  }
+
+  if( writeGroup("TP") ) {
+    TrkParticle->setBranch(ntuple_,"TP");
+  }
+
+  if( writeGroup("event") ) {
+    VThltIterL3MuonTrimmedPixelVertices->setBranch(ntuple_,"hltIterL3MuonTrimmedPixelVertices");
+    VThltIterL3FromL1MuonTrimmedPixelVertices->setBranch(ntuple_,"hltIterL3FromL1MuonTrimmedPixelVertices");
+  }
+
+  if( writeGroup("tracks") ) {
+    for( unsigned int i = 0; i < trackCollectionNames_.size(); ++i) {
+      TString trkName = TString(trackCollectionNames_.at(i));
+      TString tpName  = "tpTo_" + TString(trackCollectionNames_.at(i));
+
+      trkTemplates_.at(i)->setBranch(ntuple_, trkName );
+      tpTemplates_.at(i)->setBranch(ntuple_,  tpName );
+    }
   }
 
 }
 
-void MuonHLTNtupler::Fill_Muon(const edm::Event &iEvent, const edm::EventSetup &iSetup)
+void MuonHLTNtupler::Update_ESCache(const edm::EventSetup &iSetup)
 {
+  auto start = std::chrono::steady_clock::now();
+
+  // -- every watcher is checked (no short-circuit) so that each one keeps track of its own record
+  bool propChanged = magneticFieldWatcher_.check(iSetup);
+  propChanged = propagatorWatcher_.check(iSetup) || propChanged;
+  propChanged = muonGeometryWatcher_.check(iSetup) || propChanged;
+  if( propChanged || !prop_ ) {
+    prop_.emplace( propSetup_.init(iSetup) );
+    nESCacheRebuild_++;
+  }
+
+  if( trackerGeometryWatcher_.check(iSetup) || tracker_ == nullptr )
+    tracker_ = &iSetup.getData(trackerGeometryToken_);
+
+  if( !benchmarkESCache_ )
+    return;
+
+  auto cached = std::chrono::steady_clock::now();
+
+  // -- what was done in every event before: not used, only timed
   auto const prop = propSetup_.init(iSetup);
+  const TrackerGeometry& tracker = iSetup.getData(trackerGeometryToken_);
+  if( &tracker != tracker_ )
+    throw cms::Exception("LogicError") << "MuonHLTNtupler: cached tracker geometry is out of date";
+
+  auto rebuilt = std::chrono::steady_clock::now();
+
+  timeESCached_  += std::chrono::duration<double>(cached - start).count();
+  timeESRebuild_ += std::chrono::duration<double>(rebuilt - cached).count();
+  nESCacheEvent_++;
+}
+
+void MuonHLTNtupler::add_muonMatch(const edm::ParameterSet &matchConf)
+{
+  muonMatch M;
+  M.name  = matchConf.getParameter<std::string>("name");
+  M.dR    = matchConf.getParameter<double>("dR");
+  M.minPt = matchConf.getParameter<double>("minPt");
+
+  const std::string collection = matchConf.getParameter<std::string>("collection");
+  if(      collection == "L1Muon" )               { M.n = &nL1Muon_; M.group = "L1Muon";          M.pt = L1Muon_pt_;               M.eta = L1Muon_eta_;               M.phi = L1Muon_phi_; }
+  else if( collection == "L2Muon" )               { M.n = &nL2Muon_; M.group = "HLTMuon";          M.pt = L2Muon_pt_;               M.eta = L2Muon_eta_;               M.phi = L2Muon_phi_; }
+  else if( collection == "L3Muon" )               { M.n = &nL3Muon_; M.group = "HLTMuon";          M.pt = L3Muon_pt_;               M.eta = L3Muon_eta_;               M.phi = L3Muon_phi_; }
+  else if( collection == "TkMuon" )               { M.n = &nTkMuon_; M.group = "HLTMuon";          M.pt = TkMuon_pt_;               M.eta = TkMuon_eta_;               M.phi = TkMuon_phi_; }
+  else if( collection == "iterL3OI_inner" )       { M.n = &nIterL3OI_; M.group = "iterL3";        M.pt = iterL3OI_inner_pt_;       M.eta = iterL3OI_inner_eta_;       M.phi = iterL3OI_inner_phi_; }
+  else if( collection == "iterL3IOFromL2_inner" ) { M.n = &nIterL3IOFromL2_; M.group = "iterL3";  M.pt = iterL3IOFromL2_inner_pt_; M.eta = iterL3IOFromL2_inner_eta_; M.phi = iterL3IOFromL2_inner_phi_; }
+  else if( collection == "iterL3FromL2_inner" )   { M.n = &nIterL3FromL2_; M.group = "iterL3";    M.pt = iterL3FromL2_inner_pt_;   M.eta = iterL3FromL2_inner_eta_;   M.phi = iterL3FromL2_inner_phi_; }
+  else if( collection == "iterL3IOFromL1" )       { M.n = &nIterL3IOFromL1_; M.group = "iterL3";  M.pt = iterL3IOFromL1_pt_;       M.eta = iterL3IOFromL1_eta_;       M.phi = iterL3IOFromL1_phi_; }
+  else if( collection == "iterL3MuonNoID" )       { M.n = &nIterL3MuonNoID_; M.group = "iterL3";  M.pt = iterL3MuonNoID_pt_;       M.eta = iterL3MuonNoID_eta_;       M.phi = iterL3MuonNoID_phi_; }
+  else if( collection == "iterL3Muon" )           { M.n = &nIterL3Muon_; M.group = "iterL3";      M.pt = iterL3Muon_pt_;           M.eta = iterL3Muon_eta_;           M.phi = iterL3Muon_phi_; }
+  else if( collection == "HLTObj" ) {
+    M.filterNames = &vec_filterName_;   M.vecPt = &vec_HLTObj_pt_;   M.vecEta = &vec_HLTObj_eta_;   M.vecPhi = &vec_HLTObj_phi_;
+    M.group = "HLT";
+    M.filter = matchConf.getParameter<std::string>("filter");
+  }
+  else if( collection == "MYHLTObj" ) {
+    M.filterNames = &vec_myFilterName_; M.vecPt = &vec_myHLTObj_pt_; M.vecEta = &vec_myHLTObj_eta_; M.vecPhi = &vec_myHLTObj_phi_;
+    M.group = "MYHLT";
+    M.filter = matchConf.getParameter<std::string>("filter");
+  }
+  else
+    throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: unknown muonMatch collection " << collection;
+
+  muonMatches_.push_back(M);
+}
+
+void MuonHLTNtupler::add_efficiencyHist(const edm::ParameterSet &histConf)
+{
+  efficiencyHist H;
+  H.name      = histConf.getParameter<std::string>("name");
+  H.minPt     = histConf.getParameter<double>("minPt");
+  H.maxAbsEta = histConf.getParameter<double>("maxAbsEta");
+
+  const std::string matchName = histConf.getParameter<std::string>("match");
+  H.match = -1;
+  for( auto i=0U; i<muonMatches_.size(); ++i ) {
+    if( muonMatches_[i].name == matchName )
+      H.match = i;
+  }
+  if( H.match < 0 )
+    throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: efficiencyHist " << H.name << ": no muonMatch " << matchName;
+
+  const std::map<std::string, muonSelectorBit> bitNames = {
+#define MUONHLT_MUON_SELECTOR_BIT_NAME(name, bit) {#name, MuonHLT::k##name},
+    MUONHLT_MUON_SELECTOR_BITS(MUONHLT_MUON_SELECTOR_BIT_NAME)
+#undef MUONHLT_MUON_SELECTOR_BIT_NAME
+  };
+  H.selection = 0;
+  for( const auto& bitName : histConf.getParameter<std::vector<std::string> >("selection") ) {
+    auto bit = bitNames.find(bitName);
+    if( bit == bitNames.end() )
+      throw cms::Exception("ConfigurationError") << "MuonHLTNtupler: efficiencyHist " << H.name << ": unknown selection " << bitName;
+    H.selection |= (1u << bit->second);
+  }
+
+  efficiencyHists_.push_back(H);
+}
+
+void MuonHLTNtupler::Make_EfficiencyHist()
+{
+  edm::Service<TFileService> fs;
+  TFileDirectory dir = fs->mkdir("efficiency");
+
+  const std::string varNames[4] = {"pt", "eta", "phi", "nVertex"};
+  for( auto& H : efficiencyHists_ ) {
+    for( int v=0; v<4; ++v ) {
+      const std::vector<double>& bins = efficiencyBins_[v];
+      std::string denName = "h_"+H.name+"_den_"+varNames[v];
+      std::string numName = "h_"+H.name+"_num_"+varNames[v];
+      H.h_den[v] = dir.make<TH1D>(denName.c_str(), "", bins.size()-1, bins.data());
+      H.h_num[v] = dir.make<TH1D>(numName.c_str(), "", bins.size()-1, bins.data());
+      H.h_den[v]->Sumw2();
+      H.h_num[v]->Sumw2();
+    }
+    H.h_ptRes = dir.make<TH1D>(("h_"+H.name+"_ptRes").c_str(), "", 200, -1., 1.);
+    H.h_dR    = dir.make<TH1D>(("h_"+H.name+"_dR").c_str(),    "", 100, 0., muonMatches_[H.match].dR);
+  }
+}
+
+void MuonHLTNtupler::Fill_EfficiencyHist(const edm::Event &iEvent)
+{
+  // -- read here: genEventWeight_ is only set by Fill_GenParticle, not called without the gen group
+  double weight = 1.;
+  if( !isRealData_ ) {
+    edm::Handle<GenEventInfoProduct> h_genEventInfo;
+    if( !iEvent.getByToken(t_genEventInfo_, h_genEventInfo) )
+      throw cms::Exception("ProductNotFound") << "MuonHLTNtupler: doEfficiencyHist on MC needs the GenEventInfoProduct (genEventInfo) for the event weight";
+    weight = h_genEventInfo->weight();
+  }
+
+  for( auto& H : efficiencyHists_ ) {
+    const muonMatch& M = muonMatches_[H.match];
+
+    for( int i=0; i<nMuon_; ++i ) {
+      if( std::abs(muon_eta_[i]) > H.maxAbsEta )
+        continue;
+      if( (MuonSelectorBits(i) & H.selection) != H.selection )
+        continue;
+
+      const bool matched = M.idx[i] >= 0;
+      const double var[4] = { muon_pt_[i], muon_eta_[i], muon_phi_[i], (double)nVertex_ };
+      for( int v=0; v<4; ++v ) {
+        if( v > 0 && muon_pt_[i] < H.minPt ) // -- pT turn-on: no offline pT cut
+          break;
+        H.h_den[v]->Fill( var[v], weight );
+        if( matched ) H.h_num[v]->Fill( var[v], weight );
+      }
+
+      if( matched && muon_pt_[i] >= H.minPt ) {
+        const double onlinePt = M.filterNames ? (*M.vecPt)[M.idx[i]] : M.pt[M.idx[i]];
+        H.h_ptRes->Fill( (onlinePt - muon_pt_[i]) / muon_pt_[i], weight );
+        H.h_dR->Fill( M.matchDR[i], weight );
+      }
+    }
+  }
+}
+
+void MuonHLTNtupler::Fill_MuonMatch()
+{
+  // -- (index, eta, phi) of the online objects above minPt (and from the filter): collected once for all offline muons
+  std::vector<std::tuple<int, double, double>> cands;
+
+  for( auto& M : muonMatches_ ) {
+    cands.clear();
+    if( M.filterNames ) {
+      for( auto j=0U; j<M.filterNames->size(); ++j ) {
+        if( (*M.vecPt)[j] < M.minPt ) continue;
+        if( (*M.filterNames)[j] != M.filter ) continue;
+        cands.emplace_back( j, (*M.vecEta)[j], (*M.vecPhi)[j] );
+      }
+    }
+    else {
+      for( int j=0; j<*M.n; ++j ) {
+        if( M.pt[j] < M.minPt ) continue;
+        cands.emplace_back( j, M.eta[j], M.phi[j] );
+      }
+    }
+
+    const double maxDR2 = M.dR*M.dR;
+    for( int i=0; i<nMuon_; ++i ) {
+      int best = -1;
+      double bestDR2 = maxDR2;
+      for( const auto& cand : cands ) {
+        double dR2 = reco::deltaR2( muon_eta_[i], muon_phi_[i], std::get<1>(cand), std::get<2>(cand) );
+        if( dR2 < bestDR2 ) {
+          best = std::get<0>(cand);
+          bestDR2 = dR2;
+        }
+      }
+
+      M.idx[i]     = best;
+      M.matchDR[i] = best < 0 ? -99999. : std::sqrt(bestDR2);
+    }
+  }
+}
+
+void MuonHLTNtupler::Fill_Muon(const edm::Event &iEvent, const edm::EventSetup &iSetup)
+{
+  const PropagateToMuon& prop = *prop_;
 
-  edm::Handle<std::vector<reco::Muon> > h_offlineMuon;
-  if( iEvent.getByToken(t_offlineMuon_, h_offlineMuon) ) // -- only when the dataset has offline muon collection (e.g. AOD) -- //
+  edm::Handle<edm::View<reco::Muon> > h_offlineMuon;
+  if( iEvent.getByToken(t_offlineMuon_, h_offlineMuon) ) // -- only when the dataset has offline muon collection (e.g. AOD, MiniAOD) -- //
   {
       edm::Handle<reco::Centrality> hicentrality;
       edm::Handle<int> hicentralityBin;
@@ -1333,7 +2004,7 @@ void MuonHLTNtupler::Fill_Muon(const edm::Event &iEvent, const edm::EventSetup &
     const reco::Vertex & pv = h_offlineVertex->at(0);
 
     int _nMuon = 0;
-    for(std::vector<reco::Muon>::const_iterator mu=h_offlineMuon->begin(); mu!=h_offlineMuon->end(); ++mu)
+    for(edm::View<reco::Muon>::const_iterator mu=h_offlineMuon->begin(); mu!=h_offlineMuon->end(); ++mu)
     {
     	if( doHI) {
             hi_cBin = (int)*hicentralityBin;
@@ -1374,10 +2045,8 @@ void MuonHLTNtupler::Fill_Muon(const edm::Event &iEvent, const edm::EventSetup &
       if( muon::isHighPtMuon( (*mu), pv ) ) muon_isHighPt_[_nMuon] = 1;
       if( isNewHighPtMuon( (*mu), pv ) )    muon_isHighPtNew_[_nMuon] = 1;
 
-      // -- bool muon::isSoftMuon(const reco::Muon& muon, const reco::Vertex& vtx, bool run2016_hip_mitigation)
-      // -- it is different under CMSSW_8_0_29: bool muon::isSoftMuon(const reco::Muon& muon, const reco::Vertex& vtx)
-      // -- Remove this part to avoid compile error (and soft muon would not be used for now) - need to be fixed at some point
-      // if( muon::isSoftMuon( (*mu), pv, 0) ) muon_isSoft_[_nMuon] = 1;
+      // -- bool muon::isSoftMuon(const reco::Muon& muon, const reco::Vertex& vtx, bool run2016_hip_mitigation): no HIP mitigation (Run3)
+      if( muon::isSoftMuon( (*mu), pv, false ) ) muon_isSoft_[_nMuon] = 1;
 
       muon_iso03_sumPt_[_nMuon] = mu->isolationR03().sumPt;
       muon_iso03_hadEt_[_nMuon] = mu->isolationR03().hadEt;
@@ -1393,7 +2062,10 @@ void MuonHLTNtupler::Fill_Muon(const edm::Event &iEvent, const edm::EventSetup &
       muon_PFIso04_photon_[_nMuon]  = mu->pfIsolationR04().sumPhotonEt;
       muon_PFIso04_sumPU_[_nMuon]   = mu->pfIsolationR04().sumPUPt;
 
-      reco::MuonRef muRef = reco::MuonRef(h_offlineMuon, _nMuon);
+      if( doMuonSelectorBits_ )
+        muon_selectorBits_[_nMuon] = MuonSelectorBits(_nMuon);
+
+      edm::RefToBase<reco::Muon> muRef = h_offlineMuon->refAt(_nMuon);
 
       reco::TrackRef innerTrk = mu->innerTrack();
       if( innerTrk.isNonnull() )
@@ -1458,7 +2130,9 @@ void MuonHLTNtupler::Fill_Muon(const edm::Event &iEvent, const edm::EventSetup &
       muon_nMatchedRPCLayer_[_nMuon] = mu->numberOfMatchedRPCLayers();
       muon_stationMask_[_nMuon] = mu->stationMask();
 
-      pat::TriggerObjectStandAloneRef recol1Match = (*h_recol1Matches)[muRef];
+      // -- L1 matches: made from RAW, not in MiniAOD
+      pat::TriggerObjectStandAloneRef recol1Match;
+      if( h_recol1Matches.isValid() ) recol1Match = (*h_recol1Matches)[muRef];
       if (recol1Match.isNonnull()) {
         muon_l1pt_[_nMuon]      = recol1Match->pt();
         muon_l1eta_[_nMuon]     = recol1Match->eta();
@@ -1468,7 +2142,8 @@ void MuonHLTNtupler::Fill_Muon(const edm::Event &iEvent, const edm::EventSetup &
         muon_l1dr_[_nMuon]      = (*h_recol1Drs)[muRef];
       }
 
-      pat::TriggerObjectStandAloneRef recol1MatchByQ = (*h_recol1MatchesByQ)[muRef];
+      pat::TriggerObjectStandAloneRef recol1MatchByQ;
+      if( h_recol1MatchesByQ.isValid() ) recol1MatchByQ = (*h_recol1MatchesByQ)[muRef];
       if (recol1MatchByQ.isNonnull()) {
         muon_l1ptByQ_[_nMuon]      = recol1MatchByQ->pt();
         muon_l1etaByQ_[_nMuon]     = recol1MatchByQ->eta();
@@ -1553,23 +2228,7 @@ void MuonHLTNtupler::Fill_HLT(const edm::Event &iEvent, bool isMYHLT)
     iEvent.getByToken(t_triggerEvent_,   h_triggerEvent);
   }
 
-  edm::TriggerNames triggerNames = iEvent.triggerNames(*h_triggerResults);
-
-  for(unsigned int itrig=0; itrig<triggerNames.size(); ++itrig)
-  {
-    LogDebug("triggers") << triggerNames.triggerName(itrig);
-
-    if( h_triggerResults->accept(itrig) )
-    {
-      std::string pathName = triggerNames.triggerName(itrig);
-      if( SavedTriggerCondition(pathName) || isMYHLT )
-      {
-        if( isMYHLT ) vec_myFiredTrigger_.push_back( pathName );
-        else          vec_firedTrigger_.push_back( pathName );
-      }
-    } // -- end of if fired -- //
-
-  } // -- end of iteration over all trigger names -- //
+  Fill_FiredTrigger(iEvent, *h_triggerResults, isMYHLT);
 
   const trigger::size_type nFilter(h_triggerEvent->sizeFilters());
   for( trigger::size_type i_filter=0; i_filter<nFilter; i_filter++)
@@ -1605,6 +2264,132 @@ void MuonHLTNtupler::Fill_HLT(const edm::Event &iEvent, bool isMYHLT)
   } // -- end of filter iteration -- //
 }
 
+// -- HLT objects of MiniAOD: same branches as Fill_HLT(iEvent, 0)
+void MuonHLTNtupler::Fill_HLTMiniAOD(const edm::Event &iEvent)
+{
+  edm::Handle<edm::TriggerResults> h_triggerResults;
+  edm::Handle<std::vector<pat::TriggerObjectStandAlone> > h_triggerObject;
+  if( !iEvent.getByToken(t_triggerResults_, h_triggerResults) || !iEvent.getByToken(t_triggerObject_, h_triggerObject) )
+    return;
+
+  const edm::TriggerNames& triggerNames = iEvent.triggerNames(*h_triggerResults);
+
+  // -- new menu (at most once per run): path selection redone, filter selection cache cleared
+  if( miniAODMenu_.psetID != h_triggerResults->parameterSetID() || miniAODMenu_.pathSaved.size() != triggerNames.size() ) {
+    miniAODMenu_.psetID = h_triggerResults->parameterSetID();
+    miniAODMenu_.pathSaved.assign(triggerNames.size(), false);
+    for(unsigned int itrig=0; itrig<triggerNames.size(); ++itrig) {
+      std::string pathName = triggerNames.triggerName(itrig);
+      miniAODMenu_.pathSaved[itrig] = SavedTriggerCondition(pathName);
+    }
+    miniAODMenu_.filterName.clear();
+  }
+
+  for(unsigned int itrig=0; itrig<triggerNames.size(); ++itrig)
+  {
+    if( h_triggerResults->accept(itrig) && miniAODMenu_.pathSaved[itrig] )
+      vec_firedTrigger_.push_back( triggerNames.triggerName(itrig) );
+  }
+
+  for( const auto& obj : *h_triggerObject )
+  {
+    // -- preselection before the copy and the unpacking: the saved (muon) filters hold L1 and HLT muon objects
+    // -- objects of other types (e.g. the jets of a muon+jet L1 seed filter) are not saved from MiniAOD
+    if( !obj.hasTriggerObjectType(trigger::TriggerMuon) && !obj.hasTriggerObjectType(trigger::TriggerL1Mu) )
+      continue;
+
+    // -- packed filter labels: unpackFilterLabels is not const, so only the preselected objects are copied
+    // -- the label table is looked up by pat once per menu (TriggerResults parameter set)
+    pat::TriggerObjectStandAlone triggerObj(obj);
+    triggerObj.unpackFilterLabels(iEvent, *h_triggerResults);
+
+    for( const auto& label : triggerObj.filterLabels() )
+    {
+      auto it = miniAODMenu_.filterName.find(label);
+      if( it == miniAODMenu_.filterName.end() ) {
+        std::string filterName = edm::InputTag(label, "", miniAODProcess_).encode();
+        it = miniAODMenu_.filterName.emplace(label, SavedFilterCondition(filterName) ? filterName : std::string()).first;
+      }
+      if( it->second.empty() )
+        continue;
+
+      vec_filterName_.push_back( it->second );
+      vec_HLTObj_pt_.push_back( triggerObj.pt() );
+      vec_HLTObj_eta_.push_back( triggerObj.eta() );
+      vec_HLTObj_phi_.push_back( triggerObj.phi() );
+    }
+  }
+}
+
+void MuonHLTNtupler::Fill_MenuVariant(const edm::Event &iEvent, menuVariant &V)
+{
+  auto hasSuffix = [&V](const std::string& label) {
+    return label.size() >= V.suffix.size() && label.compare(label.size()-V.suffix.size(), V.suffix.size(), V.suffix) == 0;
+  };
+
+  edm::Handle<edm::TriggerResults>  h_triggerResults;
+  edm::Handle<trigger::TriggerEvent> h_triggerEvent;
+
+  if( iEvent.getByToken(V.triggerResultsToken, h_triggerResults) ) {
+    const edm::TriggerNames& triggerNames = iEvent.triggerNames(*h_triggerResults);
+    for( unsigned int itrig=0; itrig<triggerNames.size(); ++itrig ) {
+      const std::string& pathName = triggerNames.triggerName(itrig);
+      if( h_triggerResults->accept(itrig) && hasSuffix(pathName) )
+        V.firedTrigger.push_back( pathName.substr(0, pathName.size()-V.suffix.size()) );
+    }
+  }
+
+  if( iEvent.getByToken(V.triggerEventToken, h_triggerEvent) ) {
+    const trigger::TriggerObjectCollection& triggerObjects(h_triggerEvent->getObjects());
+    for( trigger::size_type i_filter=0; i_filter<h_triggerEvent->sizeFilters(); i_filter++ ) {
+      const edm::InputTag& filterTag = h_triggerEvent->filterTag(i_filter);
+      if( !hasSuffix(filterTag.label()) )
+        continue;
+
+      // -- same encoding as vec_myFilterName: label::process, label without the variant suffix
+      std::string filterName = edm::InputTag(filterTag.label().substr(0, filterTag.label().size()-V.suffix.size()), filterTag.instance(), filterTag.process()).encode();
+      for( const auto& objKey : h_triggerEvent->filterKeys(i_filter) ) {
+        const trigger::TriggerObject& triggerObj(triggerObjects[objKey]);
+        V.filterName.push_back( filterName );
+        V.HLTObj_pt.push_back( triggerObj.pt() );
+        V.HLTObj_eta.push_back( triggerObj.eta() );
+        V.HLTObj_phi.push_back( triggerObj.phi() );
+      }
+    }
+  }
+
+  edm::Handle<std::vector<reco::Muon> > h_iterL3Muon;
+  if( V.hasIterL3Muon && iEvent.getByToken(V.iterL3MuonToken, h_iterL3Muon) ) {
+    for( const auto& mu : *h_iterL3Muon ) {
+      V.iterL3Muon_pt.push_back( mu.pt() );
+      V.iterL3Muon_eta.push_back( mu.eta() );
+      V.iterL3Muon_phi.push_back( mu.phi() );
+    }
+  }
+}
+
+// -- fired paths: the HLT ones passing SavedTriggerCondition, all the rerun (MYHLT) ones
+void MuonHLTNtupler::Fill_FiredTrigger(const edm::Event &iEvent, const edm::TriggerResults &triggerResults, bool isMYHLT)
+{
+  const edm::TriggerNames& triggerNames = iEvent.triggerNames(triggerResults);
+
+  for(unsigned int itrig=0; itrig<triggerNames.size(); ++itrig)
+  {
+    LogDebug("triggers") << triggerNames.triggerName(itrig);
+
+    if( triggerResults.accept(itrig) )
+    {
+      std::string pathName = triggerNames.triggerName(itrig);
+      if( SavedTriggerCondition(pathName) || isMYHLT )
+      {
+        if( isMYHLT ) vec_myFiredTrigger_.push_back( pathName );
+        else          vec_firedTrigger_.push_back( pathName );
+      }
+    } // -- end of if fired -- //
+
+  } // -- end of iteration over all trigger names -- //
+}
+
 bool MuonHLTNtupler::SavedTriggerCondition( std::string& pathName )
 {
   bool flag = false;
@@ -2220,9 +3005,7 @@ void MuonHLTNtupler::Fill_IterL3(const edm::Event &iEvent, const edm::EventSetup
         tmpTrk trkTmp(innerTrk);
         iterL3IDpassed.push_back(trkTmp);
 
-        const PTrajectoryStateOnDet tmpseed = innerTrk->seedRef()->startingState();
-        tmpTSOD tsod(tmpseed);
-        MuonIterSeedMap.insert(make_pair(tsod,_nIterL3Muon));
+        MuonIterSeedMap.insert(innerTrk->seedRef()->startingState(), _nIterL3Muon);
       }
       else {
         cout << "IterL3Muon: innerTrk.isNonnull(): this should never happen" << endl;
@@ -2235,26 +3018,28 @@ void MuonHLTNtupler::Fill_IterL3(const edm::Event &iEvent, const edm::EventSetup
 
     nIterL3Muon_ = _nIterL3Muon;
   } // -- if getByToken is valid
+}
 
+void MuonHLTNtupler::Fill_TrackTemplates(const edm::Event &iEvent)
+{
   //////////////////////////
   // -- Tracks from each algo -- //
   //////////////////////////
   // edm::ESHandle<TrackerGeometry> tracker;
   // iSetup.get<TrackerDigiGeometryRecord>().get(tracker);
-  const TrackerGeometry& tracker = iSetup.getData(trackerGeometryToken_);
+  const TrackerGeometry& tracker = *tracker_;
 
   edm::Handle<reco::TrackToTrackingParticleAssociator> theAssociator;
   edm::Handle<TrackingParticleCollection> TPCollection;
 
   for( unsigned int i = 0; i < trackCollectionNames_.size(); ++i) {
+    if( budgetTimeExceeded(kBudgetTimeTracks) )
+      break;
+
     bool doIso = false;
-    if( i==2 ){ //Iter2FromL2Track
-      fill_trackTemplate( iEvent, trackCollectionTokens_.at(i), recoToSimCollectionTokens_.at(i), tracker, mvaHltIter2IterL3MuonPixelSeeds_, trkTemplates_.at(i), doIso );
-      fill_tpTemplate(    iEvent,                               simToRecoCollectionTokens_.at(i), tracker, mvaHltIter2IterL3MuonPixelSeeds_, tpTemplates_.at(i)         );
-    }
-    else if( i==4 ){ //Iter2FromL1Track
-      fill_trackTemplate( iEvent, trackCollectionTokens_.at(i), recoToSimCollectionTokens_.at(i), tracker, mvaHltIter2IterL3FromL1MuonPixelSeeds_, trkTemplates_.at(i), doIso );
-      fill_tpTemplate(    iEvent,                               simToRecoCollectionTokens_.at(i), tracker, mvaHltIter2IterL3FromL1MuonPixelSeeds_, tpTemplates_.at(i)         );
+    if( trackCollectionMva_.at(i) ){ //Iter2FromL2Track or Iter2FromL1Track, see mvaFromL2TrackCollections / mvaFromL1TrackCollections
+      fill_trackTemplate( iEvent, trackCollectionTokens_.at(i), recoToSimCollectionTokens_.at(i), tracker, *trackCollectionMva_.at(i), trkTemplates_.at(i), doIso );
+      fill_tpTemplate(    iEvent,                               simToRecoCollectionTokens_.at(i), tracker, *trackCollectionMva_.at(i), tpTemplates_.at(i)         );
     }
     else{
       fill_trackTemplate( iEvent, trackCollectionTokens_.at(i), recoToSimCollectionTokens_.at(i), trkTemplates_.at(i), doIso );
@@ -2269,7 +3054,8 @@ void MuonHLTNtupler::Fill_TP( const edm::Event &iEvent, tpTemplate* tpTmp )
 {
   edm::Handle<TrackingParticleCollection> TPCollection;
   if( iEvent.getByToken(trackingParticleToken, TPCollection) ) {
-    for( auto i=0U; i< TPCollection->size(); ++i) {
+    const unsigned int nTP = budgetLimit(TPCollection->size(), maxTPs_, kBudgetTPs);
+    for( auto i=0U; i<nTP; ++i) {
       if( abs(TPCollection->at(i).pdgId()) == 13 ) {
         tpTmp->fill( TPCollection->at(i) );
       }
@@ -2292,7 +3078,8 @@ void MuonHLTNtupler::fill_trackTemplate(
     if( iEvent.getByToken( assoToken, assoHandle ) ) {
       auto recSimColl = *assoHandle.product();
 
-      for( unsigned int i = 0; i < trkHandle->size(); i++ ) {
+      const unsigned int nTrack = budgetLimit(trkHandle->size(), maxTracks_, kBudgetTracks);
+      for( unsigned int i = 0; i < nTrack; i++ ) {
         TTtrack->fill(trkHandle->at(i), bs);
 
         auto track = trkHandle->refAt(i);
@@ -2314,7 +3101,8 @@ void MuonHLTNtupler::fill_trackTemplate(
         TTtrack->fillMva( -99999., -99999., -99999., -99999. );
       }
     }else{ // When No SimHit, Asso (ex. Data)
-      for( unsigned int i = 0; i < trkHandle->size(); i++ ) {
+      const unsigned int nTrack = budgetLimit(trkHandle->size(), maxTracks_, kBudgetTracks);
+      for( unsigned int i = 0; i < nTrack; i++ ) {
         TTtrack->fill(trkHandle->at(i), bs);
 
         // -- fill dummy
@@ -2354,7 +3142,8 @@ void MuonHLTNtupler::fill_trackTemplate(
     if( iEvent.getByToken( assoToken, assoHandle ) ) {
       auto recSimColl = *assoHandle.product();
 
-      for( unsigned int i = 0; i < trkHandle->size(); i++ ) {
+      const unsigned int nTrack = budgetLimit(trkHandle->size(), maxTracks_, kBudgetTracks);
+      for( unsigned int i = 0; i < nTrack; i++ ) {
         TTtrack->fill(trkHandle->at(i), bs);
 
         // -- fill dummy index
@@ -2395,7 +3184,8 @@ void MuonHLTNtupler::fill_trackTemplate(
         }
       }
     }else{ // When No SimHit, Asso (ex. Data)
-      for( unsigned int i = 0; i < trkHandle->size(); i++ ) {
+      const unsigned int nTrack = budgetLimit(trkHandle->size(), maxTracks_, kBudgetTracks);
+      for( unsigned int i = 0; i < nTrack; i++ ) {
         TTtrack->fill(trkHandle->at(i), bs);
 
         // -- fill dummy index
@@ -2442,7 +3232,8 @@ void MuonHLTNtupler::fill_tpTemplate(
     if( iEvent.getByToken( assoToken, assoHandle ) ) {
       auto simRecColl = *assoHandle.product();
 
-      for( unsigned int i = 0; i < TPCollection->size(); i++ ) {
+      const unsigned int nTP = budgetLimit(TPCollection->size(), maxTPs_, kBudgetTPs);
+      for( unsigned int i = 0; i < nTP; i++ ) {
 
         auto tp = TPCollection->at(i);
 
@@ -2545,7 +3336,8 @@ void MuonHLTNtupler::fill_tpTemplate(
     if( iEvent.getByToken( assoToken, assoHandle ) ) {
       auto simRecColl = *assoHandle.product();
 
-      for( unsigned int i = 0; i < TPCollection->size(); i++ ) {
+      const unsigned int nTP = budgetLimit(TPCollection->size(), maxTPs_, kBudgetTPs);
+      for( unsigned int i = 0; i < nTP; i++ ) {
 
         auto tp = TPCollection->at(i);
 
@@ -2672,7 +3464,92 @@ bool MuonHLTNtupler::isNewHighPtMuon(const reco::Muon& muon, const reco::Vertex&
   return muID && hits && momQuality && ip;
 }
 
+// -- from the ID and isolation values already filled for the i-th offline muon; layout: MuonSelectorBits.h
+unsigned int MuonHLTNtupler::MuonSelectorBits(int i_muon)
+{
+  unsigned int bits = 0;
+  auto setBit = [&bits](muonSelectorBit bit, bool pass) { if( pass ) bits |= (1u << bit); };
+
+  setBit( MuonHLT::kGLB,       muon_isGLB_[i_muon] );
+  setBit( MuonHLT::kSTA,       muon_isSTA_[i_muon] );
+  setBit( MuonHLT::kTRK,       muon_isTRK_[i_muon] );
+  setBit( MuonHLT::kPF,        muon_isPF_[i_muon] );
+  setBit( MuonHLT::kTight,     muon_isTight_[i_muon] );
+  setBit( MuonHLT::kMedium,    muon_isMedium_[i_muon] );
+  setBit( MuonHLT::kLoose,     muon_isLoose_[i_muon] );
+  setBit( MuonHLT::kHighPt,    muon_isHighPt_[i_muon] );
+  setBit( MuonHLT::kHighPtNew, muon_isHighPtNew_[i_muon] );
+  setBit( MuonHLT::kSoft,      muon_isSoft_[i_muon] );
+
+  const double pt = muon_pt_[i_muon];
+  if( pt > 0 ) {
+    const double relPFIso = ( muon_PFIso04_charged_[i_muon] +
+                              std::max(0., muon_PFIso04_neutral_[i_muon] + muon_PFIso04_photon_[i_muon] - 0.5*muon_PFIso04_sumPU_[i_muon]) ) / pt;
+    setBit( MuonHLT::kPFIsoVeryLoose,     relPFIso < 0.40 );
+    setBit( MuonHLT::kPFIsoLoose,         relPFIso < 0.25 );
+    setBit( MuonHLT::kPFIsoMedium,        relPFIso < 0.20 );
+    setBit( MuonHLT::kPFIsoTight,         relPFIso < 0.15 );
+    setBit( MuonHLT::kPFIsoVeryTight,     relPFIso < 0.10 );
+    setBit( MuonHLT::kPFIsoVeryVeryTight, relPFIso < 0.05 );
+
+    const double relTrkIso = muon_iso03_sumPt_[i_muon] / pt;
+    setBit( MuonHLT::kTrkIsoLoose, relTrkIso < 0.10 );
+    setBit( MuonHLT::kTrkIsoTight, relTrkIso < 0.05 );
+  }
+
+  return bits;
+}
+
 void MuonHLTNtupler::endJob() {
+  // -- job metadata: sampling, one entry
+  edm::Service<TFileService> fs;
+  TTree* metadata = fs->make<TTree>("metadata","metadata");
+  unsigned long long nEventProcessed = nEventProcessed_, nEventSampled = nEventSampled_;
+  metadata->Branch("sampleFraction", &sampleFraction_, "sampleFraction/D");
+  metadata->Branch("sampleSeed", &sampleSeed_, "sampleSeed/i");
+  metadata->Branch("nEventProcessed", &nEventProcessed, "nEventProcessed/l");
+  metadata->Branch("nEventSampled", &nEventSampled, "nEventSampled/l");
+  metadata->Fill();
+
+  if( doLumiSummary_ )
+    Write_LumiSummary();
+
+  if( seedNtuple_ )
+    seedNtuple_->endJob();
+
+  if( sampleFraction_ < 1. )
+    cout << "[MuonHLTNtupler::endJob] sampled " << nEventSampled_ << " / " << nEventProcessed_ << " events (fraction " << sampleFraction_ << ", seed " << sampleSeed_ << ")" << endl;
+
+  // -- a reference event missing here leaves its friend entry empty: fail the job instead of writing a misaligned friend tree
+  if( friendCheck_ ) {
+    if( !friendKeys_.empty() ) {
+      cms::Exception e("FriendMismatch");
+      e << "MuonHLTNtupler: " << friendKeys_.size() << " of the " << nFriendReference_ << " events of " << friendReference_
+        << " were not written by this job (same input files, no sampleFraction, one reference per job), e.g.";
+      int nPrint = 0;
+      for( auto key = friendKeys_.begin(); key != friendKeys_.end() && nPrint < 10; ++key, ++nPrint )
+        e << " " << key->run << ":" << key->lumi << ":" << key->event;
+      throw e;
+    }
+    cout << "[MuonHLTNtupler::endJob] friend tree verified against " << friendReference_ << ": " << nFilled_ << " events, all of its events written" << endl;
+  }
+
+  if( maxTracks_ > 0 || maxTPs_ > 0 || maxEventTime_ > 0. ) {
+    const char* budgetNames[nBudgetBit] = { "maxTracks: track collection truncated", "maxTPs: TP loop truncated",
+                                            "maxEventTime: Fill_IterL3 skipped", "maxEventTime: track templates skipped", "maxEventTime: Fill_TP skipped" };
+    cout << "[MuonHLTNtupler::endJob] event budget (maxTracks " << maxTracks_ << ", maxTPs " << maxTPs_ << ", maxEventTime " << maxEventTime_ << " ms), "
+         << nEventSampled_ << " events:" << endl;
+    for( int bit=0; bit<nBudgetBit; ++bit )
+      cout << "  " << std::left << std::setw(45) << budgetNames[bit] << nBudgetOverflow_[bit] << " events" << endl;
+  }
+
+  if( benchmarkESCache_ && nESCacheEvent_ > 0 ) {
+    cout << "[MuonHLTNtupler::endJob] EventSetup cache: " << nESCacheRebuild_ << " rebuilds in " << nESCacheEvent_ << " events" << endl;
+    cout << "  cached (watchers + rebuilds) " << std::fixed << std::setprecision(3) << 1e6*timeESCached_/nESCacheEvent_ << " us/event" << endl;
+    cout << "  rebuilt in every event       " << std::fixed << std::setprecision(3) << 1e6*timeESRebuild_/nESCacheEvent_ << " us/event" << endl;
+    cout << "  saving                       " << std::fixed << std::setprecision(3) << 1e6*(timeESRebuild_-timeESCached_)/nESCacheEvent_ << " us/event" << endl;
+  }
+
   //for( int i=0; i<4; ++i ) {
   // for( int i=0; i<1; ++i ) {
   //   delete mvaHltIter2IterL3MuonPixelSeeds_.at(i).first;
@@ -16,6 +16,7 @@
 
 #include "DataFormats/Common/interface/Handle.h"
 #include "DataFormats/Common/interface/View.h"
+#include "DataFormats/Common/interface/FillViewHelperVector.h"
 #include "DataFormats/Common/interface/TriggerResults.h"
 #include "DataFormats/HLTReco/interface/TriggerEvent.h"
 #include "DataFormats/HLTReco/interface/TriggerObject.h"
@@ -58,51 +59,78 @@
 #include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
 
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <iomanip>
 #include "TTree.h"
 
+#include "tbb/task_group.h"
+
 using namespace std;
 using namespace reco;
 using namespace edm;
 
 
-MuonHLTSeedNtupler::MuonHLTSeedNtupler(const edm::ParameterSet& iConfig):
-trackerGeometryToken_(esConsumes<TrackerGeometry, TrackerDigiGeometryRecord>()),
+MuonHLTSeedNtupleMaker::MuonHLTSeedNtupleMaker(const edm::ParameterSet& iConfig, edm::ConsumesCollector&& iC):
+trackerGeometryToken_(iC.esConsumes<TrackerGeometry, TrackerDigiGeometryRecord>()),
+tracker_(nullptr),
 
 // trackerHitAssociatorConfig_(iConfig, consumesCollector()),
-associatorToken(consumes<reco::TrackToTrackingParticleAssociator>(iConfig.getUntrackedParameter<edm::InputTag>("associator"))),
-seedAssociatorToken(consumes<reco::TrackToTrackingParticleAssociator>(iConfig.getUntrackedParameter<edm::InputTag>("seedAssociator"))),
-trackingParticleToken(consumes<TrackingParticleCollection>(iConfig.getUntrackedParameter<edm::InputTag>("trackingParticle"))),
-
-t_offlineVertex_     ( consumes< reco::VertexCollection >                 (iConfig.getUntrackedParameter<edm::InputTag>("offlineVertex"     )) ),
-t_PUSummaryInfo_     ( consumes< std::vector<PileupSummaryInfo> >         (iConfig.getUntrackedParameter<edm::InputTag>("PUSummaryInfo"     )) ),
-
-t_L1Muon_            ( consumes< l1t::MuonBxCollection  >                 (iConfig.getUntrackedParameter<edm::InputTag>("L1Muon"            )) ),
-t_L2Muon_            ( consumes< reco::RecoChargedCandidateCollection >   (iConfig.getUntrackedParameter<edm::InputTag>("L2Muon"            )) ),
-
-// t_L1TkMuon_          ( consumes< l1t::TkMuonCollection >                  (iConfig.getUntrackedParameter<edm::InputTag>("L1TkMuon"))),
-// t_L1TkPrimaryVertex_ ( consumes< l1t::TkPrimaryVertexCollection >         (iConfig.getUntrackedParameter<edm::InputTag>("L1TkPrimaryVertex"))),
-
-t_hltIterL3OISeedsFromL2Muons_ ( consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIterL3OISeedsFromL2Muons")) ),
-t_hltIter0IterL3MuonPixelSeedsFromPixelTracks_ ( consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter0IterL3MuonPixelSeedsFromPixelTracks")) ),
-t_hltIter2IterL3MuonPixelSeeds_ ( consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter2IterL3MuonPixelSeeds")) ),
-t_hltIter3IterL3MuonPixelSeeds_ ( consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter3IterL3MuonPixelSeeds")) ),
-t_hltIter0IterL3FromL1MuonPixelSeedsFromPixelTracks_ ( consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter0IterL3FromL1MuonPixelSeedsFromPixelTracks")) ),
-t_hltIter2IterL3FromL1MuonPixelSeeds_ ( consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter2IterL3FromL1MuonPixelSeeds")) ),
-t_hltIter3IterL3FromL1MuonPixelSeeds_ ( consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter3IterL3FromL1MuonPixelSeeds")) ),
-
-t_hltIterL3OIMuonTrack_    ( consumes< edm::View<reco::Track> >                  (iConfig.getUntrackedParameter<edm::InputTag>("hltIterL3OIMuonTrack"    )) ),
-t_hltIter0IterL3MuonTrack_    ( consumes< edm::View<reco::Track> >               (iConfig.getUntrackedParameter<edm::InputTag>("hltIter0IterL3MuonTrack"    )) ),
-t_hltIter2IterL3MuonTrack_    ( consumes< edm::View<reco::Track> >               (iConfig.getUntrackedParameter<edm::InputTag>("hltIter2IterL3MuonTrack"    )) ),
-t_hltIter3IterL3MuonTrack_    ( consumes< edm::View<reco::Track> >               (iConfig.getUntrackedParameter<edm::InputTag>("hltIter3IterL3MuonTrack"    )) ),
-t_hltIter0IterL3FromL1MuonTrack_    ( consumes< edm::View<reco::Track> >         (iConfig.getUntrackedParameter<edm::InputTag>("hltIter0IterL3FromL1MuonTrack"    )) ),
-t_hltIter2IterL3FromL1MuonTrack_    ( consumes< edm::View<reco::Track> >         (iConfig.getUntrackedParameter<edm::InputTag>("hltIter2IterL3FromL1MuonTrack"    )) ),
-t_hltIter3IterL3FromL1MuonTrack_    ( consumes< edm::View<reco::Track> >         (iConfig.getUntrackedParameter<edm::InputTag>("hltIter3IterL3FromL1MuonTrack"    )) ),
-
-t_genParticle_       ( consumes< reco::GenParticleCollection >            (iConfig.getUntrackedParameter<edm::InputTag>("genParticle"       )) )
+associatorToken(iC.consumes<reco::TrackToTrackingParticleAssociator>(iConfig.getUntrackedParameter<edm::InputTag>("associator"))),
+seedAssociatorToken(iC.consumes<reco::TrackToTrackingParticleAssociator>(iConfig.getUntrackedParameter<edm::InputTag>("seedAssociator"))),
+trackingParticleToken(iC.consumes<TrackingParticleCollection>(iConfig.getUntrackedParameter<edm::InputTag>("trackingParticle"))),
+
+t_offlineVertex_     ( iC.consumes< reco::VertexCollection >                 (iConfig.getUntrackedParameter<edm::InputTag>("offlineVertex"     )) ),
+t_PUSummaryInfo_     ( iC.consumes< std::vector<PileupSummaryInfo> >         (iConfig.getUntrackedParameter<edm::InputTag>("PUSummaryInfo"     )) ),
+
+t_L1Muon_            ( iC.consumes< l1t::MuonBxCollection  >                 (iConfig.getUntrackedParameter<edm::InputTag>("L1Muon"            )) ),
+t_L2Muon_            ( iC.consumes< reco::RecoChargedCandidateCollection >   (iConfig.getUntrackedParameter<edm::InputTag>("L2Muon"            )) ),
+
+// t_L1TkMuon_          ( iC.consumes< l1t::TkMuonCollection >                  (iConfig.getUntrackedParameter<edm::InputTag>("L1TkMuon"))),
+// t_L1TkPrimaryVertex_ ( iC.consumes< l1t::TkPrimaryVertexCollection >         (iConfig.getUntrackedParameter<edm::InputTag>("L1TkPrimaryVertex"))),
+
+t_hltIterL3OISeedsFromL2Muons_ ( iC.consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIterL3OISeedsFromL2Muons")) ),
+t_hltIter0IterL3MuonPixelSeedsFromPixelTracks_ ( iC.consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter0IterL3MuonPixelSeedsFromPixelTracks")) ),
+t_hltIter2IterL3MuonPixelSeeds_ ( iC.consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter2IterL3MuonPixelSeeds")) ),
+t_hltIter3IterL3MuonPixelSeeds_ ( iC.consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter3IterL3MuonPixelSeeds")) ),
+t_hltIter0IterL3FromL1MuonPixelSeedsFromPixelTracks_ ( iC.consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter0IterL3FromL1MuonPixelSeedsFromPixelTracks")) ),
+t_hltIter2IterL3FromL1MuonPixelSeeds_ ( iC.consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter2IterL3FromL1MuonPixelSeeds")) ),
+t_hltIter3IterL3FromL1MuonPixelSeeds_ ( iC.consumes< edm::View<TrajectorySeed> >     (iConfig.getUntrackedParameter<edm::InputTag>("hltIter3IterL3FromL1MuonPixelSeeds")) ),
+
+t_hltIterL3OIMuonTrack_    ( iC.consumes< edm::View<reco::Track> >                  (iConfig.getUntrackedParameter<edm::InputTag>("hltIterL3OIMuonTrack"    )) ),
+t_hltIter0IterL3MuonTrack_    ( iC.consumes< edm::View<reco::Track> >               (iConfig.getUntrackedParameter<edm::InputTag>("hltIter0IterL3MuonTrack"    )) ),
+t_hltIter2IterL3MuonTrack_    ( iC.consumes< edm::View<reco::Track> >               (iConfig.getUntrackedParameter<edm::InputTag>("hltIter2IterL3MuonTrack"    )) ),
+t_hltIter3IterL3MuonTrack_    ( iC.consumes< edm::View<reco::Track> >               (iConfig.getUntrackedParameter<edm::InputTag>("hltIter3IterL3MuonTrack"    )) ),
+t_hltIter0IterL3FromL1MuonTrack_    ( iC.consumes< edm::View<reco::Track> >         (iConfig.getUntrackedParameter<edm::InputTag>("hltIter0IterL3FromL1MuonTrack"    )) ),
+t_hltIter2IterL3FromL1MuonTrack_    ( iC.consumes< edm::View<reco::Track> >         (iConfig.getUntrackedParameter<edm::InputTag>("hltIter2IterL3FromL1MuonTrack"    )) ),
+t_hltIter3IterL3FromL1MuonTrack_    ( iC.consumes< edm::View<reco::Track> >         (iConfig.getUntrackedParameter<edm::InputTag>("hltIter3IterL3FromL1MuonTrack"    )) ),
+
+t_genParticle_       ( iC.consumes< reco::GenParticleCollection >            (iConfig.getUntrackedParameter<edm::InputTag>("genParticle"       )) )
 {
+  doColumnar_ = iConfig.getParameter<bool>("doColumnar");
+  doBinaryExport_ = iConfig.getParameter<bool>("doBinaryExport");
+  binaryExportPrefix_ = iConfig.getParameter<std::string>("binaryExportPrefix");
+  unmatchedSeedKeepFraction_ = iConfig.getParameter<edm::ParameterSet>("unmatchedSeedKeepFraction");
+  maxSeeds_ = iConfig.getParameter<unsigned int>("maxSeeds");
+
+  bool validateSeedTrackLink = iConfig.getParameter<bool>("validateSeedTrackLink");
+  hltIterL3OIMuonTrackMap.setValidation(validateSeedTrackLink);
+  hltIter0IterL3MuonTrackMap.setValidation(validateSeedTrackLink);
+  hltIter2IterL3MuonTrackMap.setValidation(validateSeedTrackLink);
+  hltIter3IterL3MuonTrackMap.setValidation(validateSeedTrackLink);
+  hltIter0IterL3FromL1MuonTrackMap.setValidation(validateSeedTrackLink);
+  hltIter2IterL3FromL1MuonTrackMap.setValidation(validateSeedTrackLink);
+  hltIter3IterL3FromL1MuonTrackMap.setValidation(validateSeedTrackLink);
+
+  t_hltIterL3OIMuonTrackAsso_          = consumes_TrackAssociation(iConfig, iC, "hltIterL3OIMuonTrackAssociation");
+  t_hltIter0IterL3MuonTrackAsso_       = consumes_TrackAssociation(iConfig, iC, "hltIter0IterL3MuonTrackAssociation");
+  t_hltIter2IterL3MuonTrackAsso_       = consumes_TrackAssociation(iConfig, iC, "hltIter2IterL3MuonTrackAssociation");
+  t_hltIter3IterL3MuonTrackAsso_       = consumes_TrackAssociation(iConfig, iC, "hltIter3IterL3MuonTrackAssociation");
+  t_hltIter0IterL3FromL1MuonTrackAsso_ = consumes_TrackAssociation(iConfig, iC, "hltIter0IterL3FromL1MuonTrackAssociation");
+  t_hltIter2IterL3FromL1MuonTrackAsso_ = consumes_TrackAssociation(iConfig, iC, "hltIter2IterL3FromL1MuonTrackAssociation");
+  t_hltIter3IterL3FromL1MuonTrackAsso_ = consumes_TrackAssociation(iConfig, iC, "hltIter3IterL3FromL1MuonTrackAssociation");
+
   mvaFileHltIter2IterL3MuonPixelSeeds_B_                      = iConfig.getParameter<edm::FileInPath>("mvaFileHltIter2IterL3MuonPixelSeeds_B");
   mvaFileHltIter2IterL3FromL1MuonPixelSeeds_B_                = iConfig.getParameter<edm::FileInPath>("mvaFileHltIter2IterL3FromL1MuonPixelSeeds_B");
   mvaFileHltIter2IterL3MuonPixelSeeds_E_                      = iConfig.getParameter<edm::FileInPath>("mvaFileHltIter2IterL3MuonPixelSeeds_E");
@@ -127,7 +155,7 @@ t_genParticle_       ( consumes< reco::GenParticleCollection >            (iConf
   );
 }
 
-void MuonHLTSeedNtupler::analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup)
+void MuonHLTSeedNtupleMaker::analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup)
 {
   Init();
 
@@ -138,26 +166,37 @@ void MuonHLTSeedNtupler::analyze(const edm::Event &iEvent, const edm::EventSetup
   NTEvent_->Fill();
 }
 
-void MuonHLTSeedNtupler::beginJob()
+void MuonHLTSeedNtupleMaker::beginJob(TFileDirectory &dir)
 {
-  edm::Service<TFileService> fs;
+  NTEvent_    = dir.make<TTree>("NTEvent","NTEvent");  
 
-  NTEvent_    = fs->make<TTree>("NTEvent","NTEvent");  
+  // -- columnar layout: seeds are stored in NTEvent, no per-seed trees -- //
+  if( !doColumnar_ ) {
+    NThltIterL3OI_    = dir.make<TTree>("NThltIterL3OI","NThltIterL3OI");
 
-  NThltIterL3OI_    = fs->make<TTree>("NThltIterL3OI","NThltIterL3OI");
+    NThltIter0_       = dir.make<TTree>("NThltIter0","NThltIter0");
+    NThltIter2_       = dir.make<TTree>("NThltIter2","NThltIter2");
+    NThltIter3_       = dir.make<TTree>("NThltIter3","NThltIter3");
 
-  NThltIter0_       = fs->make<TTree>("NThltIter0","NThltIter0");
-  NThltIter2_       = fs->make<TTree>("NThltIter2","NThltIter2");
-  NThltIter3_       = fs->make<TTree>("NThltIter3","NThltIter3");
-
-  NThltIter0FromL1_ = fs->make<TTree>("NThltIter0FromL1","NThltIter0FromL1");
-  NThltIter2FromL1_ = fs->make<TTree>("NThltIter2FromL1","NThltIter2FromL1");
-  NThltIter3FromL1_ = fs->make<TTree>("NThltIter3FromL1","NThltIter3FromL1");
+    NThltIter0FromL1_ = dir.make<TTree>("NThltIter0FromL1","NThltIter0FromL1");
+    NThltIter2FromL1_ = dir.make<TTree>("NThltIter2FromL1","NThltIter2FromL1");
+    NThltIter3FromL1_ = dir.make<TTree>("NThltIter3FromL1","NThltIter3FromL1");
+  }
 
   Make_Branch();
+
+  // -- same order as the former serial calls
+  seedCollections_.clear();
+  add_seedCollection("hltIterL3OI",    t_hltIterL3OISeedsFromL2Muons_,                       nullptr,                                 hltIterL3OIMuonTrackMap,          TThltIterL3OIMuonTrack,          NThltIterL3OI_,    SChltIterL3OI,    nhltIterL3OI_ );
+  add_seedCollection("hltIter0",       t_hltIter0IterL3MuonPixelSeedsFromPixelTracks_,       nullptr,                                 hltIter0IterL3MuonTrackMap,       TThltIter0IterL3MuonTrack,       NThltIter0_,       SChltIter0,       nhltIter0_ );
+  add_seedCollection("hltIter3",       t_hltIter3IterL3MuonPixelSeeds_,                      nullptr,                                 hltIter3IterL3MuonTrackMap,       TThltIter3IterL3MuonTrack,       NThltIter3_,       SChltIter3,       nhltIter3_ );
+  add_seedCollection("hltIter0FromL1", t_hltIter0IterL3FromL1MuonPixelSeedsFromPixelTracks_, nullptr,                                 hltIter0IterL3FromL1MuonTrackMap, TThltIter0IterL3FromL1MuonTrack, NThltIter0FromL1_, SChltIter0FromL1, nhltIter0FromL1_ );
+  add_seedCollection("hltIter3FromL1", t_hltIter3IterL3FromL1MuonPixelSeeds_,                nullptr,                                 hltIter3IterL3FromL1MuonTrackMap, TThltIter3IterL3FromL1MuonTrack, NThltIter3FromL1_, SChltIter3FromL1, nhltIter3FromL1_ );
+  add_seedCollection("hltIter2",       t_hltIter2IterL3MuonPixelSeeds_,                      &mvaHltIter2IterL3MuonPixelSeeds_,       hltIter2IterL3MuonTrackMap,       TThltIter2IterL3MuonTrack,       NThltIter2_,       SChltIter2,       nhltIter2_ );
+  add_seedCollection("hltIter2FromL1", t_hltIter2IterL3FromL1MuonPixelSeeds_,                &mvaHltIter2IterL3FromL1MuonPixelSeeds_, hltIter2IterL3FromL1MuonTrackMap, TThltIter2IterL3FromL1MuonTrack, NThltIter2FromL1_, SChltIter2FromL1, nhltIter2FromL1_ );
 }
 
-void MuonHLTSeedNtupler::Init()
+void MuonHLTSeedNtupleMaker::Init()
 {
   runNum_       = -999;
   lumiBlockNum_ = -999;
@@ -171,6 +210,7 @@ void MuonHLTSeedNtupler::Init()
   nhltIter0FromL1_ = 0;
   nhltIter2FromL1_ = 0;
   nhltIter3FromL1_ = 0;
+  seedBudgetOverflow_ = 0;
   hltIterL3OIMuonTrackMap.clear();
   hltIter0IterL3MuonTrackMap.clear();
   hltIter2IterL3MuonTrackMap.clear();
@@ -181,6 +221,14 @@ void MuonHLTSeedNtupler::Init()
 
   ST->clear();
 
+  SChltIterL3OI->clear();
+  SChltIter0->clear();
+  SChltIter2->clear();
+  SChltIter3->clear();
+  SChltIter0FromL1->clear();
+  SChltIter2FromL1->clear();
+  SChltIter3FromL1->clear();
+
   TThltIterL3OIMuonTrack->clear();
   TThltIter0IterL3MuonTrack->clear();
   TThltIter2IterL3MuonTrack->clear();
@@ -190,7 +238,7 @@ void MuonHLTSeedNtupler::Init()
   TThltIter3IterL3FromL1MuonTrack->clear();
 }
 
-void MuonHLTSeedNtupler::Make_Branch()
+void MuonHLTSeedNtupleMaker::Make_Branch()
 {
   NTEvent_->Branch("runNum",&runNum_,"runNum/I");
   NTEvent_->Branch("lumiBlockNum",&lumiBlockNum_,"lumiBlockNum/I");
@@ -204,16 +252,29 @@ void MuonHLTSeedNtupler::Make_Branch()
   NTEvent_->Branch("nhltIter0FromL1",  &nhltIter0FromL1_, "nhltIter0FromL1/I");
   NTEvent_->Branch("nhltIter2FromL1",  &nhltIter2FromL1_, "nhltIter2FromL1/I");
   NTEvent_->Branch("nhltIter3FromL1",  &nhltIter3FromL1_, "nhltIter3FromL1/I");
-  ST->setBranch(NThltIterL3OI_);
-  ST->setBranch(NThltIter0_);
-  ST->setBranch(NThltIter2_);
-  ST->setBranch(NThltIter3_);
-  ST->setBranch(NThltIter0FromL1_);
-  ST->setBranch(NThltIter2FromL1_);
-  ST->setBranch(NThltIter3FromL1_);
+  NTEvent_->Branch("seedBudgetOverflow", &seedBudgetOverflow_, "seedBudgetOverflow/i");
+
+  if( doColumnar_ ) {
+    SChltIterL3OI->setBranch(NTEvent_, "hltIterL3OI");
+    SChltIter0->setBranch(NTEvent_, "hltIter0");
+    SChltIter2->setBranch(NTEvent_, "hltIter2");
+    SChltIter3->setBranch(NTEvent_, "hltIter3");
+    SChltIter0FromL1->setBranch(NTEvent_, "hltIter0FromL1");
+    SChltIter2FromL1->setBranch(NTEvent_, "hltIter2FromL1");
+    SChltIter3FromL1->setBranch(NTEvent_, "hltIter3FromL1");
+  }
+  else {
+    ST->setBranch(NThltIterL3OI_);
+    ST->setBranch(NThltIter0_);
+    ST->setBranch(NThltIter2_);
+    ST->setBranch(NThltIter3_);
+    ST->setBranch(NThltIter0FromL1_);
+    ST->setBranch(NThltIter2FromL1_);
+    ST->setBranch(NThltIter3FromL1_);
+  }
 }
 
-void MuonHLTSeedNtupler::Fill_Event(const edm::Event &iEvent)
+void MuonHLTSeedNtupleMaker::Fill_Event(const edm::Event &iEvent)
 {
   // -- basic info.
   runNum_       = iEvent.id().run();
@@ -247,47 +308,283 @@ void MuonHLTSeedNtupler::Fill_Event(const edm::Event &iEvent)
   }
 }
 
-void MuonHLTSeedNtupler::Fill_IterL3TT(const edm::Event &iEvent)
+void MuonHLTSeedNtupleMaker::Fill_IterL3TT(const edm::Event &iEvent)
 {
   edm::Handle<reco::TrackToTrackingParticleAssociator> theAssociator;
   edm::Handle<TrackingParticleCollection> TPCollection;
 
-  if( iEvent.getByToken(associatorToken, theAssociator) && iEvent.getByToken(trackingParticleToken, TPCollection) ) {
-    fill_trackTemplate(iEvent,t_hltIterL3OIMuonTrack_,theAssociator,TPCollection,hltIterL3OIMuonTrackMap,TThltIterL3OIMuonTrack);
-    fill_trackTemplate(iEvent,t_hltIter0IterL3MuonTrack_,theAssociator,TPCollection,hltIter0IterL3MuonTrackMap,TThltIter0IterL3MuonTrack);
-    fill_trackTemplate(iEvent,t_hltIter2IterL3MuonTrack_,theAssociator,TPCollection,hltIter2IterL3MuonTrackMap,TThltIter2IterL3MuonTrack);
-    fill_trackTemplate(iEvent,t_hltIter3IterL3MuonTrack_,theAssociator,TPCollection,hltIter3IterL3MuonTrackMap,TThltIter3IterL3MuonTrack);
-    fill_trackTemplate(iEvent,t_hltIter0IterL3FromL1MuonTrack_,theAssociator,TPCollection,hltIter0IterL3FromL1MuonTrackMap,TThltIter0IterL3FromL1MuonTrack);
-    fill_trackTemplate(iEvent,t_hltIter2IterL3FromL1MuonTrack_,theAssociator,TPCollection,hltIter2IterL3FromL1MuonTrackMap,TThltIter2IterL3FromL1MuonTrack);
-    fill_trackTemplate(iEvent,t_hltIter3IterL3FromL1MuonTrack_,theAssociator,TPCollection,hltIter3IterL3FromL1MuonTrackMap,TThltIter3IterL3FromL1MuonTrack);
+  if( iEvent.getByToken(trackingParticleToken, TPCollection) ) {
+    // -- the associator is only needed for the collections without an upstream association
+    bool hasAssociator = iEvent.getByToken(associatorToken, theAssociator);
+
+    fill_trackTemplate(iEvent,t_hltIterL3OIMuonTrack_,t_hltIterL3OIMuonTrackAsso_,hasAssociator,theAssociator,TPCollection,hltIterL3OIMuonTrackMap,TThltIterL3OIMuonTrack);
+    fill_trackTemplate(iEvent,t_hltIter0IterL3MuonTrack_,t_hltIter0IterL3MuonTrackAsso_,hasAssociator,theAssociator,TPCollection,hltIter0IterL3MuonTrackMap,TThltIter0IterL3MuonTrack);
+    fill_trackTemplate(iEvent,t_hltIter2IterL3MuonTrack_,t_hltIter2IterL3MuonTrackAsso_,hasAssociator,theAssociator,TPCollection,hltIter2IterL3MuonTrackMap,TThltIter2IterL3MuonTrack);
+    fill_trackTemplate(iEvent,t_hltIter3IterL3MuonTrack_,t_hltIter3IterL3MuonTrackAsso_,hasAssociator,theAssociator,TPCollection,hltIter3IterL3MuonTrackMap,TThltIter3IterL3MuonTrack);
+    fill_trackTemplate(iEvent,t_hltIter0IterL3FromL1MuonTrack_,t_hltIter0IterL3FromL1MuonTrackAsso_,hasAssociator,theAssociator,TPCollection,hltIter0IterL3FromL1MuonTrackMap,TThltIter0IterL3FromL1MuonTrack);
+    fill_trackTemplate(iEvent,t_hltIter2IterL3FromL1MuonTrack_,t_hltIter2IterL3FromL1MuonTrackAsso_,hasAssociator,theAssociator,TPCollection,hltIter2IterL3FromL1MuonTrackMap,TThltIter2IterL3FromL1MuonTrack);
+    fill_trackTemplate(iEvent,t_hltIter3IterL3FromL1MuonTrack_,t_hltIter3IterL3FromL1MuonTrackAsso_,hasAssociator,theAssociator,TPCollection,hltIter3IterL3FromL1MuonTrackMap,TThltIter3IterL3FromL1MuonTrack);
   }
 }
 
-void MuonHLTSeedNtupler::Fill_Seed(const edm::Event &iEvent, const edm::EventSetup &iSetup)
+void MuonHLTSeedNtupleMaker::Fill_Seed(const edm::Event &iEvent, const edm::EventSetup &iSetup)
 {
   // TrackerHitAssociator associate(iEvent, trackerHitAssociatorConfig_);
   // edm::ESHandle<TrackerGeometry> tracker;
   // iSetup.get<TrackerDigiGeometryRecord>().get(tracker);
-  const TrackerGeometry& tracker = iSetup.getData(trackerGeometryToken_);
+  // -- new tracker geometry IOV: the GeomDet pointers cached by the collections are stale
+  if( trackerGeometryWatcher_.check(iSetup) || tracker_ == nullptr ) {
+    tracker_ = &iSetup.getData(trackerGeometryToken_);
+    for( auto& coll : seedCollections_ )
+      coll.work.geomDetCache.clear();
+  }
+  const TrackerGeometry& tracker = *tracker_;
+
+  // -- gen, L1 and L2 muons are shared by all seed collections: pack them once per event
+  pack_Candidates(iEvent);
+
+  // -- every product is fetched here, serially; the tasks below only read them
+  edm::Handle<reco::TrackToTrackingParticleAssociator> theAssociator;
+  edm::Handle<TrackingParticleCollection> theTPCollection;
+  bool hasAsso = iEvent.getByToken(seedAssociatorToken, theAssociator) && iEvent.getByToken(trackingParticleToken, theTPCollection);
+
+  edm::Handle<l1t::MuonBxCollection> h_L1Muon;
+  iEvent.getByToken(t_L1Muon_, h_L1Muon);
+
+  edm::Handle<reco::RecoChargedCandidateCollection> h_L2Muon;
+  iEvent.getByToken( t_L2Muon_, h_L2Muon );
+
+  // -- one association per distinct seed product, owned by the first collection reading it
+  std::vector<const seedCollection*> assoOwners;
+  for( auto& coll : seedCollections_ ) {
+    coll.work.clear();
+    coll.overflow = false;
+    coll.hasSeed = iEvent.getByToken( *coll.token, coll.seedHandle );
+    coll.assoIndex = -1;
+    if( !coll.hasSeed || !hasAsso )
+      continue;
+
+    for( auto j=0U; j<assoOwners.size(); ++j ) {
+      if( assoOwners[j]->seedHandle.id() == coll.seedHandle.id() ) {
+        coll.assoIndex = j;
+        break;
+      }
+    }
+    if( coll.assoIndex < 0 ) {
+      coll.assoIndex = assoOwners.size();
+      assoOwners.push_back(&coll);
+    }
+  }
+
+  // -- downsampling and seed budget first: the dropped seeds cost only the track lookup and are never associated
+  for( auto& coll : seedCollections_ ) {
+    if( coll.hasSeed )
+      select_Seeds(coll);
+  }
+
+  // -- per seed product, the kept seeds of all collections reading it; a subset view keeps the product id and keys
+  std::vector<std::vector<unsigned>> assoKept(assoOwners.size());
+  for( const auto& coll : seedCollections_ ) {
+    if( coll.assoIndex >= 0 )
+      assoKept[coll.assoIndex].insert(assoKept[coll.assoIndex].end(), coll.work.kept.begin(), coll.work.kept.end());
+  }
+
+  std::vector<edm::View<TrajectorySeed>> assoViews(assoOwners.size());
+  for( auto j=0U; j<assoOwners.size(); ++j ) {
+    std::vector<unsigned>& kept = assoKept[j];
+    std::sort(kept.begin(), kept.end());
+    kept.erase(std::unique(kept.begin(), kept.end()), kept.end());
+
+    const edm::Handle< edm::View<TrajectorySeed> >& seedHandle = assoOwners[j]->seedHandle;
+    if( kept.size() == seedHandle->size() )
+      continue;
+
+    std::vector<void const*> pointers;
+    edm::FillViewHelperVector helpers;
+    pointers.reserve(kept.size());
+    helpers.reserve(kept.size());
+    for( unsigned i : kept ) {
+      pointers.push_back(&(*seedHandle)[i]);
+      helpers.emplace_back(seedHandle.id(), seedHandle->refAt(i).key());
+    }
+    assoViews[j] = edm::View<TrajectorySeed>(pointers, helpers, &iEvent.productGetter());
+  }
+
+  seedAssociations_.clear();
+  seedAssociations_.resize(assoOwners.size());
+
+  // -- seed to TP associations of the kept seeds, one task per seed product, as the collections below look them up
+  tbb::task_group tasks;
+  for( auto j=0U; j<assoOwners.size(); ++j ) {
+    tasks.run( [&, j]() {
+      const edm::Handle< edm::View<TrajectorySeed> >& seedHandle = assoOwners[j]->seedHandle;
+      if( assoKept[j].size() == seedHandle->size() )
+        seedAssociations_[j] = theAssociator->associateRecoToSim(seedHandle, theTPCollection);
+      else
+        seedAssociations_[j] = theAssociator->associateRecoToSim(edm::Handle< edm::View<TrajectorySeed> >(&assoViews[j], seedHandle.provenance()), theTPCollection);
+    } );
+  }
+  tasks.wait();
+
+  // -- feature extraction, association lookup and MVA: one task per collection on the framework's TBB arena
+  for( auto& coll : seedCollections_ ) {
+    if( !coll.hasSeed )
+      continue;
+
+    tasks.run( [&, pColl = &coll]() {
+      fill_seedTemplate(*pColl, tracker, h_L1Muon, h_L2Muon);
+    } );
+  }
+  tasks.wait();
+
+  for( auto i=0U; i<seedCollections_.size(); ++i ) {
+    if( seedCollections_[i].overflow ) {
+      seedBudgetOverflow_ |= (1u << i);
+      seedCollections_[i].nOverflow++;
+    }
+  }
+
+  // -- tree fills are serialized, collection by collection in a fixed order: output identical to a serial run
+  for( auto& coll : seedCollections_ ) {
+    for( const auto& row : coll.work.rows ) {
+      if( doColumnar_ ) {
+        coll.SC->fill(&row);
+      }
+      else {
+        *ST = row;
+        ST->fill_ntuple(coll.NT);
+      }
+
+      if( coll.exporter )
+        coll.exporter->fill(runNum_, lumiBlockNum_, eventNum_, &row);
+    }
+  }
+}
+
+void MuonHLTSeedNtupleMaker::add_seedCollection(
+  std::string name,
+  edm::EDGetTokenT<edm::View<TrajectorySeed>>& token,
+  const pairSeedMvaEstimator* mva,
+  seedTrackIndex& trkMap,
+  trkTemplate* TTtrack,
+  TTree* NT,
+  seedColumns* SC,
+  int& nSeed
+) {
+  seedCollection coll;
+  coll.token   = &token;
+  coll.mva     = mva;
+  coll.trkMap  = &trkMap;
+  coll.TTtrack = TTtrack;
+  coll.NT      = NT;
+  coll.SC      = SC;
+  coll.nSeed   = &nSeed;
+  coll.name    = name;
+  coll.hasSeed = false;
+  coll.assoIndex = -1;
+  coll.overflow = false;
+  coll.nOverflow = 0;
+
+  if( doBinaryExport_ ) {
+    coll.exporter = std::make_unique<seedExport>();
+    coll.exporter->open(binaryExportPrefix_+"_"+name+".bin");
+  }
+
+  coll.keepFraction = unmatchedSeedKeepFraction_.getParameter<double>(name);
+  if( coll.keepFraction <= 0. || coll.keepFraction > 1. )
+    throw cms::Exception("ConfigurationError") << "unmatchedSeedKeepFraction." << name << " = " << coll.keepFraction << " is not in (0, 1]";
+
+  // -- FNV-1a of the collection name: stable across jobs and releases, unlike std::hash
+  coll.nameHash = 14695981039346656037ULL;
+  for( unsigned char c : name ) {
+    coll.nameHash ^= c;
+    coll.nameHash *= 1099511628211ULL;
+  }
+
+  seedCollections_.push_back(std::move(coll));
+}
 
-  fill_seedTemplate(iEvent, t_hltIterL3OISeedsFromL2Muons_,                       tracker, hltIterL3OIMuonTrackMap,          TThltIterL3OIMuonTrack,          NThltIterL3OI_,    nhltIterL3OI_ );
-  fill_seedTemplate(iEvent, t_hltIter0IterL3MuonPixelSeedsFromPixelTracks_,       tracker, hltIter0IterL3MuonTrackMap,       TThltIter0IterL3MuonTrack,       NThltIter0_,       nhltIter0_ );
-  fill_seedTemplate(iEvent, t_hltIter3IterL3MuonPixelSeeds_,                      tracker, hltIter3IterL3MuonTrackMap,       TThltIter3IterL3MuonTrack,       NThltIter3_,       nhltIter3_ );
-  fill_seedTemplate(iEvent, t_hltIter0IterL3FromL1MuonPixelSeedsFromPixelTracks_, tracker, hltIter0IterL3FromL1MuonTrackMap, TThltIter0IterL3FromL1MuonTrack, NThltIter0FromL1_, nhltIter0FromL1_ );
-  fill_seedTemplate(iEvent, t_hltIter3IterL3FromL1MuonPixelSeeds_,                tracker, hltIter3IterL3FromL1MuonTrackMap, TThltIter3IterL3FromL1MuonTrack, NThltIter3FromL1_, nhltIter3FromL1_ );
+double MuonHLTSeedNtupleMaker::seedSamplingUniform( unsigned run, unsigned long long event, uint64_t nameHash, unsigned iSeed )
+{
+  // -- splitmix64 finalizer over the combined key
+  uint64_t h = nameHash;
+  for( uint64_t key : { (uint64_t)run, (uint64_t)event, (uint64_t)iSeed } ) {
+    h += key + 0x9e3779b97f4a7c15ULL;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    h ^= (h >> 31);
+  }
 
-  fill_seedTemplate(iEvent, t_hltIter2IterL3MuonPixelSeeds_,                      mvaHltIter2IterL3MuonPixelSeeds_,                      tracker, hltIter2IterL3MuonTrackMap,       TThltIter2IterL3MuonTrack,       NThltIter2_,       nhltIter2_ );
-  fill_seedTemplate(iEvent, t_hltIter2IterL3FromL1MuonPixelSeeds_,                mvaHltIter2IterL3FromL1MuonPixelSeeds_,                tracker, hltIter2IterL3FromL1MuonTrackMap, TThltIter2IterL3FromL1MuonTrack, NThltIter2FromL1_, nhltIter2FromL1_ );
+  return (h >> 11) * 0x1.0p-53;
 }
 
-void MuonHLTSeedNtupler::fill_trackTemplate(const edm::Event &iEvent, edm::EDGetTokenT<edm::View<reco::Track>>& theToken,
-  edm::Handle<reco::TrackToTrackingParticleAssociator>& theAssociator_, edm::Handle<TrackingParticleCollection>& TPCollection_,
-  std::map<tmpTSOD,unsigned int>& trkMap, trkTemplate* TTtrack) {
+// -- decides which seeds are kept before any per-seed work is done:
+// -- seeds of a true muon track (same definition as trueMatched in the export) are always kept,
+// -- the others with probability keepFraction and weight 1/keepFraction
+void MuonHLTSeedNtupleMaker::select_Seeds(seedCollection& coll)
+{
+  seedWork* W = &coll.work;
+  const edm::View<TrajectorySeed>& seeds = *coll.seedHandle;
+  seedTrackIndex& trkMap = *coll.trkMap;
+
+  for( auto i=0U; i<seeds.size(); ++i )
+  {
+    int idxtmpL3 = trkMap.find(seeds[i].startingState());
+
+    float weight = 1.;
+    if( coll.keepFraction < 1. ) {
+      bool isMatched = idxtmpL3 >= 0 && coll.TTtrack->get_matchedTPsize(idxtmpL3) > 0 && std::abs(coll.TTtrack->get_bestMatchTP_pdgId(idxtmpL3)) == 13;
+      if( !isMatched ) {
+        if( seedSamplingUniform(runNum_, eventNum_, coll.nameHash, i) >= coll.keepFraction )
+          continue;
+        weight = 1. / coll.keepFraction;
+      }
+    }
+
+    // -- seed budget: the first maxSeeds kept seeds only
+    if( maxSeeds_ > 0 && W->kept.size() == maxSeeds_ ) {
+      coll.overflow = true;
+      break;
+    }
+
+    W->kept.push_back(i);
+    W->keptWeight.push_back(weight);
+    W->keptTrk.push_back(idxtmpL3);
+  }
+}
+
+edm::EDGetTokenT<reco::RecoToSimCollection> MuonHLTSeedNtupleMaker::consumes_TrackAssociation(const edm::ParameterSet& iConfig, edm::ConsumesCollector& iC, const std::string& name)
+{
+  edm::InputTag tag = iConfig.getUntrackedParameter<edm::InputTag>(name);
+  if( tag.label().empty() )
+    return edm::EDGetTokenT<reco::RecoToSimCollection>();
+
+  return iC.consumes<reco::RecoToSimCollection>(tag);
+}
+
+void MuonHLTSeedNtupleMaker::fill_trackTemplate(const edm::Event &iEvent, edm::EDGetTokenT<edm::View<reco::Track>>& theToken,
+  edm::EDGetTokenT<reco::RecoToSimCollection>& assoToken,
+  bool hasAssociator, edm::Handle<reco::TrackToTrackingParticleAssociator>& theAssociator_, edm::Handle<TrackingParticleCollection>& TPCollection_,
+  seedTrackIndex& trkMap, trkTemplate* TTtrack) {
 
   edm::Handle<edm::View<reco::Track>> trkHandle;
   if( iEvent.getByToken( theToken, trkHandle ) )
   {
-    auto recSimColl = theAssociator_->associateRecoToSim(trkHandle,TPCollection_);
+    // -- association produced upstream if configured, otherwise computed here
+    reco::RecoToSimCollection recSimCollOwn;
+    const reco::RecoToSimCollection* recSimCollPtr = &recSimCollOwn;
+    if( !assoToken.isUninitialized() ) {
+      edm::Handle<reco::RecoToSimCollection> assoHandle;
+      if( !iEvent.getByToken(assoToken, assoHandle) )
+        return;
+      recSimCollPtr = assoHandle.product();
+    }
+    else {
+      if( !hasAssociator )
+        return;
+      recSimCollOwn = theAssociator_->associateRecoToSim(trkHandle,TPCollection_);
+    }
+    const reco::RecoToSimCollection& recSimColl = *recSimCollPtr;
     //cout<<"recSimColl.size() == "<<recSimColl.size()<<endl;
     //cout<<"trkHandle.size() == "<<trkHandle->size()<<endl;
     //cout<<"TPCollection_.size() == "<<TPCollection_->size()<<endl;
@@ -299,9 +596,7 @@ void MuonHLTSeedNtupler::fill_trackTemplate(const edm::Event &iEvent, edm::EDGet
       int linkNo = -1;
       TTtrack->linkIterL3(linkNo);
 
-      const PTrajectoryStateOnDet tmpseed = trkHandle->at(i).seedRef()->startingState();
-      tmpTSOD tsod(tmpseed);
-      trkMap.insert(make_pair(tsod,i));
+      trkMap.insert(trkHandle->at(i).seedRef()->startingState(), i);
 
       auto track = trkHandle->refAt(i);
       auto TPfound = recSimColl.find(track);
@@ -323,268 +618,64 @@ void MuonHLTSeedNtupler::fill_trackTemplate(const edm::Event &iEvent, edm::EDGet
   }
 }
 
-void MuonHLTSeedNtupler::fill_seedTemplate(
-  const edm::Event &iEvent,
-  edm::EDGetTokenT<edm::View<TrajectorySeed>>& theToken,
+void MuonHLTSeedNtupleMaker::fill_seedTemplate(
+  seedCollection& coll,
   const TrackerGeometry& tracker,
-  std::map<tmpTSOD,unsigned int>& trkMap,
-  trkTemplate* TTtrack,
-  TTree* NT,
-  int &nSeed
+  const edm::Handle<l1t::MuonBxCollection>& h_L1Muon,
+  const edm::Handle<reco::RecoChargedCandidateCollection>& h_L2Muon
 ) {
+  seedWork* W = &coll.work;
+  const edm::Handle< edm::View<TrajectorySeed> >& seedHandle = coll.seedHandle;
 
-  edm::Handle<reco::TrackToTrackingParticleAssociator> theAssociator;
-  edm::Handle<TrackingParticleCollection> theTPCollection;
-  bool hasAsso = iEvent.getByToken(seedAssociatorToken, theAssociator) && iEvent.getByToken(trackingParticleToken, theTPCollection);
+  *coll.nSeed = seedHandle->size();
 
-  edm::Handle<reco::GenParticleCollection> h_genParticle;
-  bool hasGen = iEvent.getByToken(t_genParticle_, h_genParticle);
+  // -- W->kept was filled by select_Seeds in Fill_Seed, before the association
+  // -- global state of the kept seeds first, then L1, L2 and gen matching in one go
+  fill_seedBatch(W, *seedHandle, tracker);
+  match_Seeds(W);
 
-  edm::Handle<l1t::MuonBxCollection> h_L1Muon;
-  bool hasL1 = iEvent.getByToken(t_L1Muon_, h_L1Muon);
-
-  edm::Handle<reco::RecoChargedCandidateCollection> h_L2Muon;
-  bool hasL2 = iEvent.getByToken( t_L2Muon_, h_L2Muon );
+  // -- seed to TP association of the kept seeds, computed in analyze() and looked up per seed below
+  const bool hasAsso = coll.assoIndex >= 0;
+  const reco::RecoToSimCollectionSeed* recSimColl = hasAsso ? &seedAssociations_[coll.assoIndex] : nullptr;
 
-  edm::Handle< edm::View<TrajectorySeed> > seedHandle;
-  if( iEvent.getByToken( theToken, seedHandle) )
+  // -- k: position among the kept seeds (batch, match results, rows), i: index in the collection
+  W->rows.resize(W->kept.size());
+  for( auto k=0U; k<W->kept.size(); ++k )
   {
-    nSeed = seedHandle->size();
-    for( auto i=0U; i<seedHandle->size(); ++i )
-    {
-      const auto& seed(seedHandle->at(i));
-
-      tmpTSOD seedTsod(seed.startingState());
-      ST->clear();
-
-      ST->fill_PU(
-        truePU_
-      );
-
-      // -- Track association
-      ST->fill(seed, tracker);
-      std::map<tmpTSOD,unsigned int>::const_iterator where = trkMap.find(seedTsod);
-      int idxtmpL3 = (where==trkMap.end()) ? -1 : trkMap[seedTsod];
-      ST->fill_TP(TTtrack, idxtmpL3 );
-
-      if( hasAsso )
-      {
-        auto recSimColl = theAssociator->associateRecoToSim(seedHandle,theTPCollection);
-        auto seed = seedHandle->refAt(i);
-        auto TPfound = recSimColl.find(seed);
-        if (TPfound != recSimColl.end()) {
-          const auto& TPmatch = TPfound->val;
-          ST->fill_SeedTP(TPmatch[0].first);
-          ST->fill_SeedTPsharedFrac(TPmatch[0].second);
-          ST->fill_matchedSeedTPsize(TPmatch.size());
-        }
-      }
-
-      GlobalVector global_p = tracker.idToDet(seed.startingState().detId())->surface().toGlobal(seed.startingState().parameters().momentum());
-      GlobalPoint  global_x = tracker.idToDet(seed.startingState().detId())->surface().toGlobal(seed.startingState().parameters().position());
-
-      // -- GenParticle (muon) tag -- //
-      if( hasGen )
-      {
-        float gen_pt = -99999.;
-        float gen_eta = -99999.;
-        float gen_phi = -99999.;
-        float dR_GenSeed = 99999.;
-        for(auto genp = h_genParticle->begin(); genp != h_genParticle->end(); genp++)
-        {
-          if( fabs(genp->pdgId()) ==  13 && genp->status()==1 )
-          {
-            GlobalVector vec_seed_vtx( global_x.x() - genp->vx(), global_x.y() - genp->vy(), global_x.z() - genp->vz() );
-            if( reco::deltaR( *genp, vec_seed_vtx ) < dR_GenSeed ) {
-              dR_GenSeed = reco::deltaR( *genp, vec_seed_vtx );
-              gen_pt = genp->pt();
-              gen_eta = genp->eta();
-              gen_phi = genp->phi();
-            }
-          }
-        }
-        ST->fill_Genvars(
-          gen_pt,
-          gen_eta,
-          gen_phi
-        );
-      }
-
-      // -- L1, L2 association
-      if( hasL1 ) {
-        int nL1Muon = 0;
-        float dR_minDRL1SeedP = 99999.;
-        float dPhi_minDRL1SeedP = 99999.;
-        float dR_minDPhiL1SeedX = 99999.;
-        float dPhi_minDPhiL1SeedX = 99999.;
-        float dR_minDRL1SeedP_AtVtx = 99999.;
-        float dPhi_minDRL1SeedP_AtVtx = 99999.;
-        float dR_minDPhiL1SeedX_AtVtx = 99999.;
-        float dPhi_minDPhiL1SeedX_AtVtx = 99999.;
-        float L1Muon_pt = 99999.;
-        float L1Muon_eta = 99999.;
-        float L1Muon_phi = 99999.;
-        for(int ibx = h_L1Muon->getFirstBX(); ibx<=h_L1Muon->getLastBX(); ++ibx)
-        {
-          if(ibx != 0) continue; // -- only take when ibx == 0 -- //
-          for(auto it=h_L1Muon->begin(ibx); it!=h_L1Muon->end(ibx); it++)
-          {
-            l1t::MuonRef ref_L1Mu(h_L1Muon, distance(h_L1Muon->begin(h_L1Muon->getFirstBX()), it) );
-
-            if(ref_L1Mu->hwQual() < 7)
-              continue;
-
-            nL1Muon ++;
-            float dR_L1SeedP   = reco::deltaR( *ref_L1Mu, global_p);
-            float dPhi_L1SeedP = reco::deltaPhi( ref_L1Mu->phi(), global_p.phi());
-            float dR_L1SeedX   = reco::deltaR( *ref_L1Mu, global_x);
-            float dPhi_L1SeedX = reco::deltaPhi( ref_L1Mu->phi(), global_x.phi());
-
-            if( dR_L1SeedP < dR_minDRL1SeedP ) {
-              dR_minDRL1SeedP = dR_L1SeedP;
-              dPhi_minDRL1SeedP = dPhi_L1SeedP;
-            }
-            if( fabs(dPhi_L1SeedX) < fabs(dPhi_minDPhiL1SeedX) ) {
-              dR_minDPhiL1SeedX = dR_L1SeedX;
-              dPhi_minDPhiL1SeedX = dPhi_L1SeedX;
-            }
-
-            float dR_L1SeedP_AtVtx   = reco::deltaR( ref_L1Mu->etaAtVtx(), ref_L1Mu->phiAtVtx(), global_p.eta(), global_p.phi());
-            float dPhi_L1SeedP_AtVtx = reco::deltaPhi( ref_L1Mu->phiAtVtx(), global_p.phi());
-            float dR_L1SeedX_AtVtx   = reco::deltaR( ref_L1Mu->etaAtVtx(), ref_L1Mu->phiAtVtx(), global_x.eta(), global_x.phi());
-            float dPhi_L1SeedX_AtVtx = reco::deltaPhi( ref_L1Mu->phiAtVtx(), global_x.phi());
-
-            if( dR_L1SeedP_AtVtx < dR_minDRL1SeedP_AtVtx ) {
-              dR_minDRL1SeedP_AtVtx = dR_L1SeedP_AtVtx;
-              dPhi_minDRL1SeedP_AtVtx = dPhi_L1SeedP_AtVtx;
-              L1Muon_pt = ref_L1Mu->pt();
-              L1Muon_eta = ref_L1Mu->etaAtVtx();
-              L1Muon_phi = ref_L1Mu->phiAtVtx();
-            }
-            if( fabs(dPhi_L1SeedX_AtVtx) < fabs(dPhi_minDPhiL1SeedX_AtVtx) ) {
-              dR_minDPhiL1SeedX_AtVtx = dR_L1SeedX_AtVtx;
-              dPhi_minDPhiL1SeedX_AtVtx = dPhi_L1SeedX_AtVtx;
-            }
-          }
-        }
-        ST->fill_L1vars(nL1Muon,
-          dR_minDRL1SeedP,         dPhi_minDRL1SeedP,
-          dR_minDPhiL1SeedX,       dPhi_minDPhiL1SeedX,
-          dR_minDRL1SeedP_AtVtx,   dPhi_minDRL1SeedP_AtVtx,
-          dR_minDPhiL1SeedX_AtVtx, dPhi_minDPhiL1SeedX_AtVtx,
-          L1Muon_pt,               L1Muon_eta,                L1Muon_phi
-        );
-      }
-
-      if( hasL2 && h_L2Muon->size() > 0 ) {
-        int nL2Muon = 0;
-        float dR_minDRL2SeedP = 99999.;
-        float dPhi_minDRL2SeedP = 99999.;
-        float dR_minDPhiL2SeedX = 99999.;
-        float dPhi_minDPhiL2SeedX = 99999.;
-        float L2Muon_pt = 99999.;
-        float L2Muon_eta = 99999.;
-        float L2Muon_phi = 99999.;
-        nL2Muon = h_L2Muon->size();
-        for( unsigned int i_L2=0; i_L2<h_L2Muon->size(); i_L2++)
-        {
-          reco::RecoChargedCandidateRef ref_L2Mu(h_L2Muon, i_L2);
-
-          float dR_L2SeedP   = reco::deltaR( *ref_L2Mu, global_p);
-          float dPhi_L2SeedP = reco::deltaPhi( ref_L2Mu->phi(), global_p.phi());
-          float dR_L2SeedX   = reco::deltaR( *ref_L2Mu, global_x);
-          float dPhi_L2SeedX = reco::deltaPhi( ref_L2Mu->phi(), global_x.phi());
-
-          if( dR_L2SeedP < dR_minDRL2SeedP ) {
-            dR_minDRL2SeedP = dR_L2SeedP;
-            dPhi_minDRL2SeedP = dPhi_L2SeedP;
-            L2Muon_pt = ref_L2Mu->pt();
-            L2Muon_eta = ref_L2Mu->eta();
-            L2Muon_phi = ref_L2Mu->phi();
-          }
-          if( fabs(dPhi_L2SeedX) < fabs(dPhi_minDPhiL2SeedX) ) {
-            dR_minDPhiL2SeedX = dR_L2SeedX;
-            dPhi_minDPhiL2SeedX = dPhi_L2SeedX;
-          }
-        }
-
-        ST->fill_L2vars(nL2Muon,
-          dR_minDRL2SeedP,         dPhi_minDRL2SeedP,
-          dR_minDPhiL2SeedX,       dPhi_minDPhiL2SeedX,
-          L2Muon_pt,               L2Muon_eta,                L2Muon_phi
-        );
-      }
-
-      ST->fill_ntuple(NT);
-    } // -- end of seed iteration
-  } // -- if getByToken is valid
-}
-
-void MuonHLTSeedNtupler::fill_seedTemplate(
-  const edm::Event &iEvent,
-  edm::EDGetTokenT<edm::View<TrajectorySeed>>& theToken,
-  const pairSeedMvaEstimator& pairMvaEstimator,
-  const TrackerGeometry& tracker,
-  std::map<tmpTSOD,unsigned int>& trkMap,
-  trkTemplate* TTtrack,
-  TTree* NT,
-  int &nSeed
-) {
-
-  edm::Handle<reco::TrackToTrackingParticleAssociator> theAssociator;
-  edm::Handle<TrackingParticleCollection> theTPCollection;
-  bool hasAsso = iEvent.getByToken(seedAssociatorToken, theAssociator) && iEvent.getByToken(trackingParticleToken, theTPCollection);
+    const unsigned i = W->kept[k];
+    const auto& seed(seedHandle->at(i));
+    seedTemplate* row = &W->rows[k];
 
-  edm::Handle<reco::GenParticleCollection> h_genParticle;
-  bool hasGen = iEvent.getByToken(t_genParticle_, h_genParticle);
+    row->clear();
 
-  edm::Handle<l1t::MuonBxCollection> h_L1Muon;
-  bool hasL1 = iEvent.getByToken(t_L1Muon_, h_L1Muon);
-  const l1t::MuonBxCollection l1Muons = *(h_L1Muon.product());
+    row->fill_PU(
+      truePU_
+    );
+    row->fill_weight( W->keptWeight[k] );
 
-  edm::Handle<reco::RecoChargedCandidateCollection> h_L2Muon;
-  bool hasL2 = iEvent.getByToken( t_L2Muon_, h_L2Muon );
-  const reco::RecoChargedCandidateCollection l2Muons = *(h_L2Muon.product());
+    // -- Track association
+    row->fill(seed, W->SB.p[k], W->SB.x[k]);
+    row->fill_TP(coll.TTtrack, W->keptTrk[k] );
 
-  edm::Handle< edm::View<TrajectorySeed> > seedHandle;
-  if( iEvent.getByToken( theToken, seedHandle) )
-  {
-    nSeed = seedHandle->size();
-    for( auto i=0U; i<seedHandle->size(); ++i )
+    if( hasAsso )
     {
-      const auto& seed(seedHandle->at(i));
-
-      tmpTSOD seedTsod(seed.startingState());
-      ST->clear();
-
-      ST->fill_PU(
-        truePU_
-      );
-
-      // -- Track association
-      ST->fill(seed, tracker);
-      std::map<tmpTSOD,unsigned int>::const_iterator where = trkMap.find(seedTsod);
-      int idxtmpL3 = (where==trkMap.end()) ? -1 : trkMap[seedTsod];
-      //cout<<"[SeedNtupler] fill_TP : i="<<i<<", index tmpL3="<<idxtmpL3<<endl;
-      ST->fill_TP(TTtrack, idxtmpL3 );
-
-      if( hasAsso )
-      {
-        auto recSimColl = theAssociator->associateRecoToSim(seedHandle,theTPCollection);
-        auto seed = seedHandle->refAt(i);
-        auto TPfound = recSimColl.find(seed);
-        if (TPfound != recSimColl.end()) {
-          const auto& TPmatch = TPfound->val;
-          ST->fill_SeedTP(TPmatch[0].first);
-          ST->fill_SeedTPsharedFrac(TPmatch[0].second);
-          ST->fill_matchedSeedTPsize(TPmatch.size());
-        }
+      auto TPfound = recSimColl->find(seedHandle->refAt(i));
+      if (TPfound != recSimColl->end()) {
+        const auto& TPmatch = TPfound->val;
+        row->fill_SeedTP(TPmatch[0].first);
+        row->fill_SeedTPsharedFrac(TPmatch[0].second);
+        row->fill_matchedSeedTPsize(TPmatch.size());
       }
+    }
 
-      GlobalVector global_p = tracker.idToDet(seed.startingState().detId())->surface().toGlobal(seed.startingState().parameters().momentum());
-      GlobalPoint  global_x = tracker.idToDet(seed.startingState().detId())->surface().toGlobal(seed.startingState().parameters().position());
+    // -- BDT -- //
+    if( coll.mva )
+    {
+      const pairSeedMvaEstimator& pairMvaEstimator = *coll.mva;
+      const l1t::MuonBxCollection& l1Muons = *(h_L1Muon.product());
+      const reco::RecoChargedCandidateCollection& l2Muons = *(h_L2Muon.product());
+      const GlobalVector& global_p = W->SB.p[k];
 
-      // -- BDT -- //
       vector<double> v_mva = {};
       for(auto ic=0U; ic<pairMvaEstimator.size(); ++ic) {
         if( fabs( global_p.eta() ) < 1.2 ) {
@@ -606,152 +697,264 @@ void MuonHLTSeedNtupler::fill_seedTemplate(
           v_mva.push_back( mva );
         }
       }
-      //if( v_mva.size() != 4 ) {
-      //  cout << "v_mva.size() != 4" << endl;
-      //  return;
-      //}
       //ST->fill_Mva( v_mva[0], v_mva[1], v_mva[2], v_mva[3] );
-      ST->fill_Mva( v_mva[0], -99999., -99999., -99999.);
+      row->fill_Mva( v_mva[0], -99999., -99999., -99999.);
+    }
+
+    // -- GenParticle (muon) tag, L1, L2 association -- //
+    fill_Matches(W, k, row);
+  } // -- end of seed iteration
+}
+
+void MuonHLTSeedNtupleMaker::pack_Candidates(const edm::Event &iEvent)
+{
+  SoAgenMuon->clear();
+  SoAL1Muon->clear();
+  SoAL2Muon->clear();
+
+  edm::Handle<reco::GenParticleCollection> h_genParticle;
+  hasGen_ = iEvent.getByToken(t_genParticle_, h_genParticle);
+  if( hasGen_ )
+  {
+    for(auto genp = h_genParticle->begin(); genp != h_genParticle->end(); genp++)
+    {
+      if( fabs(genp->pdgId()) ==  13 && genp->status()==1 )
+        SoAgenMuon->fill(*genp);
+    }
+  }
 
-      // -- GenParticle (muon) tag -- //
-      if( hasGen )
+  edm::Handle<l1t::MuonBxCollection> h_L1Muon;
+  hasL1_ = iEvent.getByToken(t_L1Muon_, h_L1Muon);
+  if( hasL1_ )
+  {
+    for(int ibx = h_L1Muon->getFirstBX(); ibx<=h_L1Muon->getLastBX(); ++ibx)
+    {
+      if(ibx != 0) continue; // -- only take when ibx == 0 -- //
+      for(auto it=h_L1Muon->begin(ibx); it!=h_L1Muon->end(ibx); it++)
       {
-        float gen_pt = -99999.;
-        float gen_eta = -99999.;
-        float gen_phi = -99999.;
-        float dR_GenSeed = 99999.;
-        for(auto genp = h_genParticle->begin(); genp != h_genParticle->end(); genp++)
-        {
-          if( fabs(genp->pdgId()) ==  13 && genp->status()==1 )
-          {
-            GlobalVector vec_seed_vtx( global_x.x() - genp->vx(), global_x.y() - genp->vy(), global_x.z() - genp->vz() );
-            if( reco::deltaR( *genp, vec_seed_vtx ) < dR_GenSeed ) {
-              dR_GenSeed = reco::deltaR( *genp, vec_seed_vtx );
-              gen_pt = genp->pt();
-              gen_eta = genp->eta();
-              gen_phi = genp->phi();
-              //cout<<"(gen_pt, gen_eta, gen_phi, dR) = ("<<gen_pt<<", "<<gen_eta<<", "<<gen_phi<<", "<<dR_GenSeed<<")"<<endl;
-            }
-          }
-        }
-        ST->fill_Genvars(
-          gen_pt,
-          gen_eta,
-          gen_phi
-        );
+        if(it->hwQual() < 7)
+          continue;
+
+        SoAL1Muon->fill(*it);
       }
+    }
+  }
 
-      // -- L1, L2 association
-      if( hasL1 ) {
-        int nL1Muon = 0;
-        float dR_minDRL1SeedP = 99999.;
-        float dPhi_minDRL1SeedP = 99999.;
-        float dR_minDPhiL1SeedX = 99999.;
-        float dPhi_minDPhiL1SeedX = 99999.;
-        float dR_minDRL1SeedP_AtVtx = 99999.;
-        float dPhi_minDRL1SeedP_AtVtx = 99999.;
-        float dR_minDPhiL1SeedX_AtVtx = 99999.;
-        float dPhi_minDPhiL1SeedX_AtVtx = 99999.;
-        float L1Muon_pt = 99999.;
-        float L1Muon_eta = 99999.;
-        float L1Muon_phi = 99999.;
-        for(int ibx = h_L1Muon->getFirstBX(); ibx<=h_L1Muon->getLastBX(); ++ibx)
-        {
-          if(ibx != 0) continue; // -- only take when ibx == 0 -- //
-          for(auto it=h_L1Muon->begin(ibx); it!=h_L1Muon->end(ibx); it++)
-          {
-            l1t::MuonRef ref_L1Mu(h_L1Muon, distance(h_L1Muon->begin(h_L1Muon->getFirstBX()), it) );
-
-            if(ref_L1Mu->hwQual() < 7)
-              continue;
-
-	    nL1Muon ++;
-            float dR_L1SeedP   = reco::deltaR( *ref_L1Mu, global_p);
-            float dPhi_L1SeedP = reco::deltaPhi( ref_L1Mu->phi(), global_p.phi());
-            float dR_L1SeedX   = reco::deltaR( *ref_L1Mu, global_x);
-            float dPhi_L1SeedX = reco::deltaPhi( ref_L1Mu->phi(), global_x.phi());
-
-            if( dR_L1SeedP < dR_minDRL1SeedP ) {
-              dR_minDRL1SeedP = dR_L1SeedP;
-              dPhi_minDRL1SeedP = dPhi_L1SeedP;
-            }
-            if( fabs(dPhi_L1SeedX) < fabs(dPhi_minDPhiL1SeedX) ) {
-              dR_minDPhiL1SeedX = dR_L1SeedX;
-              dPhi_minDPhiL1SeedX = dPhi_L1SeedX;
-            }
-
-            float dR_L1SeedP_AtVtx   = reco::deltaR( ref_L1Mu->etaAtVtx(), ref_L1Mu->phiAtVtx(), global_p.eta(), global_p.phi());
-            float dPhi_L1SeedP_AtVtx = reco::deltaPhi( ref_L1Mu->phiAtVtx(), global_p.phi());
-            float dR_L1SeedX_AtVtx   = reco::deltaR( ref_L1Mu->etaAtVtx(), ref_L1Mu->phiAtVtx(), global_x.eta(), global_x.phi());
-            float dPhi_L1SeedX_AtVtx = reco::deltaPhi( ref_L1Mu->phiAtVtx(), global_x.phi());
-
-            if( dR_L1SeedP_AtVtx < dR_minDRL1SeedP_AtVtx ) {
-              dR_minDRL1SeedP_AtVtx = dR_L1SeedP_AtVtx;
-              dPhi_minDRL1SeedP_AtVtx = dPhi_L1SeedP_AtVtx;
-              L1Muon_pt = ref_L1Mu->pt();
-              L1Muon_eta = ref_L1Mu->etaAtVtx();
-              L1Muon_phi = ref_L1Mu->phiAtVtx();
-            }
-            if( fabs(dPhi_L1SeedX_AtVtx) < fabs(dPhi_minDPhiL1SeedX_AtVtx) ) {
-              dR_minDPhiL1SeedX_AtVtx = dR_L1SeedX_AtVtx;
-              dPhi_minDPhiL1SeedX_AtVtx = dPhi_L1SeedX_AtVtx;
-            }
-          }
-        }
-        ST->fill_L1vars(nL1Muon,
-          dR_minDRL1SeedP,         dPhi_minDRL1SeedP,
-          dR_minDPhiL1SeedX,       dPhi_minDPhiL1SeedX,
-          dR_minDRL1SeedP_AtVtx,   dPhi_minDRL1SeedP_AtVtx,
-          dR_minDPhiL1SeedX_AtVtx, dPhi_minDPhiL1SeedX_AtVtx,
-          L1Muon_pt,               L1Muon_eta,                L1Muon_phi
-        );
+  edm::Handle<reco::RecoChargedCandidateCollection> h_L2Muon;
+  hasL2_ = iEvent.getByToken( t_L2Muon_, h_L2Muon );
+  if( hasL2_ )
+  {
+    for( unsigned int i_L2=0; i_L2<h_L2Muon->size(); i_L2++)
+      SoAL2Muon->fill(h_L2Muon->at(i_L2));
+  }
+}
+
+void MuonHLTSeedNtupleMaker::fill_seedBatch(seedWork* W, const edm::View<TrajectorySeed>& seeds, const TrackerGeometry& tracker)
+{
+  W->SB.clear();
+  for( unsigned i : W->kept )
+  {
+    const PTrajectoryStateOnDet& state = seeds[i].startingState();
+    const auto& surface = W->getGeomDet(tracker, state.detId())->surface();
+    W->SB.fill(
+      surface.toGlobal(state.parameters().momentum()),
+      surface.toGlobal(state.parameters().position())
+    );
+  }
+}
+
+void MuonHLTSeedNtupleMaker::minDRKernel(
+  const std::vector<double>& candEta, const std::vector<double>& candPhi,
+  const std::vector<float>& seedEta, const std::vector<float>& seedPhi,
+  std::vector<float>& buf, matchResult* MR
+) {
+  const unsigned nCand = candEta.size();
+  const unsigned nSeed = seedEta.size();
+  MR->reset(nSeed);
+  buf.resize(nCand);
+
+  const double* eta = candEta.data();
+  const double* phi = candPhi.data();
+  float* dR = buf.data();
+  for( unsigned is=0; is<nSeed; ++is )
+  {
+    const float sEta = seedEta[is];
+    const float sPhi = seedPhi[is];
+
+    // -- flat loop over contiguous arrays, kept separate from the argmin so that it can be vectorized
+    for( unsigned j=0; j<nCand; ++j )
+      dR[j] = reco::deltaR( eta[j], phi[j], sEta, sPhi );
+
+    int best = -1;
+    float minDR = 99999.;
+    for( unsigned j=0; j<nCand; ++j )
+    {
+      if( dR[j] < minDR ) {
+        minDR = dR[j];
+        best = j;
       }
+    }
 
-      if( hasL2 && h_L2Muon->size() > 0 ) {
-        int nL2Muon = 0;
-        float dR_minDRL2SeedP = 99999.;
-        float dPhi_minDRL2SeedP = 99999.;
-        float dR_minDPhiL2SeedX = 99999.;
-        float dPhi_minDPhiL2SeedX = 99999.;
-        float L2Muon_pt = 99999.;
-        float L2Muon_eta = 99999.;
-        float L2Muon_phi = 99999.;
-        nL2Muon = h_L2Muon->size();
-        for( unsigned int i_L2=0; i_L2<h_L2Muon->size(); i_L2++)
-        {
-          reco::RecoChargedCandidateRef ref_L2Mu(h_L2Muon, i_L2);
-
-          float dR_L2SeedP   = reco::deltaR( *ref_L2Mu, global_p);
-          float dPhi_L2SeedP = reco::deltaPhi( ref_L2Mu->phi(), global_p.phi());
-          float dR_L2SeedX   = reco::deltaR( *ref_L2Mu, global_x);
-          float dPhi_L2SeedX = reco::deltaPhi( ref_L2Mu->phi(), global_x.phi());
-
-          if( dR_L2SeedP < dR_minDRL2SeedP ) {
-            dR_minDRL2SeedP = dR_L2SeedP;
-            dPhi_minDRL2SeedP = dPhi_L2SeedP;
-            L2Muon_pt = ref_L2Mu->pt();
-            L2Muon_eta = ref_L2Mu->eta();
-            L2Muon_phi = ref_L2Mu->phi();
-          }
-          if( fabs(dPhi_L2SeedX) < fabs(dPhi_minDPhiL2SeedX) ) {
-            dR_minDPhiL2SeedX = dR_L2SeedX;
-            dPhi_minDPhiL2SeedX = dPhi_L2SeedX;
-          }
-        }
+    if( best >= 0 ) {
+      MR->idx[is]  = best;
+      MR->dR[is]   = minDR;
+      MR->dPhi[is] = reco::deltaPhi( phi[best], sPhi );
+    }
+  }
+}
+
+void MuonHLTSeedNtupleMaker::minDPhiKernel(
+  const std::vector<double>& candEta, const std::vector<double>& candPhi,
+  const std::vector<float>& seedEta, const std::vector<float>& seedPhi,
+  std::vector<float>& buf, matchResult* MR
+) {
+  const unsigned nCand = candEta.size();
+  const unsigned nSeed = seedEta.size();
+  MR->reset(nSeed);
+  buf.resize(nCand);
+
+  const double* eta = candEta.data();
+  const double* phi = candPhi.data();
+  float* dPhi = buf.data();
+  for( unsigned is=0; is<nSeed; ++is )
+  {
+    const float sEta = seedEta[is];
+    const float sPhi = seedPhi[is];
+
+    for( unsigned j=0; j<nCand; ++j )
+      dPhi[j] = reco::deltaPhi( phi[j], sPhi );
 
-        ST->fill_L2vars(nL2Muon,
-          dR_minDRL2SeedP,         dPhi_minDRL2SeedP,
-          dR_minDPhiL2SeedX,       dPhi_minDPhiL2SeedX,
-          L2Muon_pt,               L2Muon_eta,                L2Muon_phi
-        );
+    int best = -1;
+    float minDPhi = 99999.;
+    for( unsigned j=0; j<nCand; ++j )
+    {
+      if( fabs(dPhi[j]) < fabs(minDPhi) ) {
+        minDPhi = dPhi[j];
+        best = j;
       }
+    }
 
-      ST->fill_ntuple(NT);
-    } // -- end of seed iteration
-  } // -- if getByToken is valid
+    if( best >= 0 ) {
+      MR->idx[is]  = best;
+      MR->dR[is]   = reco::deltaR( eta[best], phi[best], sEta, sPhi );
+      MR->dPhi[is] = minDPhi;
+    }
+  }
 }
 
-void MuonHLTSeedNtupler::endJob() {
+void MuonHLTSeedNtupleMaker::minDRGenKernel( const candSoA* gen, const seedBatch* seeds, std::vector<double>& buf, matchResult* MR )
+{
+  const unsigned nCand = gen->size();
+  const unsigned nSeed = seeds->size();
+  MR->reset(nSeed);
+  buf.resize(nCand);
+
+  const double* eta = gen->eta.data();
+  const double* phi = gen->phi.data();
+  const double* vx  = gen->vx.data();
+  const double* vy  = gen->vy.data();
+  const double* vz  = gen->vz.data();
+  double* dR = buf.data(); // -- kept in double: the running minimum is a float but each dR is compared unrounded
+  for( unsigned is=0; is<nSeed; ++is )
+  {
+    const GlobalPoint& global_x = seeds->x[is];
+
+    // -- direction from the gen vertex to the seed position
+    for( unsigned j=0; j<nCand; ++j )
+    {
+      GlobalVector vec_seed_vtx( global_x.x() - vx[j], global_x.y() - vy[j], global_x.z() - vz[j] );
+      dR[j] = reco::deltaR( eta[j], phi[j], vec_seed_vtx.eta(), vec_seed_vtx.phi() );
+    }
+
+    int best = -1;
+    float minDR = 99999.;
+    for( unsigned j=0; j<nCand; ++j )
+    {
+      if( dR[j] < minDR ) {
+        minDR = dR[j];
+        best = j;
+      }
+    }
+
+    if( best >= 0 ) {
+      MR->idx[is] = best;
+      MR->dR[is]  = minDR;
+    }
+  }
+}
+
+void MuonHLTSeedNtupleMaker::match_Seeds(seedWork* W) const
+{
+  if( hasGen_ )
+    minDRGenKernel( SoAgenMuon, &W->SB, W->matchBufGen, &W->MRGenSeed );
+
+  if( hasL1_ ) {
+    minDRKernel(   SoAL1Muon->eta,      SoAL1Muon->phi,      W->SB.p_eta, W->SB.p_phi, W->matchBuf, &W->MRL1SeedP );
+    minDPhiKernel( SoAL1Muon->eta,      SoAL1Muon->phi,      W->SB.x_eta, W->SB.x_phi, W->matchBuf, &W->MRL1SeedX );
+    minDRKernel(   SoAL1Muon->etaAtVtx, SoAL1Muon->phiAtVtx, W->SB.p_eta, W->SB.p_phi, W->matchBuf, &W->MRL1SeedPAtVtx );
+    minDPhiKernel( SoAL1Muon->etaAtVtx, SoAL1Muon->phiAtVtx, W->SB.x_eta, W->SB.x_phi, W->matchBuf, &W->MRL1SeedXAtVtx );
+  }
+
+  if( hasL2_ ) {
+    minDRKernel(   SoAL2Muon->eta, SoAL2Muon->phi, W->SB.p_eta, W->SB.p_phi, W->matchBuf, &W->MRL2SeedP );
+    minDPhiKernel( SoAL2Muon->eta, SoAL2Muon->phi, W->SB.x_eta, W->SB.x_phi, W->matchBuf, &W->MRL2SeedX );
+  }
+}
+
+void MuonHLTSeedNtupleMaker::fill_Matches(const seedWork* W, unsigned iSeed, seedTemplate* row) const
+{
+  if( hasGen_ )
+  {
+    int idx = W->MRGenSeed.idx[iSeed];
+    row->fill_Genvars(
+      (idx < 0) ? -99999. : SoAgenMuon->pt[idx],
+      (idx < 0) ? -99999. : SoAgenMuon->eta[idx],
+      (idx < 0) ? -99999. : SoAgenMuon->phi[idx]
+    );
+  }
+
+  if( hasL1_ ) {
+    int idx = W->MRL1SeedPAtVtx.idx[iSeed];
+    row->fill_L1vars(SoAL1Muon->size(),
+      W->MRL1SeedP.dR[iSeed],      W->MRL1SeedP.dPhi[iSeed],
+      W->MRL1SeedX.dR[iSeed],      W->MRL1SeedX.dPhi[iSeed],
+      W->MRL1SeedPAtVtx.dR[iSeed], W->MRL1SeedPAtVtx.dPhi[iSeed],
+      W->MRL1SeedXAtVtx.dR[iSeed], W->MRL1SeedXAtVtx.dPhi[iSeed],
+      (idx < 0) ? 99999. : SoAL1Muon->pt[idx],
+      (idx < 0) ? 99999. : SoAL1Muon->etaAtVtx[idx],
+      (idx < 0) ? 99999. : SoAL1Muon->phiAtVtx[idx]
+    );
+  }
+
+  if( hasL2_ && SoAL2Muon->size() > 0 ) {
+    int idx = W->MRL2SeedP.idx[iSeed];
+    row->fill_L2vars(SoAL2Muon->size(),
+      W->MRL2SeedP.dR[iSeed],      W->MRL2SeedP.dPhi[iSeed],
+      W->MRL2SeedX.dR[iSeed],      W->MRL2SeedX.dPhi[iSeed],
+      (idx < 0) ? 99999. : SoAL2Muon->pt[idx],
+      (idx < 0) ? 99999. : SoAL2Muon->eta[idx],
+      (idx < 0) ? 99999. : SoAL2Muon->phi[idx]
+    );
+  }
+}
+
+void MuonHLTSeedNtupleMaker::endJob() {
+
+  for( auto& coll : seedCollections_ ) {
+    if( coll.exporter )
+      coll.exporter->close();
+
+    // -- seed-track link cross-check against the former std::map<tmpTSOD> lookup
+    if( coll.trkMap->validation() )
+      cout << "[MuonHLTSeedNtupler::endJob] seed-track link " << coll.name << ": "
+           << coll.trkMap->nMismatch() << " / " << coll.trkMap->nChecked() << " lookups differ from the std::map<tmpTSOD> result" << endl;
+  }
+
+  if( maxSeeds_ > 0 ) {
+    cout << "[MuonHLTSeedNtupler::endJob] seed budget: events with more than " << maxSeeds_ << " kept seeds (truncated)" << endl;
+    for( const auto& coll : seedCollections_ )
+      cout << "  " << std::left << std::setw(20) << coll.name << coll.nOverflow << endl;
+  }
 
   //for( int i=0; i<4; ++i ) {
   // for( int i=0; i<1; ++i ) {
@@ -762,6 +965,29 @@ void MuonHLTSeedNtupler::endJob() {
   // }
 
 }
+
+// -- standalone module: the trees go to its own TFileService directory (module label, e.g. seedNtupler/NTEvent)
+MuonHLTSeedNtupler::MuonHLTSeedNtupler(const edm::ParameterSet& iConfig):
+maker_(iConfig, consumesCollector())
+{
+}
+
+void MuonHLTSeedNtupler::analyze(const edm::Event &iEvent, const edm::EventSetup &iSetup)
+{
+  maker_.analyze(iEvent, iSetup);
+}
+
+void MuonHLTSeedNtupler::beginJob()
+{
+  edm::Service<TFileService> fs;
+  maker_.beginJob(*fs);
+}
+
+void MuonHLTSeedNtupler::endJob()
+{
+  maker_.endJob();
+}
+
 // void MuonHLTSeedNtupler::beginRun(const edm::Run &iRun, const edm::EventSetup &iSetup) {}
 // void MuonHLTSeedNtupler::endRun(const edm::Run &iRun, const edm::EventSetup &iSetup) {}
 
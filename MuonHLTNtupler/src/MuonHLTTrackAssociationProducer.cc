@@ -0,0 +1,162 @@
+// -- track to TP association by hits of all HLT muon track collections in one module
+// -- same helper and parameters as MuonAssociatorEDProducer (SimMuon/MCTruth): the association is identical,
+// -- only the hit associators are shared
+
+#include "MuonHLTTool/MuonHLTNtupler/interface/MuonHLTTrackAssociationProducer.h"
+
+#include "SimDataFormats/Associations/interface/TrackToTrackingParticleAssociator.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+
+MuonHLTTrackAssociationProducer::MuonHLTTrackAssociationProducer(const edm::ParameterSet& iConfig):
+hitConf_(iConfig),
+trackerHitAssociatorConfig_(iConfig, consumesCollector()),
+cscHitAssociatorConfig_(iConfig, consumesCollector()),
+rpcHitAssociatorConfig_(iConfig, consumesCollector()),
+gemHitAssociatorConfig_(iConfig, consumesCollector()),
+useMuon_(false),
+tpRefVector_(iConfig.getParameter<bool>("tpRefVector")),
+tTopoToken_(esConsumes<TrackerTopology, TrackerTopologyRcd>()),
+printTiming_(iConfig.getUntrackedParameter<bool>("printTiming", false)),
+nEvent_(0),
+timeIndex_(0.)
+{
+  if( tpRefVector_ )
+    tpRefVectorToken_ = consumes<TrackingParticleRefVector>(iConfig.getParameter<edm::InputTag>("tpTag"));
+  else
+    tpToken_ = consumes<TrackingParticleCollection>(iConfig.getParameter<edm::InputTag>("tpTag"));
+
+  // -- each collection: the common parameters, overridden by the ones given in its PSet
+  for( const auto& collConf : iConfig.getParameter<std::vector<edm::ParameterSet>>("collections") ) {
+    edm::ParameterSet helperConf(iConfig);
+    for( const auto& name : collConf.getParameterNames() ) {
+      if( name != "label" )
+        helperConf.copyFrom(collConf, name);
+    }
+
+    trackAssociation asso;
+    asso.label         = collConf.getParameter<std::string>("label");
+    asso.token         = consumes<edm::View<reco::Track>>(helperConf.getParameter<edm::InputTag>("tracksTag"));
+    asso.ignoreMissing = helperConf.getParameter<bool>("ignoreMissingTrackCollection");
+    asso.helper        = std::make_unique<MuonAssociatorByHitsHelper>(helperConf);
+    asso.time          = 0.;
+    asso.nTrack        = 0;
+    associations_.push_back(std::move(asso));
+
+    useMuon_ = useMuon_ || helperConf.getParameter<bool>("UseMuon");
+
+    produces<reco::RecoToSimCollection>(associations_.back().label);
+    produces<reco::SimToRecoCollection>(associations_.back().label);
+  }
+
+  // -- same consumes hack as MuonAssociatorByHits
+  if( useMuon_ )
+    DTHitAssociator dttruth(iConfig, consumesCollector());
+}
+
+void MuonHLTTrackAssociationProducer::produce(edm::Event &iEvent, const edm::EventSetup &iSetup)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  edm::RefVector<TrackingParticleCollection> TPRefVector;
+  if( tpRefVector_ ) {
+    TPRefVector = iEvent.get(tpRefVectorToken_);
+  }
+  else {
+    edm::Handle<TrackingParticleCollection> TPCollection;
+    iEvent.getByToken(tpToken_, TPCollection);
+    for( auto i=0U; i<TPCollection->size(); ++i )
+      TPRefVector.push_back(TrackingParticleRef(TPCollection, i));
+  }
+
+  // -- the hit to TP index of the event: built once, read by every collection below
+  const TrackerTopology* tTopo = &iSetup.getData(tTopoToken_);
+  TrackerHitAssociator trackertruth(iEvent, trackerHitAssociatorConfig_);
+
+  std::unique_ptr<CSCHitAssociator> csctruth;
+  std::unique_ptr<DTHitAssociator>  dttruth;
+  std::unique_ptr<RPCHitAssociator> rpctruth;
+  std::unique_ptr<GEMHitAssociator> gemtruth;
+  if( useMuon_ ) {
+    bool printRtS(true);
+    csctruth = std::make_unique<CSCHitAssociator>(iEvent, iSetup, cscHitAssociatorConfig_);
+    dttruth  = std::make_unique<DTHitAssociator>(iEvent, iSetup, hitConf_, printRtS);
+    rpctruth = std::make_unique<RPCHitAssociator>(iEvent, iSetup, rpcHitAssociatorConfig_);
+    gemtruth = std::make_unique<GEMHitAssociator>(iEvent, iSetup, gemHitAssociatorConfig_);
+  }
+
+  const MuonAssociatorByHitsHelper::Resources resources = {
+    tTopo, &trackertruth, csctruth.get(), dttruth.get(), rpctruth.get(), gemtruth.get(), {}
+  };
+
+  auto indexDone = std::chrono::steady_clock::now();
+  timeIndex_ += std::chrono::duration<double>(indexDone - start).count();
+  nEvent_++;
+
+  // -- scoring: the collections one after the other; the hit associators and the helpers are not known to be
+  // -- safe for concurrent use (TrackerHitAssociator, DTHitAssociator keep internal state), so no task per collection
+  for( auto& asso : associations_ ) {
+    auto recSimColl = std::make_unique<reco::RecoToSimCollection>(&iEvent.productGetter());
+    auto simRecColl = std::make_unique<reco::SimToRecoCollection>(&iEvent.productGetter());
+
+    edm::Handle<edm::View<reco::Track>> trackHandle;
+    if( !iEvent.getByToken(asso.token, trackHandle) ) {
+      if( !asso.ignoreMissing )
+        throw cms::Exception("ProductNotFound") << "MuonHLTTrackAssociationProducer: no track collection for " << asso.label;
+      iEvent.put(std::move(recSimColl), asso.label);
+      iEvent.put(std::move(simRecColl), asso.label);
+      continue;
+    }
+
+    auto startColl = std::chrono::steady_clock::now();
+
+    const edm::View<reco::Track>& tracks = *trackHandle;
+    edm::RefToBaseVector<reco::Track> trackRefVector;
+    MuonAssociatorByHitsHelper::TrackHitsCollection trackHits;
+    for( auto j=0U; j<tracks.size(); ++j ) {
+      trackRefVector.push_back(tracks.refAt(j));
+      trackHits.push_back(std::make_pair(tracks[j].recHitsBegin(), tracks[j].recHitsEnd()));
+    }
+
+    // -- same filling as MuonAssociatorByHits::associateRecoToSim / associateSimToReco
+    auto recSimIndices = asso.helper->associateRecoToSimIndices(trackHits, TPRefVector, resources);
+    for( const auto& match : recSimIndices ) {
+      for( const auto& tp : match.second )
+        recSimColl->insert(trackRefVector[match.first], std::make_pair(TPRefVector[tp.idx], tp.quality));
+    }
+    recSimColl->post_insert();
+
+    auto simRecIndices = asso.helper->associateSimToRecoIndices(trackHits, TPRefVector, resources);
+    for( const auto& match : simRecIndices ) {
+      for( const auto& trk : match.second )
+        simRecColl->insert(TPRefVector[match.first], std::make_pair(trackRefVector[trk.idx], trk.quality));
+    }
+    simRecColl->post_insert();
+
+    asso.nTrack += tracks.size();
+    asso.time += std::chrono::duration<double>(std::chrono::steady_clock::now() - startColl).count();
+
+    iEvent.put(std::move(recSimColl), asso.label);
+    iEvent.put(std::move(simRecColl), asso.label);
+  }
+}
+
+void MuonHLTTrackAssociationProducer::endJob()
+{
+  if( !printTiming_ || nEvent_ == 0 )
+    return;
+
+  cout << "[MuonHLTTrackAssociationProducer::endJob] " << nEvent_ << " events, time per event:" << endl;
+  cout << "  " << std::left << std::setw(50) << "hit associators (shared)" << std::fixed << std::setprecision(3) << 1e3*timeIndex_/nEvent_ << " ms" << endl;
+  for( const auto& asso : associations_ ) {
+    cout << "  " << std::left << std::setw(50) << asso.label << std::fixed << std::setprecision(3) << 1e3*asso.time/nEvent_ << " ms"
+         << " (" << std::setprecision(1) << (double)asso.nTrack/nEvent_ << " tracks)" << endl;
+  }
+}
+
+DEFINE_FWK_MODULE(MuonHLTTrackAssociationProducer);
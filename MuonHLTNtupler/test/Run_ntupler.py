@@ -18,8 +18,28 @@ process.load('Configuration.Geometry.GeometryRecoDB_cff')
 
 # -- ntupler -- #
 flag_HLTRerun = False
+flag_MiniAOD  = False # -- MiniAOD input: offline muons and HLT objects only (slimmedMuons, slimmedPatTrigger)
 
-if flag_HLTRerun:
+if flag_MiniAOD:
+  from MuonHLTTool.MuonHLTNtupler.ntupler_cfi import ntuplerBase
+  process.ntupler = ntuplerBase.clone(
+    miniAOD       = cms.untracked.bool(True),
+    offlineMuon   = cms.untracked.InputTag("slimmedMuons"),
+    offlineVertex = cms.untracked.InputTag("offlineSlimmedPrimaryVertices"),
+    beamSpot      = cms.untracked.InputTag("offlineBeamSpot"),
+    L1Muon        = cms.untracked.InputTag("gmtStage2Digis", "Muon", "RECO"),
+    PUSummaryInfo = cms.untracked.InputTag("slimmedAddPileupInfo"),
+    genParticle   = cms.untracked.InputTag("prunedGenParticles"),
+  )
+
+  process.TFileService = cms.Service("TFileService",
+    fileName = cms.string("ntuple.root"),
+    closeFileFast = cms.untracked.bool(False),
+    )
+
+  process.mypath = cms.EndPath(process.ntupler)
+
+elif flag_HLTRerun:
   newProcessName = "MYHLT"
   
   from MuonHLTTool.MuonHLTNtupler.customizerForMuonHLTNtupler import customizerFuncForMuonHLTNtupler
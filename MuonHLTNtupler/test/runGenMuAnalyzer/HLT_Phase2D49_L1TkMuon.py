@@ -198,7 +198,10 @@ process.GenMuAnalyzerTEST = cms.EDAnalyzer("GenMuAnalyzer",
     genParticle_src = cms.InputTag("genParticles"),
     L1TT_src = cms.InputTag("TTTracksFromTrackletEmulation", "Level1TTTracks"),
     L1TkMuon_src = cms.InputTag("L1TkMuons"),
-    pt_min = cms.double(0.0)
+    pt_min = cms.double(0.0),
+    dR = cms.untracked.double(0.3),
+    minGenMuonSorted = cms.untracked.uint32(2), # -- events with fewer gen muons: loop over all L1TT tracks instead of the eta sorted index
+    benchmarkBruteForce = cms.untracked.bool(False) # -- True: time and matches of the former loop over all L1TT tracks, printed at the end
 )
 
 process.mypath = cms.Path( process.GenMuAnalyzerTEST )
@@ -0,0 +1,99 @@
+# -- throughput of MuonHLTNtupler + MuonHLTSeedNtupler in one job: two-module setup (own paths) vs merged (mergeWithNtupler = True)
+# -- merged: one module, the ntupler fills the seed trees too (ntupler/seedNtupler/, compared to seedNtupler/ of the two-module setup)
+# -- usage: python compareNtuplerThroughput.py hlt_muon_mc_Run3.py [nEvents] [nThreads] [nRepeat]
+# -- the menu is the one with after_menu_mc.sh appended (README), run on the same local sample for both setups
+import re, sys, subprocess
+
+def makeConfig(menu, tag, merged, nEvents, nThreads):
+    fin = open(menu, "r")
+    fData = fin.read()
+    fin.close()
+
+    if merged:
+        fData = re.sub(r'customizerFuncForMuonHLTSeedNtupler\(process, "MYHLT", (\w+)\)', r'customizerFuncForMuonHLTSeedNtupler(process, "MYHLT", \1, mergeWithNtupler = True)', fData)
+        fData = re.sub(r'\n\s*process\.myseedpath,?', '', fData)
+
+    fData += '''
+# -- added by compareNtuplerThroughput.py
+process.maxEvents.input = cms.untracked.int32(%d)
+process.options.numberOfThreads = cms.untracked.uint32(%d)
+process.options.numberOfStreams = cms.untracked.uint32(0)
+process.Timing = cms.Service("Timing", summaryOnly = cms.untracked.bool(True))
+process.TFileService.fileName = cms.string("ntuple_%s.root")
+''' % (nEvents, nThreads, tag)
+
+    cfgName = "throughput_%s_cfg.py" % tag
+    fout = open(cfgName, "w")
+    fout.write(fData)
+    fout.close()
+    return cfgName
+
+def runConfig(cfgName, logName):
+    with open(logName, "w") as log:
+        ret = subprocess.call(["cmsRun", cfgName], stdout=log, stderr=subprocess.STDOUT)
+    if ret != 0:
+        raise RuntimeError("cmsRun %s failed (%d), see %s" % (cfgName, ret, logName))
+
+    fin = open(logName, "r")
+    fData = fin.read()
+    fin.close()
+
+    throughput = re.search(r"Event Throughput:\s*([0-9.eE+-]+)", fData)
+    loop       = re.search(r"Total loop:\s*([0-9.eE+-]+)", fData)
+    if throughput is None:
+        raise RuntimeError("%s: no Timing summary" % logName)
+    return float(throughput.group(1)), (float(loop.group(1)) if loop else -1.)
+
+def treeEntries(fileName):
+    try:
+        import ROOT
+    except ImportError:
+        return {}
+
+    f = ROOT.TFile.Open(fileName)
+    entries = {}
+    for dirName in ["ntupler", "seedNtupler"]:
+        d = f.Get(dirName)
+        if not d:
+            continue
+        for key in d.GetListOfKeys():
+            obj = key.ReadObj()
+            if obj.InheritsFrom("TTree"):
+                entries[dirName+"/"+obj.GetName()] = obj.GetEntries()
+        # -- merged: the seed trees are in ntupler/seedNtupler, stored under the two-module names
+        sub = d.Get("seedNtupler") if dirName == "ntupler" else None
+        if sub:
+            for key in sub.GetListOfKeys():
+                obj = key.ReadObj()
+                if obj.InheritsFrom("TTree"):
+                    entries["seedNtupler/"+obj.GetName()] = obj.GetEntries()
+    f.Close()
+    return entries
+
+if __name__ == "__main__":
+    menu     = sys.argv[1]
+    nEvents  = int(sys.argv[2]) if len(sys.argv) > 2 else 1000
+    nThreads = int(sys.argv[3]) if len(sys.argv) > 3 else 4
+    nRepeat  = int(sys.argv[4]) if len(sys.argv) > 4 else 2
+
+    setups = [("twoModule", False), ("merged", True)]
+    results = {}
+    for tag, merged in setups:
+        cfgName = makeConfig(menu, tag, merged, nEvents, nThreads)
+        results[tag] = []
+        # -- the first run also warms up the file cache: the best of nRepeat is kept
+        for i in range(nRepeat):
+            results[tag].append( runConfig(cfgName, "throughput_%s_%d.log" % (tag, i)) )
+
+    print("%d events, %d threads, best of %d" % (nEvents, nThreads, nRepeat))
+    best = {}
+    for tag, merged in setups:
+        best[tag] = max(results[tag])
+        print("  %-10s: %8.3f ev/s  (event loop %.1f s)" % (tag, best[tag][0], best[tag][1]))
+    print("  merged / twoModule: %.3f" % (best["merged"][0] / best["twoModule"][0]))
+
+    # -- same sample, same branches: the trees must have the same number of entries
+    entriesTwo, entriesMerged = treeEntries("ntuple_twoModule.root"), treeEntries("ntuple_merged.root")
+    for name in sorted(entriesTwo):
+        if entriesMerged.get(name) != entriesTwo[name]:
+            print("  WARNING: %s has %s entries (merged) vs %d (twoModule)" % (name, entriesMerged.get(name), entriesTwo[name]))
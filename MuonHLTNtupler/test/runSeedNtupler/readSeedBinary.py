@@ -0,0 +1,40 @@
+# -- reader for the flat binary seed export of MuonHLTSeedNtupler (doBinaryExport = True)
+# -- usage: python readSeedBinary.py seedTraining_hltIter2.bin
+# -- in a training script: data = readSeedBinary("seedTraining_hltIter2.bin"); X = data["tsos_dxdz"], y = data["trueMatched"], ...
+import sys
+import numpy as np
+
+# -- the files are little-endian (the ntupler refuses to write them on a big-endian host): every dtype below is "<",
+# -- so the reading host's byte order does not matter
+def readSeedBinary(fileName):
+    with open(fileName, "rb") as f:
+        magic = f.read(8)
+        if magic != b"MHLTSEED":
+            raise ValueError("%s: not a seed export file" % fileName)
+
+        version, nColumns = np.fromfile(f, dtype="<u4", count=2)
+        if version != 1:
+            raise ValueError("%s: unknown version %d (byte-swapped file?)" % (fileName, version))
+        nRecords = int(np.fromfile(f, dtype="<u8", count=1)[0])
+        recordSize = int(np.fromfile(f, dtype="<u4", count=1)[0])
+
+        fields = []
+        for i in range(nColumns):
+            name = f.read(64).rstrip(b"\0").decode()
+            typ  = f.read(4).rstrip(b"\0").decode()
+            fields.append( (name, "<"+typ) )
+        offset = f.tell()
+
+    dtype = np.dtype(fields)
+    if dtype.itemsize != recordSize:
+        raise ValueError("%s: record size mismatch (%d vs %d)" % (fileName, dtype.itemsize, recordSize))
+
+    # -- one mmap, no copy
+    return np.memmap(fileName, dtype=dtype, mode="r", offset=offset, shape=(nRecords,))
+
+if __name__ == "__main__":
+    for fileName in sys.argv[1:]:
+        data = readSeedBinary(fileName)
+        print("%s: %d seeds, %d columns" % (fileName, len(data), len(data.dtype.names)))
+        if len(data) > 0:
+            print("  matched fraction: %.4f, sum of weights: %.1f" % (data["trueMatched"].mean(), data["weight"].sum()))
@@ -118,6 +118,17 @@ Bool_t dRMatching_MYHLTObj( TLorentzVector vecP_ref, MuonHLT::NtupleHandle* ntup
   return MuonHLT::dRMatching( vecP_ref, vec_vecP_HLTObj, minDR );
 }
 
+// -- same question answered from the matches precomputed by the ntupler (doMuonMatch): no loop over the online objects
+// -- the cone and pt threshold are the ones of the ntupler configuration; maxDR > 0 tightens the cone
+// -- call ntuple->TurnOnBranches_MuonMatch(name) once before the event loop
+Bool_t dRMatching_Precomputed( const MuonHLT::Muon& mu, MuonHLT::NtupleHandle* ntuple, TString name, Double_t maxDR = -1 )
+{
+  Int_t idx = ntuple->MuonMatchIndex(name, mu.index);
+  if( idx < 0 ) return kFALSE;
+
+  return maxDR < 0 || ntuple->MuonMatchDR(name, mu.index) < maxDR;
+}
+
 static inline void loadBar(int x, int n, int r, int w)
 {
     // Only update r times.
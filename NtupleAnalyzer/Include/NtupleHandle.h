@@ -5,6 +5,8 @@
 #include <TTreeCache.h>
 #include <TChain.h>
 #include <vector>
+#include <map>
+#include <memory>
 
 namespace MuonHLT
 {
@@ -33,6 +35,7 @@ public:
   Double_t        offlineBunchLumi;
   Int_t           truePU;
   Double_t        genEventWeight;
+  UInt_t          budgetOverflow; // -- eventBudget of the ntupler, bits: budgetBit in MuonHLTNtupler.h
 
   // -- generator inforomation
   Int_t           nGenParticle;
@@ -93,6 +96,8 @@ public:
   Int_t           muon_isLoose[ArrSize];
   Int_t           muon_isHighPt[ArrSize];
   Int_t           muon_isSoft[ArrSize];
+  UInt_t          muon_selectorBits[ArrSize]; // -- doMuonSelectorBits in the ntupler, layout: MuonHLT::MuonSelectorBit
+  Bool_t          hasMuonSelectorBits;        // -- set by TurnOnBranches_MuonSelectorBits if the branch exists
   Double_t        muon_iso03_sumPt[ArrSize];
   Double_t        muon_iso03_hadEt[ArrSize];
   Double_t        muon_iso03_emEt[ArrSize];
@@ -219,6 +224,15 @@ public:
   Int_t           iterL3MuonNoID_isSTA[ArrSize];
   Int_t           iterL3MuonNoID_isTRK[ArrSize];
 
+  // -- best match of each offline muon, precomputed by the ntupler (doMuonMatch): muon_<name>_idx, muon_<name>_dR
+  class MuonMatch
+  {
+  public:
+    Int_t    idx[ArrSize];
+    Double_t dR[ArrSize];
+  };
+  std::map<TString, std::unique_ptr<MuonMatch>> map_muonMatch;
+
 
   NtupleHandle()
   {
@@ -233,6 +247,8 @@ public:
     vec_myHLTObj_pt = 0;
     vec_myHLTObj_eta = 0;
     vec_myHLTObj_phi = 0;
+
+    hasMuonSelectorBits = kFALSE;
   }
 
   NtupleHandle(TChain* chain): NtupleHandle()
@@ -787,6 +803,69 @@ public:
     chain_->SetBranchStatus("iterL3MuonNoID_isTRK", 1);
     chain_->SetBranchAddress("iterL3MuonNoID_isTRK", &iterL3MuonNoID_isTRK);    
   }
+
+  // -- ntuples made with an eventBudget: events with truncated or skipped sections have budgetOverflow != 0
+  void TurnOnBranches_BudgetOverflow()
+  {
+    chain_->SetBranchStatus("budgetOverflow", 1);
+    chain_->SetBranchAddress("budgetOverflow", &budgetOverflow);
+  }
+
+  // -- one branch instead of the muon_is* and isolation branches
+  // -- ntuples made without doMuonSelectorBits: nothing turned on, Muon::selectorBits stays 0
+  void TurnOnBranches_MuonSelectorBits()
+  {
+    hasMuonSelectorBits = chain_->GetBranch("muon_selectorBits") != nullptr;
+    if( !hasMuonSelectorBits )
+    {
+      printf("[NtupleHandle::TurnOnBranches_MuonSelectorBits] no muon_selectorBits branch (ntupler run without doMuonSelectorBits)\n");
+      return;
+    }
+
+    chain_->SetBranchStatus("muon_selectorBits", 1);
+    chain_->SetBranchAddress("muon_selectorBits", &muon_selectorBits);
+  }
+
+  // -- name: as in the muonMatch PSet of the ntupler (e.g. L1Muon, iterL3Muon, or the name given to an HLT filter)
+  void TurnOnBranches_MuonMatch(TString name)
+  {
+    if( map_muonMatch.count(name) ) return;
+
+    MuonMatch* match = new MuonMatch();
+    map_muonMatch[name].reset( match );
+
+    chain_->SetBranchStatus("muon_"+name+"_idx", 1);
+    chain_->SetBranchAddress("muon_"+name+"_idx", &match->idx);
+
+    chain_->SetBranchStatus("muon_"+name+"_dR", 1);
+    chain_->SetBranchAddress("muon_"+name+"_dR", &match->dR);
+  }
+
+  // -- -1: no object in the cone used by the ntupler
+  Int_t MuonMatchIndex(TString name, Int_t i_muon)
+  {
+    auto it = map_muonMatch.find(name);
+    if( it == map_muonMatch.end() )
+    {
+      printf("[NtupleHandle::MuonMatchIndex] call TurnOnBranches_MuonMatch(\"%s\") first\n", name.Data());
+      return -1;
+    }
+
+    return it->second->idx[i_muon];
+  }
+
+  // -- -99999: no object in the cone (MuonMatchIndex -1), or the branches are not turned on
+  Double_t MuonMatchDR(TString name, Int_t i_muon)
+  {
+    auto it = map_muonMatch.find(name);
+    if( it == map_muonMatch.end() )
+    {
+      printf("[NtupleHandle::MuonMatchDR] call TurnOnBranches_MuonMatch(\"%s\") first\n", name.Data());
+      return -99999;
+    }
+
+    return it->second->dR[i_muon];
+  }
 };
 
 };
\ No newline at end of file
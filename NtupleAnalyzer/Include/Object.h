@@ -3,6 +3,8 @@
 
 //customized header files
 #include <Include/NtupleHandle.h>
+// -- MuonHLT::MuonSelectorBit, the layout written by the ntupler
+#include "../../MuonHLTNtupler/interface/MuonSelectorBits.h"
 
 namespace MuonHLT
 {
@@ -183,6 +185,9 @@ public:
   Double_t relPFIso_dBeta;
   Double_t relTrkIso;
 
+  Int_t index; // -- in the offline muon arrays of the ntuple
+  UInt_t selectorBits; // -- 0 unless ntuple->TurnOnBranches_MuonSelectorBits() found the branch
+
   Muon()
   {
     Init();
@@ -193,8 +198,17 @@ public:
     FillVariable(ntuple, index);
   }
 
+  // -- e.g. mu.Passed(MuonHLT::kTight) && mu.Passed(MuonHLT::kPFIsoTight)
+  Bool_t Passed(MuonSelectorBit bit) const { return (selectorBits >> bit) & 1u; }
+
+  // -- all bits of the mask set
+  Bool_t PassedAll(UInt_t mask) const { return (selectorBits & mask) == mask; }
+
   void FillVariable(NtupleHandle* ntuple, Int_t index)
   {
+    this->index = index;
+    selectorBits = ntuple->hasMuonSelectorBits ? ntuple->muon_selectorBits[index] : 0;
+
     pt     = ntuple->muon_pt[index];
     eta    = ntuple->muon_eta[index];
     phi    = ntuple->muon_phi[index];
@@ -318,6 +332,8 @@ private:
 
     relPFIso_dBeta = -999;
     relTrkIso = -999;
+    index = -1;
+    selectorBits = 0;
   }
 };
 
@@ -0,0 +1,40 @@
+// -- Example on how to re-evaluate the seed MVA of existing seed ntuples with a new training, without rerunning cmsRun
+// -- command (from NtupleAnalyzer, after source setup.sh): root -l -b -q SeedMVA/Example/ReevaluateSeedMva.cxx+
+// -- output: friend tree "NThltIter2_mva" with one branch per model, e.g.
+// --   TChain* chain = new TChain("seedNtupler/NThltIter2"); chain->Add("ntuple_*.root");
+// --   chain->AddFriend("NThltIter2_mva", "ROOTFile_SeedMva_hltIter2.root");
+// --   chain->Draw("mva_v3:mva");
+
+#include <TSystem.h>
+#include <SeedMVA/SeedMvaTool.h>
+
+void ReevaluateSeedMva()
+{
+  // -- same XMLs (RecoMuon/TrackerSeedGenerator/data, see $CMSSW_SEARCH_PATH) and scales (MuonHLTForRun3/mvaScale.py) as in customizerForMuonHLTSeedNtupler.py: adjust the paths
+  TString dataPath  = TString(gSystem->Getenv("CMSSW_BASE")) + "/src/RecoMuon/TrackerSeedGenerator/data/";
+  TString scalePath = TString(gSystem->Getenv("CMSSW_BASE")) + "/src/HLTrigger/Configuration/python/MuonHLTForRun3/mvaScale.py";
+
+  TString barrel = "xgb_Run3_Iter0_PatatrackSeeds_barrel_v3";
+  TString endcap = "xgb_Run3_Iter0_PatatrackSeeds_endcap_v3";
+  MuonHLT::SeedMvaModel* model = new MuonHLT::SeedMvaModel(
+    "v3",
+    dataPath+barrel+".xml",
+    dataPath+endcap+".xml",
+    MuonHLT::ReadSeedMvaScale(scalePath, barrel+"_ScaleMean"),
+    MuonHLT::ReadSeedMvaScale(scalePath, barrel+"_ScaleStd"),
+    MuonHLT::ReadSeedMvaScale(scalePath, endcap+"_ScaleMean"),
+    MuonHLT::ReadSeedMvaScale(scalePath, endcap+"_ScaleStd"),
+    kFALSE // -- isFromL1: kTRUE for the hltIter*FromL1 trees
+  );
+
+  MuonHLT::SeedMvaReevaluator* reevaluator = new MuonHLT::SeedMvaReevaluator();
+  reevaluator->AddNtuplePath("ntuple_*.root");
+  reevaluator->Set_TreeName("seedNtupler/NThltIter2");
+  reevaluator->Set_OutputFileName("ROOTFile_SeedMva_hltIter2.root");
+  reevaluator->AddModel( model ); // -- more models can be added: one branch each, evaluated in the same pass
+  reevaluator->Set_ClosureModel("v3"); // -- same training as the ntupler: mva_v3 has to reproduce the stored mva
+  reevaluator->Set_nThread(8);
+  // reevaluator->Set_Columnar(kTRUE); // -- seed ntuples made with doColumnar = True: friend of seedNtupler/NTEvent
+
+  reevaluator->Produce();
+}
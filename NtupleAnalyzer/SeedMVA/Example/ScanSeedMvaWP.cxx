@@ -0,0 +1,24 @@
+// -- Example on how to get the seed MVA ROC curves and working points of all iterations in one pass over the seed ntuples
+// -- command (from NtupleAnalyzer, after source setup.sh): root -l -b -q SeedMVA/Example/ScanSeedMvaWP.cxx+
+// -- output: one directory per iteration with, per (|eta| bin, pT bin): h_sig_*, h_bkg_*, h_effSig_*, h_effBkg_*, h_bkgPerEvt_*, g_ROC_* and the WP_* table
+
+#include <SeedMVA/SeedMvaROCTool.h>
+
+void ScanSeedMvaWP()
+{
+  MuonHLT::SeedMvaROCScanner* scanner = new MuonHLT::SeedMvaROCScanner();
+  scanner->AddNtuplePath("ntuple_*.root");
+  scanner->AddIteration("NThltIter2");
+  scanner->AddIteration("NThltIter2FromL1");
+  scanner->Set_OutputFileName("ROOTFile_SeedMvaROC.root");
+
+  scanner->Set_EtaBinEdges( {0., 1.2, 2.4} ); // -- barrel / endcap, as the two MVAs
+  scanner->Set_PtBinEdges( {0., 5., 10., 20., 1e9} );
+  scanner->Set_MvaRange(0., 1., 10000); // -- scores outside the range are put in the first / last bin
+  scanner->Set_TargetBkgEff( {0.5, 0.2, 0.1, 0.05, 0.02, 0.01} );
+  // scanner->Set_PURange(40, 60);
+  scanner->Set_nThread(2); // -- one task per iteration
+  // scanner->Set_Columnar(kTRUE); // -- seed ntuples made with doColumnar = True
+
+  scanner->Produce();
+}
@@ -0,0 +1,373 @@
+#pragma once
+
+#include <TChain.h>
+#include <TTree.h>
+#include <TFile.h>
+#include <TH1D.h>
+#include <TGraph.h>
+#include <TString.h>
+#include <TStopwatch.h>
+#include <ROOT/TThreadExecutor.hxx>
+
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include <iostream>
+
+namespace MuonHLT
+{
+using std::vector;
+using std::cout;
+using std::endl;
+
+// -- fine-binned score histograms of one seed iteration, for signal and background, per (|eta| bin, pT bin)
+// -- the last |eta| and pT bins are inclusive
+class SeedMvaScoreHist
+{
+public:
+  Int_t nEta_;
+  Int_t nPt_;
+  Int_t nBin_;
+  Double_t mvaMin_;
+  Double_t mvaMax_;
+  vector<Double_t> sig_;
+  vector<Double_t> bkg_;
+
+  SeedMvaScoreHist(Int_t nEta, Int_t nPt, Int_t nBin, Double_t mvaMin, Double_t mvaMax):
+  nEta_(nEta+1), nPt_(nPt+1), nBin_(nBin), mvaMin_(mvaMin), mvaMax_(mvaMax)
+  {
+    sig_.assign( nEta_*nPt_*nBin_, 0. );
+    bkg_.assign( nEta_*nPt_*nBin_, 0. );
+  }
+
+  // -- scores outside the range go to the first / last bin
+  Int_t ScoreBin(Double_t mva) const
+  {
+    Int_t bin = (Int_t)std::floor( (mva - mvaMin_) / (mvaMax_ - mvaMin_) * nBin_ );
+    return std::min( std::max(bin, 0), nBin_-1 );
+  }
+
+  Double_t BinLowEdge(Int_t bin) const { return mvaMin_ + (mvaMax_ - mvaMin_) * bin / nBin_; }
+
+  Double_t* Sig(Int_t i_eta, Int_t i_pt) { return &sig_[(i_eta*nPt_ + i_pt)*nBin_]; }
+  Double_t* Bkg(Int_t i_eta, Int_t i_pt) { return &bkg_[(i_eta*nPt_ + i_pt)*nBin_]; }
+
+  void Fill(Int_t i_eta, Int_t i_pt, Double_t mva, Bool_t isSignal, Double_t weight)
+  {
+    Int_t bin = ScoreBin(mva);
+    const Int_t etaAll = nEta_-1;
+    const Int_t ptAll = nPt_-1;
+    Double_t* (SeedMvaScoreHist::*hist)(Int_t, Int_t) = isSignal ? &SeedMvaScoreHist::Sig : &SeedMvaScoreHist::Bkg;
+
+    (this->*hist)(i_eta,  i_pt)[bin]  += weight;
+    (this->*hist)(i_eta,  ptAll)[bin] += weight;
+    (this->*hist)(etaAll, i_pt)[bin]  += weight;
+    (this->*hist)(etaAll, ptAll)[bin] += weight;
+  }
+};
+
+// -- reads each seed tree (seedNtupler/NThlt*) once and produces, per iteration, |eta| bin and pT bin:
+// --   signal / background score histograms, signal and background efficiency vs threshold, ROC curve,
+// --   and a table of the threshold, signal efficiency and background seeds per event at fixed background efficiencies
+// -- signal: trueMatched, the seed of a track matched to a muon TrackingParticle; older ntuples without the branch:
+// -- matchedTPsize > 0 && |bestMatchTP_pdgId| == 13, the same definition
+// -- background per event: over the NTEvent entries in the PU range of the seeds
+// -- "weight" (downsampling of unmatched seeds) is used when it exists; the iterations are processed in parallel
+// -- columnar seed ntuples (doColumnar = True): Set_Columnar(kTRUE), the seeds of iteration NThltIter2 are read
+// -- from the hltIter2_* vector branches of NTEvent
+class SeedMvaROCScanner
+{
+public:
+  SeedMvaROCScanner() {}
+
+  void AddNtuplePath(TString ntuplePath) { vec_ntuplePath_.push_back( ntuplePath ); }
+  void AddIteration(TString treeName) { vec_iteration_.push_back( treeName ); }
+
+  void Set_DirName(TString dirName) { dirName_ = dirName; }
+  void Set_OutputFileName(TString outputFileName) { outputFileName_ = outputFileName; }
+  void Set_EtaBinEdges(vector<Double_t> vec_edge) { vec_etaEdge_ = vec_edge; }
+  void Set_PtBinEdges(vector<Double_t> vec_edge) { vec_ptEdge_ = vec_edge; }
+  void Set_MvaRange(Double_t mvaMin, Double_t mvaMax, Int_t nBin) { mvaMin_ = mvaMin; mvaMax_ = mvaMax; nBin_ = nBin; }
+  void Set_TargetBkgEff(vector<Double_t> vec_target) { vec_targetBkgEff_ = vec_target; }
+  void Set_PURange(Int_t minPU, Int_t maxPU) { minPU_ = minPU; maxPU_ = maxPU; }
+  void Set_nThread(Int_t nThread) { nThread_ = nThread; }
+  void Set_Columnar(Bool_t columnar) { columnar_ = columnar; }
+
+  void Produce()
+  {
+    StartTimer();
+
+    const Int_t nIter = (Int_t)vec_iteration_.size();
+    const Int_t nEta = (Int_t)vec_etaEdge_.size()-1;
+    const Int_t nPt = (Int_t)vec_ptEdge_.size()-1;
+
+    // -- number of events in the PU range, for the background rate
+    TChain* chainEvent = new TChain(dirName_+"/NTEvent");
+    for(const auto& ntuplePath : vec_ntuplePath_ )
+      chainEvent->Add( ntuplePath );
+    Int_t truePU = 0;
+    chainEvent->SetBranchStatus("*", 0);
+    chainEvent->SetBranchStatus("truePU", 1); chainEvent->SetBranchAddress("truePU", &truePU);
+    nEvent_ = 0;
+    Long64_t nEntryEvent = chainEvent->GetEntries();
+    for(Long64_t i=0; i<nEntryEvent; i++)
+    {
+      chainEvent->GetEntry(i);
+      if( truePU < minPU_ || truePU > maxPU_ ) continue;
+      nEvent_++;
+    }
+    delete chainEvent;
+
+    vector<SeedMvaScoreHist> vec_hist(nIter, SeedMvaScoreHist(nEta, nPt, nBin_, mvaMin_, mvaMax_));
+
+    // -- one pass per iteration, iterations in parallel: each task owns its chain and histograms
+    ROOT::EnableThreadSafety();
+    ROOT::TThreadExecutor pool(nThread_);
+    pool.Foreach( [&](Int_t i_iter) { FillScoreHist(vec_iteration_[i_iter], &vec_hist[i_iter]); }, ROOT::TSeqI(nIter) );
+
+    TFile *f_output = TFile::Open(outputFileName_, "RECREATE");
+    for(Int_t i_iter=0; i_iter<nIter; i_iter++)
+    {
+      f_output->mkdir(vec_iteration_[i_iter])->cd();
+      for(Int_t i_eta=0; i_eta<=nEta; i_eta++)
+      {
+        for(Int_t i_pt=0; i_pt<=nPt; i_pt++)
+          Save(vec_iteration_[i_iter], &vec_hist[i_iter], i_eta, i_pt);
+      }
+    }
+    f_output->Close();
+
+    PrintRunTime();
+  }
+
+private:
+  TStopwatch timer_;
+
+  vector<TString> vec_ntuplePath_;
+  vector<TString> vec_iteration_;
+  TString dirName_ = "seedNtupler";
+  TString outputFileName_ = "ROOTFile_SeedMvaROC.root";
+  vector<Double_t> vec_etaEdge_ = {0., 1.2, 2.4};
+  vector<Double_t> vec_ptEdge_ = {0., 5., 10., 20., 1e9};
+  Double_t mvaMin_ = 0.;
+  Double_t mvaMax_ = 1.;
+  Int_t nBin_ = 10000;
+  vector<Double_t> vec_targetBkgEff_ = {0.5, 0.2, 0.1, 0.05, 0.02, 0.01};
+  Int_t minPU_ = -1;
+  Int_t maxPU_ = 99999;
+  Int_t nThread_ = 4;
+  Bool_t columnar_ = kFALSE;
+  Long64_t nEvent_ = 0;
+
+  static Int_t FindBin(const vector<Double_t>& vec_edge, Double_t value)
+  {
+    if( value < vec_edge.front() || value >= vec_edge.back() ) return -1;
+    return (Int_t)(std::upper_bound(vec_edge.begin(), vec_edge.end(), value) - vec_edge.begin()) - 1;
+  }
+
+  void FillScoreHist(TString treeName, SeedMvaScoreHist* hist) const
+  {
+    if( columnar_ )
+    {
+      FillScoreHistColumnar(treeName, hist);
+      return;
+    }
+
+    TChain* chain = new TChain(dirName_+"/"+treeName);
+    for(const auto& ntuplePath : vec_ntuplePath_ )
+      chain->Add( ntuplePath );
+
+    Float_t mva = 0, tsos_eta = 0, tsos_pt = 0, weight = 1.;
+    Int_t truePU = 0, trueMatched = 0, matchedTPsize = 0, bestMatchTP_pdgId = 0;
+
+    chain->SetBranchStatus("*", 0);
+    chain->SetBranchStatus("mva", 1);               chain->SetBranchAddress("mva", &mva);
+    chain->SetBranchStatus("tsos_eta", 1);          chain->SetBranchAddress("tsos_eta", &tsos_eta);
+    chain->SetBranchStatus("tsos_pt", 1);           chain->SetBranchAddress("tsos_pt", &tsos_pt);
+    chain->SetBranchStatus("truePU", 1);            chain->SetBranchAddress("truePU", &truePU);
+    Bool_t hasTrueMatched = chain->GetBranch("trueMatched") != nullptr;
+    if( hasTrueMatched ) { chain->SetBranchStatus("trueMatched", 1); chain->SetBranchAddress("trueMatched", &trueMatched); }
+    else
+    {
+      chain->SetBranchStatus("matchedTPsize", 1);     chain->SetBranchAddress("matchedTPsize", &matchedTPsize);
+      chain->SetBranchStatus("bestMatchTP_pdgId", 1); chain->SetBranchAddress("bestMatchTP_pdgId", &bestMatchTP_pdgId);
+    }
+    Bool_t hasWeight = chain->GetBranch("weight") != nullptr;
+    if( hasWeight ) { chain->SetBranchStatus("weight", 1); chain->SetBranchAddress("weight", &weight); }
+
+    Long64_t nEntry = chain->GetEntries();
+    printf("[SeedMvaROCScanner] %s: %lld seeds (weight branch: %d)\n", treeName.Data(), nEntry, hasWeight);
+
+    for(Long64_t i=0; i<nEntry; i++)
+    {
+      chain->GetEntry(i);
+
+      if( truePU < minPU_ || truePU > maxPU_ ) continue;
+
+      Int_t i_eta = FindBin(vec_etaEdge_, fabs(tsos_eta));
+      Int_t i_pt = FindBin(vec_ptEdge_, tsos_pt);
+      if( i_eta < 0 || i_pt < 0 ) continue;
+
+      Bool_t isSignal = hasTrueMatched ? (trueMatched != 0) : (matchedTPsize > 0 && std::abs(bestMatchTP_pdgId) == 13);
+      hist->Fill(i_eta, i_pt, mva, isSignal, weight);
+    }
+
+    delete chain;
+  }
+
+  // -- same selection as FillScoreHist, one NTEvent entry per event with one vector element per seed
+  void FillScoreHistColumnar(TString treeName, SeedMvaScoreHist* hist) const
+  {
+    TString prefix = TString(treeName(2, treeName.Length())) + "_"; // -- NThltIter2 -> hltIter2_
+
+    TChain* chain = new TChain(dirName_+"/NTEvent");
+    for(const auto& ntuplePath : vec_ntuplePath_ )
+      chain->Add( ntuplePath );
+
+    vector<Float_t> *mva = nullptr, *tsos_eta = nullptr, *tsos_pt = nullptr, *weight = nullptr;
+    vector<Int_t> *trueMatched = nullptr, *matchedTPsize = nullptr, *bestMatchTP_pdgId = nullptr;
+    Int_t truePU = 0;
+
+    chain->SetBranchStatus("*", 0);
+    chain->SetBranchStatus("truePU", 1);                  chain->SetBranchAddress("truePU", &truePU);
+    chain->SetBranchStatus(prefix+"mva", 1);              chain->SetBranchAddress(prefix+"mva", &mva);
+    chain->SetBranchStatus(prefix+"tsos_eta", 1);         chain->SetBranchAddress(prefix+"tsos_eta", &tsos_eta);
+    chain->SetBranchStatus(prefix+"tsos_pt", 1);          chain->SetBranchAddress(prefix+"tsos_pt", &tsos_pt);
+    Bool_t hasTrueMatched = chain->GetBranch(prefix+"trueMatched") != nullptr;
+    if( hasTrueMatched ) { chain->SetBranchStatus(prefix+"trueMatched", 1); chain->SetBranchAddress(prefix+"trueMatched", &trueMatched); }
+    else
+    {
+      chain->SetBranchStatus(prefix+"matchedTPsize", 1);     chain->SetBranchAddress(prefix+"matchedTPsize", &matchedTPsize);
+      chain->SetBranchStatus(prefix+"bestMatchTP_pdgId", 1); chain->SetBranchAddress(prefix+"bestMatchTP_pdgId", &bestMatchTP_pdgId);
+    }
+    Bool_t hasWeight = chain->GetBranch(prefix+"weight") != nullptr;
+    if( hasWeight ) { chain->SetBranchStatus(prefix+"weight", 1); chain->SetBranchAddress(prefix+"weight", &weight); }
+
+    Long64_t nEntry = chain->GetEntries();
+    printf("[SeedMvaROCScanner] %s (columnar): %lld events (weight branch: %d)\n", treeName.Data(), nEntry, hasWeight);
+
+    for(Long64_t i=0; i<nEntry; i++)
+    {
+      chain->GetEntry(i);
+
+      if( truePU < minPU_ || truePU > maxPU_ ) continue;
+
+      for(size_t i_seed=0; i_seed<mva->size(); i_seed++)
+      {
+        Int_t i_eta = FindBin(vec_etaEdge_, fabs(tsos_eta->at(i_seed)));
+        Int_t i_pt = FindBin(vec_ptEdge_, tsos_pt->at(i_seed));
+        if( i_eta < 0 || i_pt < 0 ) continue;
+
+        Bool_t isSignal = hasTrueMatched ? (trueMatched->at(i_seed) != 0) :
+                                           (matchedTPsize->at(i_seed) > 0 && std::abs(bestMatchTP_pdgId->at(i_seed)) == 13);
+        hist->Fill(i_eta, i_pt, mva->at(i_seed), isSignal, hasWeight ? weight->at(i_seed) : 1.);
+      }
+    }
+
+    delete chain;
+  }
+
+  TString BinName(Int_t i_eta, Int_t i_pt) const
+  {
+    const Int_t nEta = (Int_t)vec_etaEdge_.size()-1;
+    const Int_t nPt = (Int_t)vec_ptEdge_.size()-1;
+    TString etaName = (i_eta == nEta) ? TString("etaAll") : TString::Format("eta%d", i_eta);
+    TString ptName = (i_pt == nPt) ? TString("ptAll") : TString::Format("pt%d", i_pt);
+    return etaName + "_" + ptName;
+  }
+
+  void Save(TString iteration, SeedMvaScoreHist* hist, Int_t i_eta, Int_t i_pt) const
+  {
+    const Int_t nBin = hist->nBin_;
+    const Double_t* sig = hist->Sig(i_eta, i_pt);
+    const Double_t* bkg = hist->Bkg(i_eta, i_pt);
+    TString binName = BinName(i_eta, i_pt);
+
+    TH1D* h_sig       = new TH1D("h_sig_"+binName,       "", nBin, hist->mvaMin_, hist->mvaMax_);
+    TH1D* h_bkg       = new TH1D("h_bkg_"+binName,       "", nBin, hist->mvaMin_, hist->mvaMax_);
+    TH1D* h_effSig    = new TH1D("h_effSig_"+binName,    "", nBin, hist->mvaMin_, hist->mvaMax_);
+    TH1D* h_effBkg    = new TH1D("h_effBkg_"+binName,    "", nBin, hist->mvaMin_, hist->mvaMax_);
+    TH1D* h_bkgPerEvt = new TH1D("h_bkgPerEvt_"+binName, "", nBin, hist->mvaMin_, hist->mvaMax_);
+    TGraph* g_ROC     = new TGraph(nBin);
+    g_ROC->SetName("g_ROC_"+binName);
+    g_ROC->SetTitle(";signal efficiency;background efficiency");
+
+    // -- efficiency of "mva >= low edge of the bin": cumulative sums from the highest score
+    vector<Double_t> vec_cumSig(nBin+1, 0.), vec_cumBkg(nBin+1, 0.);
+    for(Int_t i=nBin-1; i>=0; i--)
+    {
+      vec_cumSig[i] = vec_cumSig[i+1] + sig[i];
+      vec_cumBkg[i] = vec_cumBkg[i+1] + bkg[i];
+    }
+    const Double_t totSig = vec_cumSig[0];
+    const Double_t totBkg = vec_cumBkg[0];
+
+    for(Int_t i=0; i<nBin; i++)
+    {
+      Double_t effSig = totSig > 0 ? vec_cumSig[i] / totSig : 0.;
+      Double_t effBkg = totBkg > 0 ? vec_cumBkg[i] / totBkg : 0.;
+
+      h_sig->SetBinContent(i+1, sig[i]);
+      h_bkg->SetBinContent(i+1, bkg[i]);
+      h_effSig->SetBinContent(i+1, effSig);
+      h_effBkg->SetBinContent(i+1, effBkg);
+      h_bkgPerEvt->SetBinContent(i+1, nEvent_ > 0 ? vec_cumBkg[i] / nEvent_ : 0.);
+      g_ROC->SetPoint(i, effSig, effBkg);
+    }
+
+    // -- working points: loosest threshold with background efficiency <= target
+    TTree* wpTree = new TTree("WP_"+binName, "WP_"+binName);
+    Double_t target, cut, effSig, effBkg, bkgPerEvt;
+    wpTree->Branch("targetBkgEff", &target,    "targetBkgEff/D");
+    wpTree->Branch("cut",          &cut,       "cut/D");
+    wpTree->Branch("effSig",       &effSig,    "effSig/D");
+    wpTree->Branch("effBkg",       &effBkg,    "effBkg/D");
+    wpTree->Branch("bkgPerEvt",    &bkgPerEvt, "bkgPerEvt/D");
+
+    printf("[%s, %s] signal: %.1f, background: %.1f (%lld events)\n", iteration.Data(), binName.Data(), totSig, totBkg, nEvent_);
+    printf("  %12s %12s %12s %12s %12s\n", "target", "cut", "effSig", "effBkg", "bkg/event");
+    for(const auto& targetBkgEff : vec_targetBkgEff_ )
+    {
+      Int_t i = 0;
+      while( i < nBin && totBkg > 0 && vec_cumBkg[i] / totBkg > targetBkgEff ) i++;
+
+      target    = targetBkgEff;
+      cut       = hist->BinLowEdge(i);
+      effSig    = totSig > 0 ? vec_cumSig[i] / totSig : 0.;
+      effBkg    = totBkg > 0 ? vec_cumBkg[i] / totBkg : 0.;
+      bkgPerEvt = nEvent_ > 0 ? vec_cumBkg[i] / nEvent_ : 0.;
+      wpTree->Fill();
+
+      printf("  %12.4f %12.5f %12.4f %12.4f %12.3f\n", target, cut, effSig, effBkg, bkgPerEvt);
+    }
+
+    h_sig->Write();
+    h_bkg->Write();
+    h_effSig->Write();
+    h_effBkg->Write();
+    h_bkgPerEvt->Write();
+    g_ROC->Write();
+    wpTree->Write();
+  }
+
+  void StartTimer()
+  {
+    timer_.Start();
+  }
+
+  void PrintRunTime()
+  {
+    Double_t cpuTime = timer_.CpuTime();
+    Double_t realTime = timer_.RealTime();
+
+    cout << "************************************************" << endl;
+    cout << "Total real time: " << realTime << " (seconds)" << endl;
+    cout << "Total CPU time:  " << cpuTime << " (seconds)" << endl;
+    cout << "  CPU time / real time = " << cpuTime / realTime << endl;
+    cout << "************************************************" << endl;
+  }
+};
+
+} // -- namespace MuonHLT
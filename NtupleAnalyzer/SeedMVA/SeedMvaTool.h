@@ -0,0 +1,553 @@
+#pragma once
+
+#include <TChain.h>
+#include <TTree.h>
+#include <TFile.h>
+#include <TString.h>
+#include <TStopwatch.h>
+#include <TXMLEngine.h>
+#include <ROOT/TThreadExecutor.hxx>
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <limits>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace MuonHLT
+{
+using std::vector;
+using std::cout;
+using std::endl;
+
+// -- GBRForest built directly from the TMVA-style XML read by SeedMvaEstimator (RecoMuon/TrackerSeedGenerator/data/*.xml),
+// -- following CommonTools/MVAUtils/GBRForestTools so that the response is the same without CMSSW:
+// -- flat node arrays with leaves stored as -(response index), "res" as leaf response for gradient boosting,
+// -- "purity" (or "nType" with UseYesNoLeaf) scaled by boostWeight/norm for AdaBoost,
+// -- cut values moved down by one ulp for weights written by ROOT >= 5.34/22 (TMVA splits on >=)
+class SeedGBRForest
+{
+public:
+  SeedGBRForest() {}
+
+  SeedGBRForest(TString xmlPath)
+  {
+    Load(xmlPath);
+  }
+
+  Bool_t Load(TString xmlPath)
+  {
+    vec_tree_.clear();
+
+    TXMLEngine xml;
+    XMLDocPointer_t doc = xml.ParseFile(xmlPath);
+    if( doc == nullptr )
+    {
+      cout << "[SeedGBRForest::Load] cannot parse " << xmlPath << endl;
+      return kFALSE;
+    }
+
+    XMLNodePointer_t methodSetup = xml.DocGetRootElement(doc);
+
+    std::map<std::string, std::string> info;
+    std::map<std::string, std::string> options;
+    XMLNodePointer_t weights = nullptr;
+    for(XMLNodePointer_t node = xml.GetChild(methodSetup); node != nullptr; node = xml.GetNext(node))
+    {
+      TString name = xml.GetNodeName(node);
+      if( name == "GeneralInfo" )
+      {
+        for(XMLNodePointer_t e = xml.GetChild(node); e != nullptr; e = xml.GetNext(e))
+          info[ Attr(xml, e, "name") ] = Attr(xml, e, "value");
+      }
+      else if( name == "Options" )
+      {
+        for(XMLNodePointer_t e = xml.GetChild(node); e != nullptr; e = xml.GetNext(e))
+          options[ Attr(xml, e, "name") ] = xml.GetNodeContent(e) ? xml.GetNodeContent(e) : "";
+      }
+      else if( name == "Variables" )
+        nVar_ = std::atoi( Attr(xml, node, "NVar").c_str() );
+      else if( name == "Weights" )
+        weights = node;
+    }
+
+    if( info["AnalysisType"] == "Regression" || weights == nullptr )
+    {
+      cout << "[SeedGBRForest::Load] " << xmlPath << ": only classification forests are supported" << endl;
+      xml.FreeDoc(doc);
+      return kFALSE;
+    }
+
+    Bool_t isAdaClassifier = options["BoostType"] != "Grad";
+    Bool_t useYesNoLeaf = isAdaClassifier && options["UseYesNoLeaf"] == "True";
+    leafAttr_ = useYesNoLeaf ? "nType" : (isAdaClassifier ? "purity" : "res");
+    adjustBoundary_ = IsNewTMVA( info["ROOT Release"] );
+
+    vector<XMLNodePointer_t> vec_binaryTree;
+    vector<Double_t> vec_boostWeight;
+    for(XMLNodePointer_t node = xml.GetChild(weights); node != nullptr; node = xml.GetNext(node))
+    {
+      if( TString(xml.GetNodeName(node)) != "BinaryTree" ) continue;
+      vec_binaryTree.push_back( node );
+      vec_boostWeight.push_back( std::atof( Attr(xml, node, "boostWeight").c_str() ) );
+    }
+
+    Double_t norm = 0;
+    if( isAdaClassifier )
+      for(const auto& w : vec_boostWeight ) norm += w;
+
+    for(size_t i_tree=0; i_tree<vec_binaryTree.size(); i_tree++)
+    {
+      Double_t scale = isAdaClassifier ? vec_boostWeight[i_tree] / norm : 1.0;
+
+      Tree tree;
+      XMLNodePointer_t root = ChildNode(xml, vec_binaryTree[i_tree]);
+      AddNode(xml, root, scale, tree);
+      vec_tree_.push_back( tree );
+    }
+
+    xml.FreeDoc(doc);
+
+    printf("[SeedGBRForest::Load] %s: %d trees, %d variables (boost: %s, leaf: %s, adjusted boundary: %d)\n",
+      xmlPath.Data(), (Int_t)vec_tree_.size(), nVar_, options["BoostType"].c_str(), leafAttr_.c_str(), adjustBoundary_);
+
+    return kTRUE;
+  }
+
+  Double_t GetResponse(const Float_t* var) const
+  {
+    Double_t response = 0.;
+    for(const auto& tree : vec_tree_ )
+      response += tree.GetResponse(var);
+
+    return response;
+  }
+
+  Int_t NVar() const { return nVar_; }
+  Int_t NTree() const { return (Int_t)vec_tree_.size(); }
+
+private:
+  struct Tree
+  {
+    vector<Int_t> cutIndex;
+    vector<Float_t> cutVal;
+    vector<Int_t> leftIndex;
+    vector<Int_t> rightIndex;
+    vector<Double_t> response;
+
+    Double_t GetResponse(const Float_t* var) const
+    {
+      if( cutIndex.empty() ) return response[0];
+
+      Int_t index = 0;
+      do {
+        index = var[cutIndex[index]] > cutVal[index] ? rightIndex[index] : leftIndex[index];
+      } while( index > 0 );
+
+      return response[-index];
+    }
+  };
+
+  vector<Tree> vec_tree_;
+  Int_t nVar_ = 0;
+  std::string leafAttr_ = "res";
+  Bool_t adjustBoundary_ = kFALSE;
+
+  static std::string Attr(TXMLEngine& xml, XMLNodePointer_t node, const char* name)
+  {
+    const char* value = xml.GetAttr(node, name);
+    return value ? value : "";
+  }
+
+  // -- pos = 'l' or 'r'; 0: first "Node" child (the root node of a BinaryTree has pos = 's')
+  static XMLNodePointer_t ChildNode(TXMLEngine& xml, XMLNodePointer_t node, char pos = 0)
+  {
+    for(XMLNodePointer_t e = xml.GetChild(node); e != nullptr; e = xml.GetNext(e))
+    {
+      if( TString(xml.GetNodeName(e)) != "Node" ) continue;
+      if( pos == 0 || Attr(xml, e, "pos")[0] == pos ) return e;
+    }
+
+    return nullptr;
+  }
+
+  static Bool_t IsTerminal(TXMLEngine& xml, XMLNodePointer_t node)
+  {
+    return ChildNode(xml, node) == nullptr;
+  }
+
+  // -- "6.22/08 [395784]" -> ROOT >= 5.34/22 ?
+  static Bool_t IsNewTMVA(const std::string& rootRelease)
+  {
+    Int_t major = 0, minor = 0, patch = 0;
+    if( sscanf(rootRelease.c_str(), "%d.%d/%d", &major, &minor, &patch) < 2 ) return kFALSE;
+
+    return (major > 5) || (major == 5 && minor > 34) || (major == 5 && minor == 34 && patch >= 22);
+  }
+
+  void AddNode(TXMLEngine& xml, XMLNodePointer_t node, Double_t scale, Tree& tree) const
+  {
+    if( IsTerminal(xml, node) )
+    {
+      tree.response.push_back( std::atof( Attr(xml, node, leafAttr_.c_str()).c_str() ) * scale );
+      return;
+    }
+
+    Int_t thisIndex = (Int_t)tree.cutIndex.size();
+
+    Float_t cutVal = std::strtof( Attr(xml, node, "Cut").c_str(), nullptr );
+    if( adjustBoundary_ )
+      cutVal = std::nextafter(cutVal, std::numeric_limits<Float_t>::lowest());
+
+    tree.cutIndex.push_back( std::atoi( Attr(xml, node, "IVar").c_str() ) );
+    tree.cutVal.push_back( cutVal );
+    tree.leftIndex.push_back( 0 );
+    tree.rightIndex.push_back( 0 );
+
+    XMLNodePointer_t left  = ChildNode(xml, node, 'l');
+    XMLNodePointer_t right = ChildNode(xml, node, 'r');
+    if( std::atoi( Attr(xml, node, "cType").c_str() ) == 0 )
+      std::swap(left, right);
+
+    tree.leftIndex[thisIndex] = IsTerminal(xml, left) ? -(Int_t)tree.response.size() : (Int_t)tree.cutIndex.size();
+    AddNode(xml, left, scale, tree);
+
+    tree.rightIndex[thisIndex] = IsTerminal(xml, right) ? -(Int_t)tree.response.size() : (Int_t)tree.cutIndex.size();
+    AddNode(xml, right, scale, tree);
+  }
+};
+
+// -- input features of the seed trees, in the order of the columns read by SeedMvaReevaluator
+enum SeedMvaFeature
+{
+  kTsosErr0, kTsosErr2, kTsosErr5, kTsosDxdz, kTsosDydz, kTsosQbp,
+  kDRL1SeedP, kDPhiL1SeedP, kDRL2SeedP, kDPhiL2SeedP,
+  kTsosEta,
+  kNSeedMvaFeature
+};
+
+static const char* seedMvaFeatureBranch[kNSeedMvaFeature] =
+{
+  "tsos_err0", "tsos_err2", "tsos_err5", "tsos_dxdz", "tsos_dydz", "tsos_qbp",
+  "dR_minDRL1SeedP_AtVtx", "dPhi_minDRL1SeedP_AtVtx", "dR_minDRL2SeedP", "dPhi_minDRL2SeedP",
+  "tsos_eta"
+};
+
+// -- dR, dPhi to the L1 / L2 muon when there is none: 99999 in SeedMvaEstimator, while the seed ntupler leaves
+// -- its -99999 default in the branches when the collection is empty (e.g. no L2 muon): mapped back before scaling
+static const Float_t seedMvaNoMuon = 99999.;
+static const Float_t seedNtupleDefault = -99999.;
+
+// -- reads "name = [v0, v1, ...]" from a python file such as HLTrigger/Configuration/python/MuonHLTForRun3/mvaScale.py
+inline vector<Double_t> ReadSeedMvaScale(TString pyFile, TString name)
+{
+  vector<Double_t> vec_value;
+
+  std::ifstream input(pyFile.Data());
+  std::string content( (std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>() );
+
+  size_t pos = content.find( std::string(name.Data()) + " " );
+  if( pos == std::string::npos ) pos = content.find( std::string(name.Data()) + "=" );
+  if( pos == std::string::npos )
+  {
+    cout << "[ReadSeedMvaScale] " << name << " is not found in " << pyFile << endl;
+    return vec_value;
+  }
+
+  size_t begin = content.find('[', pos);
+  size_t end = content.find(']', begin);
+  std::stringstream list( content.substr(begin+1, end-begin-1) );
+  std::string item;
+  while( std::getline(list, item, ',') )
+  {
+    if( item.find_first_not_of(" \t\n") == std::string::npos ) continue;
+    vec_value.push_back( std::atof( item.c_str() ) );
+  }
+
+  return vec_value;
+}
+
+// -- one seed MVA training: barrel (|eta| < 1.2) and endcap forests with the mvaScaleMean / mvaScaleStd of the ntupler config
+// -- inputs as in SeedMvaEstimator::computeMva: 3 TSOS errors, dxdz, dydz, qbp, then dR, dPhi to the L1 (isFromL1) or L2 muon
+class SeedMvaModel
+{
+public:
+  TString label_;
+
+  SeedMvaModel(TString label, TString xmlBarrel, TString xmlEndcap,
+               vector<Double_t> scaleMeanBarrel, vector<Double_t> scaleStdBarrel,
+               vector<Double_t> scaleMeanEndcap, vector<Double_t> scaleStdEndcap,
+               Bool_t isFromL1):
+  label_(label),
+  forestBarrel_(xmlBarrel),
+  forestEndcap_(xmlEndcap),
+  scaleMeanBarrel_(scaleMeanBarrel),
+  scaleStdBarrel_(scaleStdBarrel),
+  scaleMeanEndcap_(scaleMeanEndcap),
+  scaleStdEndcap_(scaleStdEndcap),
+  isFromL1_(isFromL1)
+  {
+    // -- a wrong scale or forest would silently give a different response: refuse it
+    if( (Int_t)scaleMeanBarrel_.size() != nVar_ || (Int_t)scaleStdBarrel_.size() != nVar_ ||
+        (Int_t)scaleMeanEndcap_.size() != nVar_ || (Int_t)scaleStdEndcap_.size() != nVar_ )
+      throw std::invalid_argument( TString::Format("[SeedMvaModel] %s: scale vectors must have %d entries (mean, std barrel: %d, %d; endcap: %d, %d)",
+        label_.Data(), nVar_, (Int_t)scaleMeanBarrel_.size(), (Int_t)scaleStdBarrel_.size(), (Int_t)scaleMeanEndcap_.size(), (Int_t)scaleStdEndcap_.size()).Data() );
+
+    if( forestBarrel_.NTree() == 0 || forestBarrel_.NVar() != nVar_ || forestEndcap_.NTree() == 0 || forestEndcap_.NVar() != nVar_ )
+      throw std::invalid_argument( TString::Format("[SeedMvaModel] %s: the forests must have %d variables (barrel: %d, endcap: %d; %d, %d trees)",
+        label_.Data(), nVar_, forestBarrel_.NVar(), forestEndcap_.NVar(), forestBarrel_.NTree(), forestEndcap_.NTree()).Data() );
+  }
+
+  // -- same convention as the "mva" branch of the seed ntupler (response + 0.5)
+  Float_t Evaluate(const Float_t* feature) const
+  {
+    Bool_t isBarrel = fabs( feature[kTsosEta] ) < 1.2;
+    const vector<Double_t>& mean = isBarrel ? scaleMeanBarrel_ : scaleMeanEndcap_;
+    const vector<Double_t>& scaleStd = isBarrel ? scaleStdBarrel_ : scaleStdEndcap_;
+
+    Float_t var[nVar_] = {
+      feature[kTsosErr0], feature[kTsosErr2], feature[kTsosErr5],
+      feature[kTsosDxdz], feature[kTsosDydz], feature[kTsosQbp],
+      isFromL1_ ? feature[kDRL1SeedP]   : feature[kDRL2SeedP],
+      isFromL1_ ? feature[kDPhiL1SeedP] : feature[kDPhiL2SeedP]
+    };
+    for(Int_t iv=nVar_-2; iv<nVar_; iv++)
+      if( var[iv] == seedNtupleDefault ) var[iv] = seedMvaNoMuon;
+    for(Int_t iv=0; iv<nVar_; iv++)
+      var[iv] = (var[iv] - mean[iv]) / scaleStd[iv];
+
+    Double_t mva = isBarrel ? forestBarrel_.GetResponse(var) : forestEndcap_.GetResponse(var);
+    return mva + 0.5;
+  }
+
+private:
+  static const Int_t nVar_ = 8;
+
+  SeedGBRForest forestBarrel_;
+  SeedGBRForest forestEndcap_;
+  vector<Double_t> scaleMeanBarrel_;
+  vector<Double_t> scaleStdBarrel_;
+  vector<Double_t> scaleMeanEndcap_;
+  vector<Double_t> scaleStdEndcap_;
+  Bool_t isFromL1_;
+};
+
+// -- evaluates one or more SeedMvaModel over an existing seed tree (e.g. seedNtupler/NThltIter2) and writes the scores
+// -- as a friend tree with one "mva_<label>" branch per model, entry by entry aligned with the input chain:
+// --   chain->AddFriend("NThltIter2_mva", "seedMva.root");
+// -- columnar seed ntuples (Set_Columnar(kTRUE), tree name e.g. seedNtupler/NThltIter2): the hltIter2_* vector branches of
+// -- seedNtupler/NTEvent are read and the friend tree has one entry per event with vector<float> branches:
+// --   chain = new TChain("seedNtupler/NTEvent"); chain->AddFriend("NThltIter2_mva", "seedMva.root");
+// -- entries are read in batches, each batch is scored in parallel over nThread workers
+// -- closure check (Set_ClosureModel): the model trained as the one of the ntupler config is compared to the stored "mva" branch
+class SeedMvaReevaluator
+{
+public:
+  SeedMvaReevaluator() {}
+
+  void AddNtuplePath(TString ntuplePath)
+  {
+    vec_ntuplePath_.push_back( ntuplePath );
+  }
+
+  void AddModel(SeedMvaModel* model)
+  {
+    vec_model_.push_back( model );
+  }
+
+  void Set_TreeName(TString treeName) { treeName_ = treeName; }
+  void Set_FriendTreeName(TString friendTreeName) { friendTreeName_ = friendTreeName; }
+  void Set_OutputFileName(TString outputFileName) { outputFileName_ = outputFileName; }
+  void Set_nThread(Int_t nThread) { nThread_ = nThread; }
+  void Set_Columnar(Bool_t columnar) { columnar_ = columnar; }
+  void Set_BatchSize(Long64_t batchSize) { batchSize_ = batchSize; }
+  void Set_ClosureModel(TString label, Double_t tolerance = 1e-4) { closureLabel_ = label; closureTolerance_ = tolerance; }
+
+  void Produce()
+  {
+    StartTimer();
+
+    // -- columnar: seedNtupler/NThltIter2 -> hltIter2_* branches of seedNtupler/NTEvent
+    TString iterName = treeName_(treeName_.Last('/')+1, treeName_.Length());
+    TString prefix = columnar_ ? TString(iterName(2, iterName.Length())) + "_" : TString("");
+    TString chainName = columnar_ ? TString(treeName_(0, treeName_.Last('/')+1)) + "NTEvent" : treeName_;
+
+    TChain* chain = new TChain(chainName);
+    for(const auto& ntuplePath : vec_ntuplePath_ )
+      chain->Add( ntuplePath );
+
+    Float_t input[kNSeedMvaFeature];
+    vector<Float_t>* inputColumn[kNSeedMvaFeature] = {nullptr};
+    chain->SetBranchStatus("*", 0);
+    for(Int_t i_feat=0; i_feat<kNSeedMvaFeature; i_feat++)
+    {
+      TString branchName = prefix + seedMvaFeatureBranch[i_feat];
+      chain->SetBranchStatus(branchName, 1);
+      if( columnar_ ) chain->SetBranchAddress(branchName, &inputColumn[i_feat]);
+      else            chain->SetBranchAddress(branchName, &input[i_feat]);
+    }
+
+    // -- closure: the model with closureLabel_ against the "mva" branch, seeds without a stored score (default) are skipped
+    Int_t i_closure = -1;
+    for(Int_t i_model=0; i_model<(Int_t)vec_model_.size(); i_model++)
+      if( closureLabel_ != "" && vec_model_[i_model]->label_ == closureLabel_ ) i_closure = i_model;
+    if( closureLabel_ != "" && i_closure < 0 )
+      throw std::invalid_argument( ("[SeedMvaReevaluator] closure model " + closureLabel_ + " is not added").Data() );
+
+    Float_t storedMva = seedNtupleDefault;
+    vector<Float_t>* storedMvaColumn = nullptr;
+    if( i_closure >= 0 )
+    {
+      chain->SetBranchStatus(prefix+"mva", 1);
+      if( columnar_ ) chain->SetBranchAddress(prefix+"mva", &storedMvaColumn);
+      else            chain->SetBranchAddress(prefix+"mva", &storedMva);
+    }
+    vector<Float_t> vec_storedMva;
+    Long64_t nClosure = 0, nClosureFail = 0;
+    Double_t maxClosureDiff = 0.;
+
+    TString friendTreeName = friendTreeName_;
+    if( friendTreeName == "" )
+      friendTreeName = iterName + "_mva";
+
+    TFile *f_output = TFile::Open(outputFileName_, "RECREATE");
+    TTree *friendTree = new TTree(friendTreeName, friendTreeName);
+
+    // -- one score per entry, or (columnar) one vector of scores per event
+    const Int_t nModel = (Int_t)vec_model_.size();
+    vector<Float_t> vec_mva(nModel);
+    vector< vector<Float_t> > vec_mvaColumn(nModel);
+    for(Int_t i_model=0; i_model<nModel; i_model++)
+    {
+      TString branchName = "mva_" + vec_model_[i_model]->label_;
+      if( columnar_ ) friendTree->Branch(branchName, &vec_mvaColumn[i_model]);
+      else            friendTree->Branch(branchName, &vec_mva[i_model], branchName+"/F");
+    }
+
+    ROOT::TThreadExecutor pool(nThread_);
+
+    vector<Float_t> vec_feature;
+    vector<Float_t> vec_score;
+    vector<Int_t> vec_nSeed; // -- seeds per input entry of the batch (1 without columnar)
+
+    Long64_t nEntry = chain->GetEntries();
+    printf("[SeedMvaReevaluator] %s: %lld %s, %d models, %d threads\n", treeName_.Data(), nEntry, columnar_ ? "events" : "seeds", nModel, nThread_);
+
+    for(Long64_t entry=0; entry<nEntry; )
+    {
+      // -- I/O is serial: copy the features of the batch into one contiguous array (columnar: whole events, up to ~batchSize seeds)
+      vec_feature.clear();
+      vec_storedMva.clear();
+      vec_nSeed.clear();
+      Long64_t nBatch = 0;
+      while( entry < nEntry && nBatch < batchSize_ )
+      {
+        chain->GetEntry(entry++);
+        Int_t nSeed = columnar_ ? (Int_t)inputColumn[0]->size() : 1;
+        for(Int_t i_seed=0; i_seed<nSeed; i_seed++)
+        {
+          for(Int_t i_feat=0; i_feat<kNSeedMvaFeature; i_feat++)
+            vec_feature.push_back( columnar_ ? inputColumn[i_feat]->at(i_seed) : input[i_feat] );
+          if( i_closure >= 0 ) vec_storedMva.push_back( columnar_ ? storedMvaColumn->at(i_seed) : storedMva );
+        }
+        vec_nSeed.push_back( nSeed );
+        nBatch += nSeed;
+      }
+
+      // -- scoring: independent chunks of the batch on the thread pool
+      vec_score.resize( nBatch * nModel );
+      const Long64_t chunkSize = 1024;
+      const Int_t nChunk = (Int_t)((nBatch + chunkSize - 1) / chunkSize);
+      pool.Foreach( [&](Int_t i_chunk)
+      {
+        const Long64_t begin = i_chunk * chunkSize;
+        const Long64_t end = std::min(begin + chunkSize, nBatch);
+        for(Long64_t i=begin; i<end; i++)
+        {
+          const Float_t* feature = &vec_feature[i*kNSeedMvaFeature];
+          for(Int_t i_model=0; i_model<nModel; i_model++)
+            vec_score[i*nModel + i_model] = vec_model_[i_model]->Evaluate(feature);
+        }
+      }, ROOT::TSeqI(nChunk) );
+
+      // -- one friend entry per input entry
+      Long64_t i = 0;
+      for(const auto& nSeed : vec_nSeed )
+      {
+        for(auto& mvaColumn : vec_mvaColumn ) mvaColumn.clear();
+        for(Int_t i_seed=0; i_seed<nSeed; i_seed++, i++)
+        {
+          for(Int_t i_model=0; i_model<nModel; i_model++)
+          {
+            vec_mva[i_model] = vec_score[i*nModel + i_model];
+            if( columnar_ ) vec_mvaColumn[i_model].push_back( vec_mva[i_model] );
+          }
+
+          if( i_closure >= 0 && vec_storedMva[i] != seedNtupleDefault )
+          {
+            Double_t diff = fabs( vec_mva[i_closure] - vec_storedMva[i] );
+            nClosure++;
+            if( diff > closureTolerance_ ) nClosureFail++;
+            maxClosureDiff = std::max(maxClosureDiff, diff);
+          }
+        }
+        friendTree->Fill();
+      }
+
+      printf("  [%lld / %lld] entries done\n", entry, nEntry);
+    }
+
+    f_output->cd();
+    friendTree->Write();
+    f_output->Close();
+
+    delete chain;
+
+    if( i_closure >= 0 )
+      printf("[SeedMvaReevaluator] closure of %s vs mva: %lld / %lld seeds differ by more than %g (max. difference %g)\n",
+        closureLabel_.Data(), nClosureFail, nClosure, closureTolerance_, maxClosureDiff);
+
+    PrintRunTime();
+  }
+
+private:
+  TStopwatch timer_;
+
+  vector<TString> vec_ntuplePath_;
+  vector<SeedMvaModel*> vec_model_;
+  TString treeName_ = "seedNtupler/NThltIter2";
+  TString friendTreeName_ = "";
+  TString outputFileName_ = "seedMva.root";
+  Int_t nThread_ = 4;
+  Long64_t batchSize_ = 1000000;
+  Bool_t columnar_ = kFALSE;
+  TString closureLabel_ = "";
+  Double_t closureTolerance_ = 1e-4;
+
+  void StartTimer()
+  {
+    timer_.Start();
+  }
+
+  void PrintRunTime()
+  {
+    Double_t cpuTime = timer_.CpuTime();
+    Double_t realTime = timer_.RealTime();
+
+    cout << "************************************************" << endl;
+    cout << "Total real time: " << realTime << " (seconds)" << endl;
+    cout << "Total CPU time:  " << cpuTime << " (seconds)" << endl;
+    cout << "  CPU time / real time = " << cpuTime / realTime << endl;
+    cout << "************************************************" << endl;
+  }
+};
+
+} // -- namespace MuonHLT